@@ -0,0 +1,202 @@
+/*
+	Philip Romano
+	10/16/2026
+	compiledgesturegraph.h
+*/
+
+#ifndef COMPILEDGESTUREGRAPH_H
+#define COMPILEDGESTUREGRAPH_H
+
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "handframe.h"
+#include "gesturenode.h"
+#include "gesturestategraph.h"
+#include "gesturetrace.h"
+#include "gestureprofile.h"
+#include "gesturelatency.h"
+#include "gesturememo.h"
+
+/**
+	An immutable, validated snapshot of a GestureStateGraph, produced by
+	GestureStateGraph::compile().
+
+	Node types are resolved to direct GestureNode pointers and each node's
+	slots are flattened into one contiguous table, so that advancing the
+	graph by one frame is a sequence of indexed loads. Node handles are the
+	same as those of the GestureStateGraph that was compiled.
+
+	A CompiledGestureGraph is never modified after it is built. Editing the
+	source graph does not affect a snapshot that has already been compiled.
+*/
+class CompiledGestureGraph {
+	public:
+		typedef GestureStateGraph::NodeHandle NodeHandle;
+		typedef GestureStateGraph::Action Action;
+
+		/**
+		  Feeds the provided frame data to the node current and advances
+		  until a node advances to itself, calling the onLeave()/onEnter()
+		  callbacks and bound actions of every node that is traversed.
+		  Returns the node that the traversal stopped at. See
+		  GestureStateGraph::update().
+
+		  states is the state arena of the walk being advanced: a buffer of
+		  getStateSize() bytes, initialized from getInitialState(). It may be
+		  null if getStateSize() is 0.
+
+		  The traversal is bounded by getMaxSteps(). If a traversal has not
+		  settled after that many evaluations, it stops at the node it has
+		  reached, and continues from there with the next frame.
+
+		  If memo is not null, each pure node type is evaluated at most once
+		  per frame, and its result reused for the other nodes of the type
+		  (see GestureNode::isPure()). memo must have been sized with
+		  getMemoSize().
+
+		  If trace is not null, every transition taken is recorded in it,
+		  tagged with session. If profile is not null, every evaluation is
+		  timed and counted in it. If latency is not null, every node with
+		  an enter action that is entered opens an event in it, once the
+		  action has run.
+
+		  advance() works on raw pointers and indices only: it does not
+		  allocate or touch reference counts. A profile may allocate the
+		  first time it sees a node or slot. Nor does it check the frame:
+		  if readsFeatures(), frame must be a FeatureFrame.
+		*/
+		NodeHandle advance(const HandFrame& frame, NodeHandle current,
+				char *states, GestureMemo *memo = NULL,
+				GestureTrace *trace = NULL, GestureProfile *profile = NULL,
+				int session = 0, GestureLatency *latency = NULL) const;
+
+		NodeHandle getStart() const;
+
+		int getNodeCount() const;
+
+		const std::string& getNodeId(NodeHandle node) const;
+
+		/**
+		  Returns the GestureNode of the given node, or null if the node
+		  does not exist or its type was removed.
+		*/
+		GestureNode* getNodeType(NodeHandle node) const;
+
+		/**
+		  Returns true if the node has at least one slot connected to
+		  itself, and therefore can be a resting state of the graph.
+		*/
+		bool isStateNode(NodeHandle node) const;
+
+		/**
+		  Returns the number of nodes in the longest path that consists
+		  only of decision nodes.
+		*/
+		int getMaxDecisionChain() const;
+
+		/**
+		  Returns the size in bytes of the state arena that one walk through
+		  the graph needs.
+		*/
+		int getStateSize() const;
+
+		/**
+		  Returns the freshly initialized state of every node, to be copied
+		  into the state arena of a new walk. Null if getStateSize() is 0.
+		*/
+		const char* getInitialState() const;
+
+		/**
+		  Round a state arena offset up so that a state block placed there
+		  is suitably aligned for any plain data type.
+		*/
+		static int alignState(int offset);
+
+		/**
+		  Returns the maximum number of node evaluations that advance()
+		  performs for a single frame.
+		*/
+		int getMaxSteps() const;
+
+		/**
+		  Returns the number of pure node types in the graph, which is the
+		  size a GestureMemo needs to be for advance().
+		*/
+		int getMemoSize() const;
+
+		/**
+		  Returns true if any node's type reads the features of a
+		  FeatureFrame (see GestureNode::readsFeatures()), so that the graph
+		  must only be advanced with FeatureFrames.
+		*/
+		bool readsFeatures() const;
+
+	private:
+		friend class GestureStateGraph;
+
+		// GestureNode for each node, or null if the node's type was removed
+		std::vector<GestureNode*> mNodeTypes;
+
+		// Slots of node n are mSlotTargets[mSlotOffsets[n]] up to (not
+		// including) mSlotTargets[mSlotOffsets[n + 1]]
+		std::vector<int> mSlotOffsets;
+		std::vector<NodeHandle> mSlotTargets;
+
+		std::vector<std::string> mNodeIds;
+		std::vector<bool> mStateNodes;
+
+		// Memo index of each node's type if the type is pure, or -1
+		std::vector<int> mMemoIndex;
+		int mMemoSize;
+
+		// Offset of each node's state block in a state arena, or -1
+		std::vector<int> mStateOffsets;
+		std::vector<char> mInitialState;
+
+		// Actions bound to each node (see GestureStateGraph::setEnterAction())
+		std::vector<Action> mEnterActions;
+		std::vector<Action> mLeaveActions;
+
+		// Keeps the GestureNode objects alive for the snapshot's lifetime
+		std::vector< boost::shared_ptr<GestureNode> > mTypes;
+
+		// Whether any node's type reads FeatureFrames
+		bool mReadsFeatures;
+
+		NodeHandle mStart;
+		int mMaxDecisionChain;
+		int mMaxSteps;
+
+		/**
+		  Only GestureStateGraph::compile() builds compiled graphs.
+		*/
+		CompiledGestureGraph();
+
+		/**
+		  Called once the node tables are filled in. Classifies nodes as
+		  state or decision nodes, rejects cycles made only of decision
+		  nodes, and computes the traversal bound.
+
+		  Throws GestureStateException if the graph contains a decision-only
+		  cycle.
+		*/
+		void validate();
+
+		NodeHandle getSlot(NodeHandle node, int slot) const;
+
+		void* getState(char *states, NodeHandle node) const;
+
+		/**
+		  Replace from with to as the current node: calls the onLeave()
+		  callbacks of from, then the onEnter() callbacks of to, and opens a
+		  latency event if to has an enter action and latency is not null.
+		*/
+		void transition(const HandFrame& frame, NodeHandle from,
+				NodeHandle to, char *states, GestureLatency *latency,
+				int session) const;
+};
+
+#endif
@@ -0,0 +1,20 @@
+/*
+	Philip Romano
+	10/16/2026
+	csv.h
+*/
+
+#ifndef CSV_H
+#define CSV_H
+
+#include <ostream>
+#include <string>
+
+/**
+  Write value to out as a quoted CSV field: in double quotes, with any
+  double quote in it doubled. Node IDs and type names are arbitrary
+  strings, so the reports' CSV writers quote them all this way.
+*/
+void writeCsvString(std::ostream& out, const std::string& value);
+
+#endif
@@ -18,7 +18,7 @@ class DecisionNode {
 		virtual ~DecisionNode() = 0;
 
 		/**
-		  Processes the provided Leap Motion frame data and returns an integer
+		  Processes the provided hand frame data and returns an integer
 		  that corresponds to the branch index that should be followed after
 		  this node.
 
@@ -28,9 +28,9 @@ class DecisionNode {
 		  This implementation calls decide() and returns 1 if it returns
 		  true or 0 if it returns false.
 		*/
-		virtual int evaluate(const Leap::Frame &frame);
+		virtual int evaluate(const HandFrame &frame);
 
-		virtual bool decide(const Leap::Frame &frame) = 0;
+		virtual bool decide(const HandFrame &frame) = 0;
 };
 
 #endif
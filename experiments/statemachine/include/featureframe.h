@@ -0,0 +1,161 @@
+/*
+	Philip Romano
+	10/16/2026
+	featureframe.h
+*/
+
+#ifndef FEATUREFRAME_H
+#define FEATUREFRAME_H
+
+#include <stdint.h>
+
+#include "handframe.h"
+#include "handmotion.h"
+#include "velocityfilter.h"
+
+/**
+	A HandFrame with the features derived from it: the main hand (see
+	HandMotion) and whichever of its smoothed velocity, speeds, palm and
+	estimated position the graph's nodes declared they read. Features are
+	computed once per frame by a FeatureExtractor, before the graph sees
+	the frame, so nodes read them as plain fields (see FeatureNode)
+	instead of recomputing them or reaching back into the application for
+	them.
+
+	A FeatureFrame is passed to the graph, and so to every node and action,
+	as the HandFrame it extends: it travels with the frame through sessions,
+	memos and traces. Being plain data, copying one is a memcpy.
+*/
+struct FeatureFrame : public HandFrame {
+	enum Feature {
+		// Smoothed velocity of the main hand, in millimeters per second
+		VELOCITY = 1 << 0,
+
+		// Magnitude of the smoothed velocity
+		SPEED    = 1 << 1,
+
+		// Magnitude of the smoothed velocity in the x-y plane
+		XY_SPEED = 1 << 2,
+
+		// Position and normal of the main hand's palm
+		PALM     = 1 << 3,
+
+		// Palm position of the main hand at the frame's timestamp, as the
+		// velocity filter estimates it (see VelocityFilter::getPosition())
+		POSITION = 1 << 4,
+
+		ALL      = VELOCITY | SPEED | XY_SPEED | PALM | POSITION
+	};
+
+	// Features that were extracted (Feature flags); the fields of any
+	// others are left as they were
+	uint32_t features;
+
+	// Whether the frame has a main hand, its ID and number of fingers.
+	// Always extracted. Features of the hand are zero when there is none.
+	bool hasHand;
+	int32_t handId;
+	int32_t fingerCount;
+
+	Vector3 velocity;
+	float speed;
+	float xySpeed;
+
+	Vector3 palmPosition;
+	Vector3 palmNormal;
+
+	Vector3 position;
+
+	bool has(Feature feature) const {
+		return (features & feature) != 0;
+	}
+
+	/**
+	  Make this an invalid frame with no hands and no features.
+	*/
+	void clear() {
+		HandFrame::clear();
+		features = 0;
+		hasHand = false;
+		handId = -1;
+		fingerCount = 0;
+	}
+};
+
+/**
+	The pipeline stage that turns each HandFrame into a FeatureFrame for
+	the graph: follows the main hand, smooths its velocity, and writes the
+	declared features, once per frame. Features nobody declared are not
+	computed.
+
+	The smoothing is fed every frame whatever is declared, so that the
+	velocity is continuous when a feature that reads it is declared later.
+
+	Nothing is allocated.
+
+	  extractor.require(node->getFeatures());
+	  ...
+	  extractor.extract(frame, features);
+	  graph.update(features);
+*/
+class FeatureExtractor {
+	public:
+		/**
+		  smoothing : number of frames to average the velocity over
+		  minFingers : fewest fingers a hand needs to be the main hand
+		*/
+		FeatureExtractor(int smoothing = 3, int minFingers = 0);
+
+		/**
+		  Declare features (Feature flags, or'ed) as read from now on. They
+		  are added to those declared before.
+		*/
+		void require(uint32_t features);
+
+		/**
+		  Returns the features declared so far.
+		*/
+		uint32_t getRequired() const;
+
+		/**
+		  Smooth the velocity with filter from now on, and reset (see
+		  HandMotion::setFilter()).
+		*/
+		void setFilter(const VelocityFilter& filter);
+
+		/**
+		  Follow the main hand into frame, and write frame, with the
+		  declared features, into features.
+		*/
+		void extract(const HandFrame& frame, FeatureFrame& features);
+
+		/**
+		  As extract(), with the raw velocity of the frame's first hand
+		  already computed (see HandMotion::update()).
+		*/
+		void extract(const HandFrame& frame, const Vector3& rawVelocity,
+				FeatureFrame& features);
+
+		/**
+		  Forget the main hand and restart the smoothing.
+		*/
+		void reset();
+
+		const HandMotion& getMotion() const;
+
+		/**
+		  Write the features of hand, whose smoothed velocity and estimated
+		  position are velocity and position, into features: only those in
+		  required, and those of no hand if hand is null. The frame that
+		  features holds is left as it is.
+		*/
+		static void writeFeatures(const HandData *hand,
+				const Vector3& velocity, const Vector3& position,
+				uint32_t required, FeatureFrame& features);
+
+	private:
+		HandMotion mMotion;
+		uint32_t mRequired;
+};
+
+#endif
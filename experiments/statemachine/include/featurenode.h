@@ -0,0 +1,134 @@
+/*
+	Philip Romano
+	10/16/2026
+	featurenode.h
+*/
+
+#ifndef FEATURENODE_H
+#define FEATURENODE_H
+
+#include <string>
+#include <stdint.h>
+
+#include "gesturenode.h"
+#include "featureframe.h"
+#include "handframe.h"
+
+/**
+	Base for GestureNode types that read the features of a FeatureFrame.
+	Each type declares the features it reads when it is constructed (see
+	getFeatures()), for the owner to pass on to its FeatureExtractor, and
+	overrides the overloads that take a FeatureFrame.
+
+	The HandFrame the graph passes on is taken to be a FeatureFrame, so a
+	graph with nodes of these types must only be fed FeatureFrames: it
+	takes them through its FeatureFrame overloads, and throws
+	GestureStateException if it is fed a plain HandFrame instead (see
+	readsFeatures()).
+*/
+class FeatureNode : public GestureNode {
+	public:
+		/**
+		  features : the features evaluate() reads (FeatureFrame::Feature
+		             flags, or'ed)
+		*/
+		FeatureNode(uint32_t features) {
+			mFeatures = features;
+		}
+
+		/**
+		  Returns the features this type reads.
+		*/
+		uint32_t getFeatures() const {
+			return mFeatures;
+		}
+
+		virtual bool readsFeatures() {
+			return true;
+		}
+
+		virtual int evaluate(const FeatureFrame& frame,
+				const std::string& nodeid) = 0;
+
+		virtual void onEnter(const FeatureFrame& frame,
+				const std::string& nodeid)
+			{ }
+
+		virtual void onLeave(const FeatureFrame& frame,
+				const std::string& nodeid)
+			{ }
+
+		virtual int evaluate(const HandFrame& frame,
+				const std::string& nodeid, void *state) {
+			return evaluate(static_cast<const FeatureFrame&>(frame), nodeid);
+		}
+
+		virtual void onEnter(const HandFrame& frame,
+				const std::string& nodeid, void *state) {
+			onEnter(static_cast<const FeatureFrame&>(frame), nodeid);
+		}
+
+		virtual void onLeave(const HandFrame& frame,
+				const std::string& nodeid, void *state) {
+			onLeave(static_cast<const FeatureFrame&>(frame), nodeid);
+		}
+
+	private:
+		uint32_t mFeatures;
+};
+
+/**
+	FeatureNode for types whose nodes each hold a State struct (see
+	StatefulGestureNode).
+*/
+template <class State>
+class StatefulFeatureNode : public StatefulGestureNode<State> {
+	public:
+		/**
+		  features : the features evaluate() reads (FeatureFrame::Feature
+		             flags, or'ed)
+		*/
+		StatefulFeatureNode(uint32_t features) {
+			mFeatures = features;
+		}
+
+		uint32_t getFeatures() const {
+			return mFeatures;
+		}
+
+		virtual bool readsFeatures() {
+			return true;
+		}
+
+		virtual int evaluate(const FeatureFrame& frame,
+				const std::string& nodeid, State& state) = 0;
+
+		virtual void onEnter(const FeatureFrame& frame,
+				const std::string& nodeid, State& state)
+			{ }
+
+		virtual void onLeave(const FeatureFrame& frame,
+				const std::string& nodeid, State& state)
+			{ }
+
+		virtual int evaluate(const HandFrame& frame,
+				const std::string& nodeid, State& state) {
+			return evaluate(static_cast<const FeatureFrame&>(frame), nodeid,
+					state);
+		}
+
+		virtual void onEnter(const HandFrame& frame,
+				const std::string& nodeid, State& state) {
+			onEnter(static_cast<const FeatureFrame&>(frame), nodeid, state);
+		}
+
+		virtual void onLeave(const HandFrame& frame,
+				const std::string& nodeid, State& state) {
+			onLeave(static_cast<const FeatureFrame&>(frame), nodeid, state);
+		}
+
+	private:
+		uint32_t mFeatures;
+};
+
+#endif
@@ -0,0 +1,175 @@
+/*
+	Philip Romano
+	10/16/2026
+	frameingest.h
+*/
+
+#ifndef FRAMEINGEST_H
+#define FRAMEINGEST_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <stdint.h>
+
+#include "handframe.h"
+
+/**
+	Counts kept by a FrameIngest. Every frame pushed is eventually
+	delivered, coalesced into a delivered frame, dropped, or still pending:
+
+	  received == delivered + coalesced + dropped + pending
+*/
+struct IngestStats {
+	// Frames pushed by the source
+	uint64_t received;
+
+	// Frames handed to the consumer by pop()
+	uint64_t delivered;
+
+	// Frames averaged into a frame delivered after them (COALESCE)
+	uint64_t coalesced;
+
+	// Frames thrown away unseen: overwritten while the buffer was full, or
+	// passed over for a newer one (LATEST)
+	uint64_t dropped;
+
+	// Most frames ever waiting at once
+	int maxPending;
+
+	// Longest time a delivered frame waited between push() and pop(), in
+	// nanoseconds
+	int64_t maxDelay;
+};
+
+/**
+	Stands between a frame source (a tracker callback, or a thread reading
+	a frame ring) and the thread that runs the graph, so that a graph that
+	falls behind costs frames rather than ever-growing latency. The source
+	pushes each frame as it arrives and never waits; the graph thread pops
+	frames when it is ready for them.
+
+	At most capacity frames are kept. When the buffer is full, a new frame
+	pushes out the oldest, which is counted as dropped. What pop() hands
+	over depends on the policy:
+
+	  QUEUE     Every frame, in order: nothing is lost unless the graph is
+	            more than capacity frames behind.
+	  LATEST    Only the newest frame; any older ones are dropped. Lowest
+	            latency, but a graph that counts frames sees fewer of them.
+	  COALESCE  One frame standing in for everything pending: the newest
+	            frame, with each hand's and finger's velocities averaged
+	            (matched by ID) over the pending frames it appears in. The
+	            older frames are counted as coalesced.
+
+	push() and pop() each hold a lock for a frame copy (pop() under
+	COALESCE, for one pass over the pending frames); nothing is allocated
+	after construction. One thread may push while another pops.
+
+	  // Source thread
+	  ingest.push(frame);
+
+	  // Graph thread
+	  while (ingest.wait())
+	      while (ingest.pop(frame))
+	          graph.update(frame);
+*/
+class FrameIngest {
+	public:
+		enum Policy {
+			QUEUE,
+			LATEST,
+			COALESCE
+		};
+
+		FrameIngest(Policy policy = QUEUE, int capacity = 16);
+
+		/**
+		  Add a frame from the source. Never blocks; if the buffer is full,
+		  the oldest pending frame is dropped to make room. Frames pushed
+		  after close() are ignored.
+		*/
+		void push(const HandFrame& frame);
+
+		/**
+		  Write the next frame for the graph into frame, according to the
+		  policy.
+
+		  Returns true if a frame was written; false if none is pending
+		*/
+		bool pop(HandFrame& frame);
+
+		/**
+		  Block until a frame is pending, close() is called, or timeoutMs
+		  milliseconds pass (forever if timeoutMs is negative).
+
+		  Returns true if a frame is pending; false otherwise
+		*/
+		bool wait(int timeoutMs = -1);
+
+		/**
+		  Mark the source finished and wake the graph thread. Frames already
+		  pending can still be popped.
+		*/
+		void close();
+
+		bool isClosed() const;
+
+		/**
+		  Returns the number of frames pushed and not yet popped.
+		*/
+		int getPending() const;
+
+		IngestStats getStats() const;
+
+		Policy getPolicy() const;
+
+		int getCapacity() const;
+
+		/**
+		  Returns the lower-case name of policy ("queue", "latest" or
+		  "coalesce").
+		*/
+		static const char* getPolicyName(Policy policy);
+
+		/**
+		  Set policy from its name, as given by getPolicyName().
+
+		  Returns true if name is a policy; false otherwise
+		*/
+		static bool parsePolicy(const std::string& name, Policy& policy);
+
+	private:
+		Policy mPolicy;
+
+		// Ring of pending frames: mCount of them, the oldest at mHead, each
+		// with the time it was pushed
+		std::vector<HandFrame> mFrames;
+		std::vector<int64_t> mPushed;
+		int mHead;
+		int mCount;
+		bool mClosed;
+
+		IngestStats mStats;
+
+		mutable std::mutex mMutex;
+		std::condition_variable mReady;
+
+		/**
+		  Returns the index in mFrames of pending frame i (0 is the oldest).
+		*/
+		int getSlot(int i) const;
+
+		/**
+		  Write into frame the newest pending frame with velocities averaged
+		  over all the pending frames.
+		*/
+		void coalesce(HandFrame& frame) const;
+
+		// Not copyable
+		FrameIngest(const FrameIngest&);
+		FrameIngest& operator=(const FrameIngest&);
+};
+
+#endif
@@ -0,0 +1,237 @@
+/*
+	Philip Romano
+	10/16/2026
+	framelog.h
+*/
+
+#ifndef FRAMELOG_H
+#define FRAMELOG_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <cstdio>
+#include <stdint.h>
+
+#include "handframe.h"
+
+/**
+	Frame logs are binary recordings of hand tracking input: a
+	FrameLogHeader followed by raw HandFrames, back to back. Every record
+	has the same size (the header's stride), so frame i is found by
+	arithmetic alone, and a log can be memory-mapped and read in place (see
+	FrameLogReader).
+
+	The log is written in the byte order of the machine that recorded it.
+	A log whose version, header size or stride does not match this build's
+	is rejected rather than misread.
+*/
+struct FrameLogHeader {
+	static const uint32_t VERSION = 1;
+
+	// "HANDLOG" followed by a zero byte
+	char magic[8];
+	uint32_t version;
+
+	// Size of this header in bytes; frames start at this offset
+	uint32_t headerSize;
+
+	// Size of each frame record in bytes (sizeof(HandFrame))
+	uint32_t stride;
+	uint32_t reserved;
+
+	// Padding, so that frames start suitably aligned
+	char padding[40];
+
+	/**
+	  Fill in a header for a log written by this build.
+	*/
+	void initialize();
+
+	/**
+	  Returns true if this is the header of a log this build can read.
+	*/
+	bool isCompatible() const;
+};
+
+/**
+	Appends HandFrames to a frame log without blocking the caller.
+
+	Frames are appended into a preallocated ring of frames, and a background
+	thread writes them to the file. Appending never allocates, locks or
+	performs I/O, so it is safe from a tracking callback running at 100+ Hz.
+	If the writer thread falls so far behind that the ring is full, new
+	frames are dropped and counted (see getDropped()) rather than stalling
+	the caller.
+
+	If the file cannot be written (the disk is full, say), the writer
+	stops writing, and the frames appended from then on are lost and
+	counted (see getLost()); the caller goes on appending as before. The
+	log then ends with the last frame written whole.
+
+	Only one thread may append at a time.
+*/
+class FrameLogWriter {
+	public:
+		/**
+		  Create a writer whose ring holds the given number of frames.
+		  capacity is rounded up to a power of two.
+		*/
+		FrameLogWriter(int capacity = 4096);
+
+		/**
+		  Closes the log, if it is open.
+		*/
+		~FrameLogWriter();
+
+		/**
+		  Create (or truncate) the file and start the writer thread.
+
+		  Returns true if the file was opened; false otherwise (it could not
+		  be created, or a log is already open)
+		*/
+		bool open(const std::string& filename);
+
+		/**
+		  Write every frame appended so far, stop the writer thread and
+		  close the file.
+
+		  Returns true if every frame appended was written; false if some
+		  were lost to a write error
+		*/
+		bool close();
+
+		bool isOpen() const;
+
+		/**
+		  Reserve the next frame in the ring, to be filled in place and then
+		  published with commitAppend(). Returns null if the log is not
+		  open, or if the ring is full (the frame is then counted as
+		  dropped).
+		*/
+		HandFrame* beginAppend();
+
+		/**
+		  Publish the frame returned by the last beginAppend().
+		*/
+		void commitAppend();
+
+		/**
+		  Copy frame into the log. Returns false if it was dropped.
+		*/
+		bool append(const HandFrame& frame);
+
+		/**
+		  Returns the number of frames written to the file so far.
+		*/
+		uint64_t getWritten() const;
+
+		/**
+		  Returns the number of frames appended that could not be written,
+		  because the file could not be written to.
+		*/
+		uint64_t getLost() const;
+
+		/**
+		  Returns the number of frames dropped because the ring was full.
+		*/
+		uint64_t getDropped() const;
+
+	private:
+		std::vector<HandFrame> mRing;
+		uint64_t mMask;
+
+		// Frames appended and frames taken off the ring; the frames in
+		// between are waiting in the ring. Those taken off were written,
+		// or lost once a write failed.
+		std::atomic<uint64_t> mHead;
+		std::atomic<uint64_t> mTail;
+		std::atomic<uint64_t> mWritten;
+		std::atomic<uint64_t> mLost;
+		std::atomic<uint64_t> mDropped;
+		std::atomic<bool> mFailed;
+
+		std::FILE *mFile;
+		std::thread mThread;
+		std::atomic<bool> mRunning;
+
+		/**
+		  Body of the writer thread.
+		*/
+		void run();
+
+		/**
+		  Write every frame waiting in the ring, or, once a write failed,
+		  count them as lost. Returns the number of frames taken off the
+		  ring.
+		*/
+		uint64_t drain();
+
+		// Not copyable
+		FrameLogWriter(const FrameLogWriter&);
+		FrameLogWriter& operator=(const FrameLogWriter&);
+};
+
+/**
+	Reads a frame log by memory-mapping it. Frames are returned as
+	references straight into the mapping; nothing is copied or allocated
+	per frame, and the operating system pages the file in as it is read.
+
+	The whole file is mapped at once, so logs larger than a few hundred
+	megabytes need a 64-bit build.
+*/
+class FrameLogReader {
+	public:
+		typedef const HandFrame* const_iterator;
+
+		FrameLogReader();
+
+		/**
+		  Unmaps the log, if it is open.
+		*/
+		~FrameLogReader();
+
+		/**
+		  Map the given log file. A trailing partial frame (from a recording
+		  that was cut short) is ignored.
+
+		  Returns true if the file was mapped; false otherwise (it could not
+		  be opened, or is not a compatible frame log)
+		*/
+		bool open(const std::string& filename);
+
+		void close();
+
+		bool isOpen() const;
+
+		/**
+		  Returns the number of complete frames in the log.
+		*/
+		int64_t size() const;
+
+		/**
+		  Returns frame i, 0 <= i < size().
+		*/
+		const HandFrame& operator[](int64_t i) const;
+
+		const_iterator begin() const;
+		const_iterator end() const;
+
+	private:
+		const char *mData;
+		int64_t mLength;
+		const HandFrame *mFrames;
+		int64_t mSize;
+
+#ifdef _WIN32
+		void *mFileHandle;
+		void *mMappingHandle;
+#endif
+
+		// Not copyable
+		FrameLogReader(const FrameLogReader&);
+		FrameLogReader& operator=(const FrameLogReader&);
+};
+
+#endif
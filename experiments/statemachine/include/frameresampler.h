@@ -0,0 +1,103 @@
+/*
+	Philip Romano
+	10/16/2026
+	frameresampler.h
+*/
+
+#ifndef FRAMERESAMPLER_H
+#define FRAMERESAMPLER_H
+
+#include <stdint.h>
+
+#include "handframe.h"
+
+/**
+	Turns frames that arrive at whatever rate the tracker manages into
+	frames on a fixed time grid, so that anything counted in frames (such
+	as HandMotion's smoothing, or a node that waits a number of frames)
+	lasts the same time at 60 Hz as at 200 Hz, and a graph costs the same
+	per second of input whatever the device does.
+
+	Each grid frame is interpolated between the two input frames either
+	side of it. The hands are those of the nearer input frame; a hand
+	(matched by ID) or finger that is in both frames has its positions and
+	velocities interpolated linearly, and is otherwise copied as is. Grid
+	frames are only produced up to the newest input frame, never beyond, so
+	resampling adds at most one input frame of latency.
+
+	Output frames are numbered 0, 1, 2... in HandFrame::id (carrying on
+	across gaps and reset()), and stamped with their grid time. A gap in
+	the input longer than the maximum gap (tracking lost, or the device
+	paused) is not filled in: the grid restarts at the first frame after
+	it.
+
+	Nothing is allocated.
+
+	  resampler.push(frame);
+	  while (resampler.next(resampled))
+	      graph.update(resampled);
+*/
+class FrameResampler {
+	public:
+		/**
+		  rate : output frames per second
+		  maxGap : longest input gap to interpolate across, in
+		           microseconds
+		*/
+		FrameResampler(double rate = 100.0, int64_t maxGap = 100000);
+
+		/**
+		  Add the next input frame. Invalid frames, and frames no newer than
+		  the last one pushed, are ignored.
+
+		  Returns true if the frame was used; false otherwise
+		*/
+		bool push(const HandFrame& frame);
+
+		/**
+		  Write the next grid frame into frame, if the input has reached it.
+
+		  Returns true if a frame was written; false if the next grid frame
+		  needs more input
+		*/
+		bool next(HandFrame& frame);
+
+		/**
+		  Forget all input; the next frame pushed starts a new grid.
+		*/
+		void reset();
+
+		double getRate() const;
+
+		/**
+		  Returns the time between grid frames, in microseconds.
+		*/
+		double getPeriod() const;
+
+	private:
+		double mPeriod;
+		int64_t mMaxGap;
+
+		// The two newest input frames; mPrevious is only meaningful if
+		// mHasPrevious
+		HandFrame mPrevious, mCurrent;
+		bool mHasPrevious, mHasCurrent;
+
+		// Grid frames are at mStart + k * mPeriod; mIndex is the next k
+		int64_t mStart;
+		int64_t mIndex;
+		int64_t mNextId;
+
+		/**
+		  Returns the time of grid frame mIndex.
+		*/
+		int64_t getNextTime() const;
+
+		/**
+		  Write into out the frame a fraction alpha (0 to 1) of the way from
+		  mPrevious to mCurrent.
+		*/
+		void interpolate(double alpha, HandFrame& out) const;
+};
+
+#endif
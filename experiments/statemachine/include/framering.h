@@ -0,0 +1,275 @@
+/*
+	Philip Romano
+	10/16/2026
+	framering.h
+*/
+
+#ifndef FRAMERING_H
+#define FRAMERING_H
+
+#include <string>
+#include <atomic>
+#include <stdint.h>
+
+#include "handframe.h"
+
+/**
+	Frame rings carry HandFrames from a tracker process to any number of
+	gesture processes through a named block of shared memory: a
+	FrameRingHeader followed by a power-of-two number of FrameRingSlots.
+
+	The writer never waits for readers. Each slot carries a sequence number
+	that says which frame it holds and whether it is being written, so a
+	reader can tell whether a frame it read was overwritten in the
+	meantime, as with a seqlock.
+
+	Both sides must be built with the same HandFrame layout; a ring whose
+	version, header size or stride does not match is rejected.
+*/
+struct FrameRingHeader {
+	static const uint32_t VERSION = 1;
+
+	// "HANDRING"
+	char magic[8];
+	uint32_t version;
+	uint32_t headerSize;
+
+	// Size of each slot in bytes (sizeof(FrameRingSlot))
+	uint32_t stride;
+
+	// Number of slots, a power of two
+	uint32_t capacity;
+
+	// Number of frames published so far
+	std::atomic<uint64_t> head;
+
+	// Bumped whenever a frame is published or the ring is closed; readers
+	// sleep on it in FrameRingReader::wait()
+	std::atomic<uint32_t> signal;
+
+	// Number of readers sleeping in wait(), so that the writer only makes
+	// a system call to wake them when there are any
+	std::atomic<uint32_t> waiters;
+
+	// Set once the writer has closed the ring
+	std::atomic<uint32_t> closed;
+
+	// Padding, so that the slots start on a cache line of their own
+	char padding[20];
+
+	/**
+	  Fill in the header of a new ring of the given capacity.
+	*/
+	void initialize(uint32_t capacity);
+
+	/**
+	  Returns true if this is the header of a ring this build can read.
+	*/
+	bool isCompatible() const;
+};
+
+struct FrameRingSlot {
+	// 2i + 1 while frame i is being written into the slot; 2i + 2 once it
+	// has been
+	std::atomic<uint64_t> sequence;
+
+	HandFrame frame;
+};
+
+/**
+	Publishes frames into a frame ring, for FrameRingReaders in this or
+	other processes. Appending never allocates, locks or waits for readers:
+	once the ring is full, each new frame overwrites the oldest one, and
+	readers that have fallen that far behind skip the frames they missed.
+
+	Only one writer may publish to a ring, and only one thread may append
+	at a time.
+*/
+class FrameRingWriter {
+	public:
+		FrameRingWriter();
+
+		/**
+		  Closes the ring, if it is open.
+		*/
+		~FrameRingWriter();
+
+		/**
+		  Create a ring with the given name and number of slots (rounded up
+		  to a power of two), replacing any ring of the same name.
+
+		  Returns true if the ring was created; false otherwise
+		*/
+		bool create(const std::string& name, int capacity = 256);
+
+		/**
+		  Mark the ring closed, wake any readers waiting on it, and remove
+		  its name. Readers that have it open keep their mapping until they
+		  close it.
+		*/
+		void close();
+
+		bool isOpen() const;
+
+		/**
+		  Returns the slot for the next frame, to be filled in place and
+		  then published with commitAppend(). Returns null if the ring is
+		  not open.
+		*/
+		HandFrame* beginAppend();
+
+		/**
+		  Publish the frame returned by the last beginAppend(), and wake any
+		  waiting readers.
+		*/
+		void commitAppend();
+
+		/**
+		  Copy frame into the ring. Returns false if the ring is not open.
+		*/
+		bool append(const HandFrame& frame);
+
+		/**
+		  Returns the number of frames published so far.
+		*/
+		uint64_t getWritten() const;
+
+	private:
+		std::string mName;
+		FrameRingHeader *mHeader;
+		FrameRingSlot *mSlots;
+		uint64_t mMask;
+		int64_t mLength;
+
+#ifdef _WIN32
+		void *mMappingHandle;
+#endif
+
+		// Not copyable
+		FrameRingWriter(const FrameRingWriter&);
+		FrameRingWriter& operator=(const FrameRingWriter&);
+};
+
+/**
+	Reads the frames published to a frame ring, in place: acquire() returns
+	a pointer straight into the shared memory, and release() says whether
+	the frame stayed intact while it was in use. A frame that was
+	overwritten must be ignored (it may be half old, half new); it is
+	counted as missed. Readers never slow the writer down, and any number
+	of them may read the same ring, each at its own pace.
+
+	One reader object must only be used by one thread at a time.
+*/
+class FrameRingReader {
+	public:
+		FrameRingReader();
+
+		/**
+		  Closes the ring, if it is open.
+		*/
+		~FrameRingReader();
+
+		/**
+		  Open the ring with the given name. Reading starts with the next
+		  frame published.
+
+		  Returns true if the ring was opened; false otherwise (it does not
+		  exist, or is not compatible with this build)
+		*/
+		bool open(const std::string& name);
+
+		void close();
+
+		bool isOpen() const;
+
+		/**
+		  Returns the next unread frame, in place in the ring, or null if no
+		  frame has been published since the last one read. If the writer
+		  has lapped the reader, the frames overwritten are skipped and
+		  counted as missed.
+
+		  The frame stays valid until release() is called, or until the
+		  writer overwrites it; see release().
+		*/
+		const HandFrame* acquire();
+
+		/**
+		  Finish with the frame returned by acquire(), and move on to the
+		  next.
+
+		  Returns true if the frame was not overwritten while it was held,
+		  so that whatever was read from it can be trusted; false otherwise
+		  (it is then counted as missed)
+		*/
+		bool release();
+
+		/**
+		  Copy the next unread frame into frame.
+
+		  Returns true if a frame was copied; false if none is available
+		*/
+		bool read(HandFrame& frame);
+
+		/**
+		  Skip every unread frame but the newest, as a consumer that only
+		  wants the latest input would. Skipped frames are not counted as
+		  missed.
+		*/
+		void skipToLatest();
+
+		/**
+		  Block until a frame is available, the writer closes the ring, or
+		  timeoutMs milliseconds pass (forever if timeoutMs is negative). On
+		  Linux, this sleeps on a futex in the shared memory; elsewhere it
+		  polls every millisecond.
+
+		  Returns true if a frame is available; false otherwise
+		*/
+		bool wait(int timeoutMs = -1);
+
+		/**
+		  Returns the number of published frames not yet read.
+		*/
+		uint64_t getAvailable() const;
+
+		/**
+		  Returns true once the writer has closed the ring.
+		*/
+		bool isWriterClosed() const;
+
+		/**
+		  Returns the number of frames read and released intact.
+		*/
+		uint64_t getRead() const;
+
+		/**
+		  Returns the number of frames lost because the writer overwrote
+		  them before (or while) they were read.
+		*/
+		uint64_t getMissed() const;
+
+	private:
+		// Mapped for writing too, since wait() registers itself in the
+		// header; the reader never writes to the slots
+		FrameRingHeader *mHeader;
+		const FrameRingSlot *mSlots;
+		uint64_t mMask;
+		int64_t mLength;
+
+		// Index of the next frame to read, and of the frame acquired
+		uint64_t mNext;
+		const FrameRingSlot *mAcquired;
+
+		uint64_t mRead;
+		uint64_t mMissed;
+
+#ifdef _WIN32
+		void *mMappingHandle;
+#endif
+
+		// Not copyable
+		FrameRingReader(const FrameRingReader&);
+		FrameRingReader& operator=(const FrameRingReader&);
+};
+
+#endif
@@ -0,0 +1,218 @@
+/*
+	Philip Romano
+	10/16/2026
+	gesturelatency.h
+*/
+
+#ifndef GESTURELATENCY_H
+#define GESTURELATENCY_H
+
+#include <vector>
+#include <ostream>
+#include <mutex>
+#include <stdint.h>
+
+#include "handframe.h"
+#include "gestureprofile.h"
+
+class CompiledGestureGraph;
+
+/**
+	One gesture followed from the hand motion that caused it to the screen.
+	Times are GestureProfile::now() timestamps, in nanoseconds; a stage
+	that was not seen is -1.
+*/
+struct LatencyEvent {
+	// Node entered, with an enter action, and the session that entered it
+	int node;
+	int session;
+
+	// The graph frame that entered the node: its ID and capture time, in
+	// the tracker's microseconds
+	int64_t frameId;
+	int64_t frameTime;
+
+	// When each stage was reached (see GestureLatency::Stage)
+	int64_t times[5];
+};
+
+/**
+	Measures end-to-end gesture latency: how long it takes from the hand
+	motion, through the graph, to the screen showing the result. Every
+	time the graph enters a node that has an enter action (see
+	GestureStateGraph::setLatency()), an event is opened and tagged with
+	the frame that did it, and then stamped at each stage:
+
+	  CAPTURE  the tracker captured the frame (see arrive())
+	  ENQUEUE  the frame reached the process: arrive() was called for it
+	  COMMIT   the graph entered the node and ran its action
+	  CONSUME  the application acted on it: consume()
+	  PRESENT  the result was on screen: present()
+
+	The tracker's clock is not the host's, so CAPTURE is estimated: frame
+	times are mapped onto the host clock by the smallest difference
+	arrive() has seen between the two. Capture to enqueue is then the
+	delay on top of the quickest delivery so far, which is what varies and
+	what can be tuned; the fixed part cannot be seen from here.
+
+	arrive(), commit(), consume() and present() may be called from
+	different threads (the tracker's, the graph's and the render thread).
+	Each takes a lock; only arrive() is called for every frame. Nothing is
+	allocated after construction, except by report() and writeCsv(). The
+	newest capacity events that were presented are kept.
+
+	  // Tracker thread, for every frame
+	  latency->arrive(frame);
+	  graph.update(frame);
+
+	  // Render thread
+	  latency->consume();
+	  render();
+	  swap();
+	  latency->present();
+*/
+class GestureLatency {
+	public:
+		enum Stage {
+			CAPTURE,
+			ENQUEUE,
+			COMMIT,
+			CONSUME,
+			PRESENT,
+			STAGES
+		};
+
+		GestureLatency(int capacity = 4096);
+
+		/**
+		  A frame from the tracker reached the process at time. Call before
+		  the frame (or anything resampled or coalesced from it) goes to
+		  the graph.
+		*/
+		void arrive(const HandFrame& frame,
+				int64_t time = GestureProfile::now());
+
+		/**
+		  The graph entered node, which has an enter action, on frame.
+		  Called by the graph (see CompiledGestureGraph::advance()).
+		*/
+		void commit(int node, const HandFrame& frame, int session = 0,
+				int64_t time = GestureProfile::now());
+
+		/**
+		  The application has acted on every gesture committed so far.
+		*/
+		void consume(int64_t time = GestureProfile::now());
+
+		/**
+		  Everything consumed so far is on screen; those events are
+		  complete.
+		*/
+		void present(int64_t time = GestureProfile::now());
+
+		/**
+		  Forget every event, complete or not.
+		*/
+		void reset();
+
+		/**
+		  Returns the number of complete events kept.
+		*/
+		int getCount() const;
+
+		/**
+		  Returns complete event i, the oldest first. Events may arrive
+		  between calls, and move every index along; use getEvents() to
+		  read them all.
+		*/
+		LatencyEvent getEvent(int i) const;
+
+		/**
+		  Returns a copy of every complete event, the oldest first, all
+		  taken at the same moment.
+		*/
+		std::vector<LatencyEvent> getEvents() const;
+
+		/**
+		  Returns the number of events lost because too many were open at
+		  once (committed, but never presented).
+		*/
+		uint64_t getAbandoned() const;
+
+		/**
+		  Returns the time from stage from to stage to of event, in
+		  nanoseconds, or -1 if either stage was not seen.
+		*/
+		static int64_t getLatency(const LatencyEvent& event, Stage from,
+				Stage to);
+
+		/**
+		  Returns the pth percentile (0 to 100) of values, by nearest rank,
+		  or -1 if values is empty. Sorts values.
+		*/
+		static int64_t getPercentile(std::vector<int64_t>& values, double p);
+
+		/**
+		  Write a table of the complete events' latency percentiles (p50,
+		  p90, p99 and maximum, in milliseconds) for each stage and from
+		  end to end.
+		*/
+		void report(std::ostream& out) const;
+
+		/**
+		  Write the complete events as CSV, one per row, with the columns
+
+		    node,session,frame,frame_time,capture_ns,enqueue_ns,commit_ns,
+		    consume_ns,present_ns
+
+		  where the stage columns are relative to the capture (or, if it is
+		  unknown, the commit). Nodes are named after the nodes of graph
+		  with the same handles.
+		*/
+		void writeCsv(std::ostream& out, const CompiledGestureGraph& graph)
+				const;
+
+		static const char* getStageName(Stage stage);
+
+	private:
+		// Recent arrivals: frame times (tracker microseconds) and when they
+		// arrived, in a ring of ARRIVALS
+		static const int ARRIVALS = 64;
+		int64_t mArrivalFrame[ARRIVALS];
+		int64_t mArrivalTime[ARRIVALS];
+		uint64_t mArrivals;
+
+		// Host time minus frame time, in nanoseconds, at the quickest
+		// arrival
+		int64_t mClockOffset;
+		bool mHasClock;
+
+		// Events committed but not yet presented, oldest first; the first
+		// mConsumed of them have been consumed
+		static const int OPEN = 64;
+		LatencyEvent mOpen[OPEN];
+		int mOpenCount;
+		int mConsumed;
+		uint64_t mAbandoned;
+
+		// Complete events, in a ring
+		std::vector<LatencyEvent> mEvents;
+		uint64_t mCount;
+
+		mutable std::mutex mMutex;
+
+		/**
+		  Returns when the first frame at or after frameTime arrived, or -1
+		  if no such arrival is remembered.
+		*/
+		int64_t findArrival(int64_t frameTime) const;
+
+		/**
+		  Copy every complete event into events, the oldest first, and the
+		  count of abandoned events into abandoned, under one lock.
+		*/
+		void snapshot(std::vector<LatencyEvent>& events,
+				uint64_t& abandoned) const;
+};
+
+#endif
@@ -0,0 +1,50 @@
+/*
+	Philip Romano
+	10/16/2026
+	gesturememo.h
+*/
+
+#ifndef GESTUREMEMO_H
+#define GESTUREMEMO_H
+
+#include <vector>
+#include <stdint.h>
+
+/**
+	Remembers, for each pure GestureNode type of a compiled graph, the slot
+	that its evaluate() returned for the most recent frame (see
+	GestureNode::isPure()). Entries are indexed by the memo index that
+	CompiledGestureGraph assigns each pure type.
+
+	A memo holds one entry per type, not a history: a lookup only hits if
+	the entry was stored for the same frame. Storing the result for a new
+	frame replaces it, so a memo never needs clearing between frames.
+*/
+class GestureMemo {
+	public:
+		GestureMemo();
+
+		/**
+		  Make room for size types, forgetting every stored result.
+		*/
+		void resize(int size);
+
+		int size() const;
+
+		/**
+		  If a result for type has been stored for frame, sets slot to it
+		  and returns true. Returns false otherwise.
+		*/
+		bool lookup(int type, int64_t frame, int& slot) const;
+
+		void store(int type, int64_t frame, int slot);
+
+	private:
+		// Frame each entry was stored for; mValid says whether it was
+		// stored at all
+		std::vector<int64_t> mFrames;
+		std::vector<int> mSlots;
+		std::vector<bool> mValid;
+};
+
+#endif
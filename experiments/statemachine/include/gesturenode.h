@@ -8,14 +8,26 @@
 #define GESTURENODE_H
 
 #include <string>
-#include <Leap.h>
+#include <new>
+#include <cstddef>
+
+#include "handframe.h"
 
 /**
 	GestureNode is an abstract base class that defines the behavior of nodes
 	in a GestureStateGraph.
+
+	A single GestureNode object is shared by every node of its type, so it
+	should not hold state that belongs to one node. Instead, a type may ask
+	for a block of per-node state (see getStateSize()); the graph allocates
+	one block for every node of the type and passes it to evaluate(),
+	onEnter() and onLeave() as state. Types that need no state receive a
+	null pointer. See StatefulGestureNode for typed access to the block.
 */
 class GestureNode {
 	public:
+		virtual ~GestureNode();
+
 		/**
 			Get the name used to identify the specific type of GestureNode that
 			this object is. Ideally, the name should describe the behavior
@@ -25,34 +37,124 @@ class GestureNode {
 		virtual const std::string& getName() = 0;
 
 		/**
-		  Processes the provided Leap Motion frame data and returns an integer
+		  Processes the provided hand frame data and returns an integer
 		  that corresponds to the branch index that should be followed after
-		  this node.
+		  this node. state is the node's state block.
 		*/
-		virtual int evaluate(const Leap::Frame& frame,
-				const std::string& nodeid) = 0;
+		virtual int evaluate(const HandFrame& frame,
+				const std::string& nodeid, void *state) = 0;
 
 		/**
 		  Callback when a node of this GestureNode type becomes the current
 		  node in the graph. nodeid is the ID of the specific node that is
-		  current.
+		  current, and state is its state block.
 
 		  It is not required to override this function. Default behavior does
 		  nothing.
 		*/
-		virtual void onEnter(const Leap::Frame& frame,
-				const std::string& nodeid);
+		virtual void onEnter(const HandFrame& frame,
+				const std::string& nodeid, void *state);
 
 		/**
 		  Callback when a node of this GestureNode type loses its status of
-		  current. nodeid is the ID of the specific node that was left.
+		  current. nodeid is the ID of the specific node that was left, and
+		  state is its state block.
 
 		  It is not required to override this function. Default behavior does
 		  nothing.
 		*/
-		virtual void onLeave(const Leap::Frame& frame,
-				const std::string& nodeid);
+		virtual void onLeave(const HandFrame& frame,
+				const std::string& nodeid, void *state);
+
+		/**
+		  Returns true if evaluate() is a pure predicate: its result depends
+		  only on the frame and on the GestureNode object's own parameters
+		  (or on other data that does not change while a frame is being
+		  processed), and not on nodeid or state.
+
+		  The graph then evaluates each pure type at most once per frame,
+		  and reuses the slot it returned for every other node of the type
+		  reached on that frame, in any session sharing the frame (see
+		  GestureMemo). Frames are told apart by HandFrame::id, so a
+		  pure type must not be fed different data under the same frame ID.
+		  Types with per-node state are never memoized.
+
+		  Default is false.
+		*/
+		virtual bool isPure();
+
+		/**
+		  Returns true if evaluate() and the callbacks take the frame they
+		  are passed to be a FeatureFrame (see FeatureNode). A graph with a
+		  node of such a type must then be fed FeatureFrames, and rejects
+		  plain HandFrames (see GestureStateGraph::update()).
+
+		  Default is false.
+		*/
+		virtual bool readsFeatures();
+
+		/**
+		  Number of bytes of state the graph should allocate for each node of
+		  this type. State blocks are copied and discarded as raw memory, so
+		  they must hold plain data only.
+
+		  Default is 0 (no state).
+		*/
+		virtual std::size_t getStateSize();
+
+		/**
+		  Initialize a newly allocated state block. Called once for each node
+		  of this type when the node's state is created.
+
+		  Default behavior does nothing.
+		*/
+		virtual void initState(void *state);
 };
 
-#endif
+/**
+	Convenience base for GestureNode types whose nodes each hold a State
+	struct. State must be plain data; it is value-initialized (zeroed, unless
+	it has a constructor) when a node is created.
+
+	Derived classes override the overloads that take State& instead of
+	void*.
+*/
+template <class State>
+class StatefulGestureNode : public GestureNode {
+	public:
+		virtual int evaluate(const HandFrame& frame,
+				const std::string& nodeid, State& state) = 0;
+
+		virtual void onEnter(const HandFrame& frame,
+				const std::string& nodeid, State& state)
+			{ }
 
+		virtual void onLeave(const HandFrame& frame,
+				const std::string& nodeid, State& state)
+			{ }
+
+		virtual int evaluate(const HandFrame& frame,
+				const std::string& nodeid, void *state) {
+			return evaluate(frame, nodeid, *static_cast<State*>(state));
+		}
+
+		virtual void onEnter(const HandFrame& frame,
+				const std::string& nodeid, void *state) {
+			onEnter(frame, nodeid, *static_cast<State*>(state));
+		}
+
+		virtual void onLeave(const HandFrame& frame,
+				const std::string& nodeid, void *state) {
+			onLeave(frame, nodeid, *static_cast<State*>(state));
+		}
+
+		virtual std::size_t getStateSize() {
+			return sizeof(State);
+		}
+
+		virtual void initState(void *state) {
+			new (state) State();
+		}
+};
+
+#endif
@@ -0,0 +1,108 @@
+/*
+	Philip Romano
+	10/16/2026
+	gestureprofile.h
+*/
+
+#ifndef GESTUREPROFILE_H
+#define GESTUREPROFILE_H
+
+#include <vector>
+#include <ostream>
+#include <stdint.h>
+
+class CompiledGestureGraph;
+
+/**
+	Per-node profiling counters for a gesture graph (see
+	GestureStateGraph::setProfile()). For every node, a profile counts how
+	many times the node was evaluated, how many times each slot was chosen,
+	and how long GestureNode::evaluate() took, as a histogram with
+	power-of-two buckets.
+
+	Profiling is opt-in: it costs two clock reads per evaluation. The
+	counters are not synchronized, so a profile should be written out or
+	reset only while no update() is running on it.
+*/
+class GestureProfile {
+	public:
+		/**
+		  Number of histogram buckets. Bucket 0 counts evaluations that took
+		  less than 2 ns; bucket k > 0 counts evaluations that took from
+		  2^k ns up to (not including) 2^(k+1) ns. The last bucket also
+		  counts anything longer.
+		*/
+		static const int BUCKETS = 32;
+
+		struct NodeCounters {
+			uint64_t visits;
+			uint64_t evaluateNs;
+
+			// Number of times evaluate() returned each slot number
+			std::vector<uint64_t> slots;
+
+			uint64_t histogram[BUCKETS];
+
+			NodeCounters();
+		};
+
+		GestureProfile();
+
+		~GestureProfile();
+
+		/**
+		  Count one evaluation of node, which returned slot after ns
+		  nanoseconds. Negative slots are counted as visits only.
+		*/
+		void record(int node, int slot, int64_t ns);
+
+		/**
+		  Zero every counter.
+		*/
+		void reset();
+
+		/**
+		  Returns the counters of the given node; all zero if it has not
+		  been evaluated.
+		*/
+		const NodeCounters& getCounters(int node) const;
+
+		int getNodeCount() const;
+
+		/**
+		  Write the counters as CSV, one value per row, with the columns
+
+		    node,type,metric,key,value
+
+		  where metric is "visits", "evaluate_ns", "slot" (key is the slot
+		  number) or "histogram" (key is the bucket's lower bound in ns).
+		  Zero slot and histogram counts are left out. Nodes are named after
+		  the nodes of graph with the same handles.
+		*/
+		void writeCsv(std::ostream& out, const CompiledGestureGraph& graph)
+				const;
+
+		/**
+		  Write the counters as a JSON object of the form
+
+		    { "nodes": [ { "node": id, "type": name, "visits": n,
+		        "evaluate_ns": n, "slots": { "0": n, ... },
+		        "histogram": { "1024": n, ... } }, ... ] }
+
+		  with the same keys and omissions as writeCsv().
+		*/
+		void writeJson(std::ostream& out, const CompiledGestureGraph& graph)
+				const;
+
+		/**
+		  Returns a monotonic timestamp in nanoseconds, for timing
+		  evaluations.
+		*/
+		static int64_t now();
+
+	private:
+		// Counters, indexed by node handle; grown as nodes are recorded
+		std::vector<NodeCounters> mNodes;
+};
+
+#endif
@@ -0,0 +1,199 @@
+/*
+	Philip Romano
+	10/16/2026
+	gesturesession.h
+*/
+
+#ifndef GESTURESESSION_H
+#define GESTURESESSION_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include "handframe.h"
+#include "compiledgesturegraph.h"
+#include "gesturetrace.h"
+#include "gestureprofile.h"
+#include "gesturelatency.h"
+#include "gesturememo.h"
+
+class GestureSessionSet;
+struct FeatureFrame;
+
+/**
+	A GestureSession is one independent walk through a shared, read-only
+	CompiledGestureGraph: for example, one user, one hand, or one window.
+	It holds only the session's runtime state (current node, the time that
+	node was entered, and the state blocks of the graph's nodes), so many
+	sessions can share one graph definition.
+
+	GestureSession is a lightweight handle into the GestureSessionSet that
+	stores it, and is cheap to copy. It remains valid until the set is
+	cleared or destroyed.
+*/
+class GestureSession {
+	public:
+		typedef CompiledGestureGraph::NodeHandle NodeHandle;
+
+		GestureSession(GestureSessionSet *set, int index);
+
+		/**
+		  Advance this session alone by one frame. See
+		  CompiledGestureGraph::advance().
+
+		  Throws GestureStateException if the graph reads features and the
+		  frame is a plain HandFrame (see GestureSessionSet).
+		*/
+		void update(const HandFrame& frame);
+		void update(const FeatureFrame& frame);
+
+		/**
+		  Move this session back to the start node of the graph and
+		  reinitialize its node state, without calling any callbacks.
+		*/
+		void reset();
+
+		NodeHandle getCurrentNode() const;
+
+		const std::string& getCurrentId() const;
+
+		/**
+		  Returns the timestamp of the frame on which the current node was
+		  entered, or 0 if the session has not left the start node yet.
+		*/
+		int64_t getTimeEntered() const;
+
+		int getIndex() const;
+
+	private:
+		GestureSessionSet *mSet;
+		int mIndex;
+};
+
+/**
+	Storage for many GestureSessions that run against the same compiled
+	graph. Session state is kept as parallel arrays (structure-of-arrays)
+	indexed by session, so that update() steps every session in one
+	contiguous pass.
+
+	A graph with a node type that reads features (see
+	CompiledGestureGraph::readsFeatures()) must be fed FeatureFrames,
+	through the overloads that take them; the overloads that take plain
+	HandFrames throw GestureStateException on such a graph.
+*/
+class GestureSessionSet {
+	public:
+		typedef CompiledGestureGraph::NodeHandle NodeHandle;
+
+		/**
+		  Create an empty set of sessions on the given graph (see
+		  GestureStateGraph::compile()).
+		*/
+		GestureSessionSet(boost::shared_ptr<const CompiledGestureGraph> graph);
+
+		~GestureSessionSet();
+
+		/**
+		  Add a new session, starting at the graph's start node.
+		*/
+		GestureSession createSession();
+
+		GestureSession getSession(int index);
+
+		int size() const;
+
+		/**
+		  Remove all sessions.
+		*/
+		void clear();
+
+		/**
+		  Advance every session by the same frame.
+		*/
+		void update(const HandFrame& frame);
+		void update(const FeatureFrame& frame);
+
+		/**
+		  Advance every session by its own frame; session i is fed
+		  frames[i]. frames must hold at least size() frames. Sessions that
+		  are fed the same frame share the results of pure node types only
+		  if they are adjacent.
+		*/
+		void update(const std::vector<HandFrame>& frames);
+		void update(const std::vector<FeatureFrame>& frames);
+
+		/**
+		  Advance session i alone by a frame of its own, such as one hand's
+		  view of a frame that the other sessions see differently under
+		  the same frame ID. Pure node types are evaluated afresh, instead
+		  of sharing results with the other sessions.
+		*/
+		void updateSession(int i, const HandFrame& frame);
+		void updateSession(int i, const FeatureFrame& frame);
+
+		const CompiledGestureGraph& getGraph() const;
+
+		/**
+		  Record every transition taken by any session in the given trace,
+		  tagged with the session's index. A null trace turns tracing off.
+		*/
+		void setTrace(boost::shared_ptr<GestureTrace> trace);
+
+		/**
+		  Count and time every node evaluation of every session in the
+		  given profile. A null profile turns profiling off.
+		*/
+		void setProfile(boost::shared_ptr<GestureProfile> profile);
+
+		/**
+		  Open a latency event, tagged with the session's index, whenever
+		  any session enters a node that has an enter action. A null
+		  recorder turns it off.
+		*/
+		void setLatency(boost::shared_ptr<GestureLatency> latency);
+
+	private:
+		friend class GestureSession;
+
+		boost::shared_ptr<const CompiledGestureGraph> mGraph;
+
+		// Per-session state, indexed by session
+		std::vector<NodeHandle> mCurrent;
+		std::vector<int64_t> mTimeEntered;
+
+		// Node state arenas of all sessions, back to back; session i's arena
+		// starts at i * mGraph->getStateSize()
+		std::vector<char> mStates;
+
+		// Results of pure node types on the latest frame, shared by every
+		// session, so a predicate is evaluated once per frame for all of them
+		GestureMemo mMemo;
+
+		// Transition history of every session; may be null
+		boost::shared_ptr<GestureTrace> mTrace;
+
+		// Evaluation counters of every session; may be null
+		boost::shared_ptr<GestureProfile> mProfile;
+
+		// Gesture events of every session; may be null
+		boost::shared_ptr<GestureLatency> mLatency;
+
+		/**
+		  Advance session i by one frame, sharing the results of pure node
+		  types through memo unless it is null.
+		*/
+		void step(int i, const HandFrame& frame, GestureMemo *memo);
+
+		/**
+		  Throws GestureStateException if the graph reads features, and so
+		  must not be fed plain HandFrames.
+		*/
+		void rejectHandFrames() const;
+
+		char* getStates(int i);
+};
+
+#endif
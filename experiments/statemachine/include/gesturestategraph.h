@@ -10,12 +10,21 @@
 #include <string>
 #include <map>
 #include <set>
+#include <vector>
+#include <ostream>
 
 #include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
 
-#include <Leap.h>
-
+#include "handframe.h"
 #include "gesturenode.h"
+#include "gesturetrace.h"
+#include "gestureprofile.h"
+#include "gesturelatency.h"
+#include "gesturememo.h"
+
+class CompiledGestureGraph;
+struct FeatureFrame;
 
 /**
 	A gesture state graph is a directed graph that is designed to allow
@@ -44,9 +53,37 @@
 	indefinitely. Thus, when constructing the graph through GestureStateGraph,
 	it is important to carefully design the graph to avoid cycles (though
 	a typical graph for Gestures would have more states than decision nodes)
+
+	GestureStateGraph tracks a single current node. To drive several
+	independent walks (users, hands, windows) through one graph definition,
+	compile() the graph and create GestureSessions on the result (see
+	GestureSessionSet).
 */
 class GestureStateGraph {
 	public:
+		/**
+		  Dense integer handle identifying a node in the graph. Handles are
+		  indices into the graph's node table and remain valid until the node
+		  is removed or the graph is cleared.
+		*/
+		typedef int NodeHandle;
+
+		/**
+		  Dense integer handle identifying a GestureNode type registered with
+		  the graph (see createNodeType()).
+		*/
+		typedef int TypeHandle;
+
+		/**
+		  A callback bound to one specific node (see setEnterAction() and
+		  setLeaveAction()). It is passed the frame that caused the
+		  transition.
+		*/
+		typedef boost::function<void (const HandFrame&)> Action;
+
+		static const NodeHandle INVALID_NODE = -1;
+		static const TypeHandle INVALID_TYPE = -1;
+
 		/**
 		  Create a new, empty gesture state graph.
 		*/
@@ -64,11 +101,11 @@ class GestureStateGraph {
 		    type : an instance of the desired GestureNode to be provided to
 		           this graph
 
-		  Returns true if this graph does not already have a type whose
-		  getName() is equivalent to type.getName(), and the type was
-		  successfully added. False otherwise.
+		  Returns the handle of the new type if this graph does not already
+		  have a type whose getName() is equivalent to type.getName(), and the
+		  type was successfully added. INVALID_TYPE otherwise.
 		*/
-		bool createNodeType(boost::shared_ptr<GestureNode> type);
+		TypeHandle createNodeType(boost::shared_ptr<GestureNode> type);
 
 		/**
 		  Remove the GestureNode type whose getName() matches the given name.
@@ -78,49 +115,115 @@ class GestureStateGraph {
 		*/
 		boost::shared_ptr<GestureNode> removeNodeType(const std::string& name);
 
+		/**
+		  Returns the handle of the type with the given name, or INVALID_TYPE
+		  if no such type is registered.
+		*/
+		TypeHandle getTypeHandle(const std::string& type);
+
 		/**
 		  Add a node to the graph of the given type. The node can be later
-		  identified with nodeid.
+		  identified with nodeid, or with the returned handle.
+
+		  If the type has per-node state (see GestureNode::getStateSize()), a
+		  state block for the node is allocated in the graph's state arena
+		  and initialized with GestureNode::initState().
 
-		  If this is the first node being added to the graph, then it becomes
-		  the Starting node of the graph. (see setStart()/getStart()). It also
-		  becomes the State Machine's current node.
+		  If the graph has no start node (this is the first node being added
+		  to the graph, or the start node was removed), then the new node
+		  becomes the Starting node of the graph. (see setStart()/getStart()).
+		  If the graph has no current node either, it also becomes the State
+		  Machine's current node.
 		  
-		  Returns true if the node was added; false otherwise (the provided
-		  type name is not registered. See createNodeType())
+		  Returns the handle of the new node if it was added; INVALID_NODE
+		  otherwise (the provided type is not registered, see createNodeType(),
+		  or a node with the given ID already exists)
 		*/
-		bool addNode(const std::string& type, const std::string& nodeid);
+		NodeHandle addNode(const std::string& type, const std::string& nodeid);
+		NodeHandle addNode(TypeHandle type, const std::string& nodeid);
 
 		/**
-		  Remove the node with the given ID from the graph.
+		  Remove the node with the given ID from the graph, along with every
+		  connection into or out of it. Slots of other nodes that led to the
+		  removed node become unconnected. Costs time proportional to the
+		  number of connections the node has, not to the size of the graph.
+
+		  If the removed node was the current node, the current node moves
+		  to the start node, without calling any callbacks. If it was the
+		  start node, the graph has no start node until setStart() is
+		  called or another node is added.
+
+		  The handle of a removed node may be reused by a later addNode().
 
 		  Returns true if a node was removed from the graph; false otherwise
 		  (no node with the given ID existed)
 		*/
 		bool removeNode(const std::string& nodeid);
+		bool removeNode(NodeHandle node);
 
 		/**
 		  Returns true if a node with the given id currently exists in the
 		  graph.
 		*/
 		bool nodeExists(const std::string& nodeid);
+		bool nodeExists(NodeHandle node);
+
+		/**
+		  Returns the handle of the node with the given ID, or INVALID_NODE if
+		  no such node exists.
+		*/
+		NodeHandle getNode(const std::string& nodeid);
+
+		/**
+		  Returns the ID of the node with the given handle, or an empty string
+		  if the handle does not refer to an existing node.
+		*/
+		const std::string& getNodeId(NodeHandle node);
 
 		bool setStart(const std::string& nodeid);
+		bool setStart(NodeHandle node);
 
 		boost::shared_ptr<GestureNode> getStart();
 
 		boost::shared_ptr<GestureNode> getCurrentState();
 
+		NodeHandle getStartNode();
+
+		NodeHandle getCurrentNode();
+
 		/**
 		  Create a directed connection from the given slot in node start to
 		  node end. If the slot was already connected to another node, then
 		  it is updated to connect to end.
 
 		  Returns true if a connection was created; false otherwise (start or
-		  end is not an existent node)
+		  end is not an existent node, or slot is negative)
 		*/
 		bool addConnection(const std::string& start, int slot,
 				const std::string& end);
+		bool addConnection(NodeHandle start, int slot, NodeHandle end);
+
+		/**
+		  Bind an action to be called whenever the given node becomes the
+		  current node, after its GestureNode's onEnter(). Replaces any action
+		  previously bound; an empty Action removes it.
+
+		  This lets several nodes of one GestureNode type do different things
+		  on entry without the type having to inspect nodeid.
+
+		  Returns true if the action was bound; false otherwise (the node does
+		  not exist)
+		*/
+		bool setEnterAction(const std::string& nodeid, const Action& action);
+		bool setEnterAction(NodeHandle node, const Action& action);
+
+		/**
+		  Bind an action to be called whenever the given node stops being the
+		  current node, after its GestureNode's onLeave(). See
+		  setEnterAction().
+		*/
+		bool setLeaveAction(const std::string& nodeid, const Action& action);
+		bool setLeaveAction(NodeHandle node, const Action& action);
 
 		/**
 		  Remove a connection from the given slot in node start.
@@ -129,6 +232,7 @@ class GestureStateGraph {
 		  not an existent node, or no connection existed in slot)
 		*/
 		bool removeConnection(const std::string& start, int slot);
+		bool removeConnection(NodeHandle start, int slot);
 
 		/**
 		  Returns the name of the connected node in the slot number of the
@@ -138,10 +242,31 @@ class GestureStateGraph {
 		std::string getSlot(const std::string& nodeid, int slot);
 
 		/**
-		  Clear all contents of the graph. Node Types are not removed.
+		  Returns the handle of the connected node in the slot number of the
+		  given node. Returns INVALID_NODE if the slot is not connected or if
+		  the node does not exist.
+		*/
+		NodeHandle getSlot(NodeHandle node, int slot);
+
+		/**
+		  Clear all contents of the graph, including node state. Node Types
+		  are not removed.
 		*/
 		void clear();
 
+		/**
+		  Produce an immutable snapshot of the graph for update() to run
+		  against (see CompiledGestureGraph). The snapshot is cached until the
+		  graph is next modified.
+
+		  The graph is validated while compiling: a cycle made only of
+		  decision nodes would make update() loop forever, so it is rejected.
+
+		  Throws GestureStateException if the graph contains a decision-only
+		  cycle.
+		*/
+		boost::shared_ptr<const CompiledGestureGraph> compile();
+
 		/**
 		  Feeds the provided frame data to the current node and advances
 		  the current node until a node advances to itself. This is considered
@@ -162,13 +287,28 @@ class GestureStateGraph {
 		  states", but could also be useful for defining the end of a gesture
 		  without making explicit connections back to the "blank slate" start
 		  state.
+
+		  The graph is compiled first if it has been modified since the last
+		  call to compile(), so this throws GestureStateException under the
+		  same conditions as compile().
+
+		  A graph with a node type that reads features (see
+		  GestureNode::readsFeatures()) must be fed FeatureFrames, through
+		  the overload that takes one; fed a plain HandFrame, it throws
+		  GestureStateException.
+
+		  Once the graph is compiled, update() itself does not allocate and
+		  does not copy any shared pointers (tests/noalloc.cpp checks this);
+		  only the GestureNodes and actions it calls can.
 		*/
-		void update(const Leap::Frame& frame);
+		void update(const HandFrame& frame);
+		void update(const FeatureFrame& frame);
 
 		/**
 		  Returns the GestureNode object associated with the given type name.
 		*/
 		boost::shared_ptr<GestureNode> getType(const std::string& type);
+		boost::shared_ptr<GestureNode> getType(TypeHandle type);
 
 		/**
 		  Returns the GestureNode object associated with the node with the
@@ -176,59 +316,196 @@ class GestureStateGraph {
 		*/
 		boost::shared_ptr<GestureNode> getTypeFromNode(
 				const std::string& nodeid);
+		boost::shared_ptr<GestureNode> getTypeFromNode(NodeHandle node);
+
+		/**
+		  Record every transition that update() takes in the given trace
+		  (see GestureTrace). A null trace turns tracing off.
+		*/
+		void setTrace(boost::shared_ptr<GestureTrace> trace);
+
+		boost::shared_ptr<GestureTrace> getTrace();
+
+		/**
+		  Write the contents of the trace, with the IDs of the graph's
+		  current nodes, to out as a binary trace file (see
+		  GestureTrace::write()). Node IDs are those at the time of writing,
+		  so a node removed or replaced since a record was taken is named
+		  after its replacement.
+
+		  Returns true if a trace was written; false otherwise (no trace is
+		  set)
+		*/
+		bool writeTrace(std::ostream& out);
 
 		/**
-		  Performs an update (same as update()), but produces output for each
-		  node that is traversed. Prints the name of the node, and
-		  "STATE: [node]" once the update stops at a state node. Each name
-		  outputted is on a separate line.
+		  Count and time every node evaluation that update() performs in
+		  the given profile (see GestureProfile). A null profile turns
+		  profiling off. To write the profile out, pass it the graph from
+		  compile(), so that its node handles are named.
 		*/
-		void updateWithPrint(const Leap::Frame& frame);
+		void setProfile(boost::shared_ptr<GestureProfile> profile);
+
+		boost::shared_ptr<GestureProfile> getProfile();
+
+		/**
+		  Open an event in the given latency recorder (see GestureLatency)
+		  whenever update() enters a node that has an enter action, tagged
+		  with the frame that did it. A null recorder turns it off.
+		*/
+		void setLatency(boost::shared_ptr<GestureLatency> latency);
+
+		boost::shared_ptr<GestureLatency> getLatency();
 
 	private:
+		// A connection into a node: slot number slot of node node
+		struct Edge {
+			NodeHandle node;
+			int slot;
+
+			Edge(NodeHandle n, int s)
+					: node(n), slot(s)
+				{ }
+		};
+
 		struct NodeInstance {
-			std::string type;
+			TypeHandle type;
+
+			std::string id;
+
+			// Byte offset of this node's state block in mStates, or -1 if
+			// the node's type has no state (or the node was removed)
+			int stateOffset;
+
+			// Size of the state block at stateOffset, which may be larger
+			// than the type's state if the block was reused
+			int stateCapacity;
 
-			// The connections to other nodes (names), placed in the user-
-			// specified slot number
-			std::map<int,std::string> slots;
+			// The connections to other nodes, indexed by the user-specified
+			// slot number. Unconnected slots hold INVALID_NODE.
+			std::vector<NodeHandle> slots;
 
-			// NodeInstance must be given a type name
-			NodeInstance(std::string t) : type(t)
+			// For each connected slot, the position of its Edge in the
+			// target node's incoming list
+			std::vector<int> slotEdges;
+
+			// Every connected slot, in any node, that leads to this node
+			std::vector<Edge> incoming;
+
+			// Actions bound to this node; may be empty
+			Action enterAction, leaveAction;
+
+			// True once the node has been removed; its handle is then free
+			bool removed;
+
+			// NodeInstance must be given a type and an id
+			NodeInstance(TypeHandle t, const std::string& i, int offset,
+					int capacity)
+					: type(t), id(i), stateOffset(offset),
+					  stateCapacity(capacity), removed(false)
 				{ }
 		};
 
-		// Associates GestureNode type name to a GestureNode object
-		std::map< std::string,boost::shared_ptr<GestureNode> > mTypes;
+		// GestureNode objects, indexed by TypeHandle. Removed types leave a
+		// null entry so that the remaining handles stay valid.
+		std::vector< boost::shared_ptr<GestureNode> > mTypes;
+
+		// Associates GestureNode type name to its handle
+		std::map<std::string,TypeHandle> mTypeIndex;
+
+		// Flat node table, indexed by NodeHandle
+		std::vector<NodeInstance> mNodes;
 
-		// Associates indiviudal node name to a NodeInstance, which holds
-		// the type name and adjacencies (slots)
-		std::map< std::string,NodeInstance > mNodes;
+		// Associates individual node name to its handle
+		std::map<std::string,NodeHandle> mNodeIndex;
 
-		std::string mStartNode, mCurrentNode;
+		// Handles of removed nodes, to be reused by addNode()
+		std::vector<NodeHandle> mFreeNodes;
+
+		// A block of mStates: its byte offset and size
+		struct StateBlock {
+			int offset;
+			int capacity;
+
+			StateBlock(int o, int c)
+					: offset(o), capacity(c)
+				{ }
+		};
+
+		// State blocks of removed nodes, to be reused by addNode()
+		std::vector<StateBlock> mFreeStates;
+
+		NodeHandle mStartNode, mCurrentNode;
+
+		// Arena holding the state blocks of every node, one after another
+		// in the order the nodes were added, removed nodes' blocks being
+		// reused by the nodes added after them
+		std::vector<char> mStates;
+
+		// Snapshot that update() runs against; null when the graph has been
+		// modified since it was last compiled
+		boost::shared_ptr<const CompiledGestureGraph> mCompiled;
+
+		// Results of pure node types on the latest frame
+		GestureMemo mMemo;
+
+		// Transition history of update(); may be null
+		boost::shared_ptr<GestureTrace> mTrace;
+
+		// Evaluation counters of update(); may be null
+		boost::shared_ptr<GestureProfile> mProfile;
+
+		// Gesture events of update(), followed to the screen; may be null
+		boost::shared_ptr<GestureLatency> mLatency;
 
 		/**
-		  Returns a reference to the adjacency vector for the node with the
-		  given name.
+		  Point the given slot of start at end, keeping end's incoming list
+		  up to date. Both nodes must exist.
+		*/
+		void connect(NodeHandle start, int slot, NodeHandle end);
+
+		/**
+		  Unconnect the given slot of start, if it is connected, and remove
+		  it from the target's incoming list.
+		*/
+		void disconnect(NodeHandle start, int slot);
+
+		/**
+		  Find room for a state block of size bytes: the smallest free
+		  block it fits in, or else a new block at the end of mStates.
+		  Sets capacity to the size of the block.
 
-		  Throws GestureStateException if the given nodename does not exist
-		  in the graph.
+		  Returns the byte offset of the block
 		*/
-		std::map<int,std::string>& getAdjacencies(const std::string& nodeid);
+		int allocateState(int size, int& capacity);
 
 		/**
-		  Set the node with given ID to the current node. Calls the associated
-		  GestureNode's callbacks.
+		  Advance the current node by one frame, compiling the graph first
+		  if needed. The frame is not checked against the node types.
 		*/
-		void setCurrent(const std::string& nodeid, const Leap::Frame& frame);
+		void advance(const HandFrame& frame);
 
 };
 
 class GestureStateException : public std::exception {
 	public:
-		const char* what() {
-			return "Gesture state exception";
+		GestureStateException() throw()
+				: mMessage("Gesture state exception")
+			{ }
+
+		GestureStateException(const std::string& message) throw()
+				: mMessage(message)
+			{ }
+
+		~GestureStateException() throw()
+			{ }
+
+		const char* what() const throw() {
+			return mMessage.c_str();
 		}
+
+	private:
+		std::string mMessage;
 };
 
 #endif
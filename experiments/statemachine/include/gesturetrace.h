@@ -0,0 +1,121 @@
+/*
+	Philip Romano
+	10/16/2026
+	gesturetrace.h
+*/
+
+#ifndef GESTURETRACE_H
+#define GESTURETRACE_H
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <atomic>
+#include <stdint.h>
+
+/**
+	One transition recorded by a GestureTrace: on the frame with the given
+	timestamp, the walk moved from node from to node to by following slot.
+	If slot was not connected, to is the start node the walk was reset to.
+
+	The layout is fixed (24 bytes, no padding) and is written to trace
+	files as is.
+*/
+struct TraceRecord {
+	int64_t timestamp;
+	int32_t from;
+	int32_t to;
+	int32_t slot;
+
+	// Index of the session in its GestureSessionSet, or 0 for the current
+	// node of a GestureStateGraph
+	int32_t session;
+};
+
+/**
+	A fixed-size ring buffer of the most recent transitions taken by a
+	gesture graph (see GestureStateGraph::setTrace()).
+
+	All memory is allocated up front, and recording is a handful of stores
+	with no locks and no I/O, so a trace can be left on in production. Once
+	the ring is full, each new record overwrites the oldest one.
+
+	A trace may have one writer (the thread that calls update()) and any
+	number of readers: snapshot() and write() may be called from another
+	thread while the writer is running, and only return records that were
+	not being overwritten while they were copied.
+*/
+class GestureTrace {
+	public:
+		/**
+		  Create a trace that holds the given number of records. capacity
+		  is rounded up to a power of two.
+		*/
+		GestureTrace(int capacity);
+
+		~GestureTrace();
+
+		/**
+		  Append a record, overwriting the oldest one if the ring is full.
+		  Must only be called from one thread at a time.
+		*/
+		void record(int64_t timestamp, int from, int to, int slot,
+				int session = 0);
+
+		int getCapacity() const;
+
+		/**
+		  Returns the number of records appended since the trace was
+		  created, including those that have since been overwritten.
+		*/
+		uint64_t getCount() const;
+
+		/**
+		  Copy the records currently held, oldest first, into records.
+		*/
+		void snapshot(std::vector<TraceRecord>& records) const;
+
+		/**
+		  Write the records currently held to out as a binary trace file,
+		  along with the node IDs that the records' handles refer to (indexed
+		  by handle). out should be opened in binary mode.
+		*/
+		void write(std::ostream& out,
+				const std::vector<std::string>& nodeIds) const;
+
+		/**
+		  Read a binary trace file produced by write().
+
+		  Returns true if the file was read; false otherwise (it is not a
+		  trace file, or it is truncated)
+		*/
+		static bool read(std::istream& in, std::vector<std::string>& nodeIds,
+				std::vector<TraceRecord>& records);
+
+		/**
+		  Print records as text, one transition per line:
+
+		    [timestamp] [session]: [from] -[slot]-> [to]
+
+		  using nodeIds to name the nodes, where known.
+		*/
+		static void print(std::ostream& out,
+				const std::vector<std::string>& nodeIds,
+				const std::vector<TraceRecord>& records);
+
+	private:
+		std::vector<TraceRecord> mRecords;
+		uint64_t mMask;
+
+		// Number of records published, and number of records started. A
+		// record is being written while they differ.
+		std::atomic<uint64_t> mHead;
+		std::atomic<uint64_t> mClaimed;
+
+		// Not copyable
+		GestureTrace(const GestureTrace&);
+		GestureTrace& operator=(const GestureTrace&);
+};
+
+#endif
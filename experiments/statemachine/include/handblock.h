@@ -0,0 +1,102 @@
+/*
+	Philip Romano
+	10/16/2026
+	handblock.h
+*/
+
+#ifndef HANDBLOCK_H
+#define HANDBLOCK_H
+
+#include <vector>
+#include <stdint.h>
+
+#include "handframe.h"
+
+/**
+	One hand over a block of frames, stored by column: the x, y and z of
+	each fingertip's velocity, and of the palm's, each in its own array of
+	one value per frame. HandFrame keeps a frame's hands together, which
+	suits following them frame by frame; replaying a recording offline
+	instead reduces the same few values of thousands of frames at once,
+	which these columns let the compiler vectorize.
+
+	reduce() computes every frame's raw velocity, as
+	HandMotion::getRawVelocity() computes one hand's, with the same
+	floating-point operations in the same order: the results are equal to
+	the bit, and a replay fed them takes the same transitions. The
+	fingertips a hand does not have are loaded as zero, and the finger
+	count as a divisor and a scale, so that the reduction has no per-frame
+	branch; it runs on fixed groups of frames, which the compiler turns
+	into SIMD operations at -O2, with no intrinsics or target flags.
+
+	The columns are allocated once, at construction; load() and reduce()
+	allocate nothing.
+
+	  HandBlock block;
+	  int count = block.load(&frames[0], frames.size());
+	  block.reduce();
+	  motion.update(frames[i], block.getVelocity(i));
+*/
+class HandBlock {
+	public:
+		static const int DEFAULT_CAPACITY = 4096;
+
+		/**
+		  capacity : most frames the block holds
+		*/
+		HandBlock(int capacity = DEFAULT_CAPACITY);
+
+		/**
+		  Load the hand at index hand of up to getCapacity() frames, starting
+		  at frames. Frames without that hand have no fingers and a zero
+		  palm velocity.
+
+		  Returns the number of frames loaded
+		*/
+		int load(const HandFrame *frames, int count, int hand = 0);
+
+		/**
+		  Compute the raw velocity of every frame loaded.
+		*/
+		void reduce();
+
+		int getCapacity() const;
+
+		/**
+		  Returns the number of frames loaded.
+		*/
+		int size() const;
+
+		/**
+		  Returns true if frame i has the hand; false otherwise
+		*/
+		bool hasHand(int i) const;
+
+		/**
+		  Returns the raw velocity of frame i's hand, as of the last
+		  reduce(); zero if the frame has no hand.
+		*/
+		Vector3 getVelocity(int i) const;
+
+	private:
+		enum Column {
+			TIP_X, TIP_Y = TIP_X + HandData::MAX_FINGERS,
+			TIP_Z = TIP_Y + HandData::MAX_FINGERS,
+			PALM_X = TIP_Z + HandData::MAX_FINGERS, PALM_Y, PALM_Z,
+			DIVISOR, SCALE, VELOCITY_X, VELOCITY_Y, VELOCITY_Z, COLUMNS
+		};
+
+		int mCapacity;
+		int mSize;
+
+		// Every column, one after the other, mStride values apart
+		int mStride;
+		std::vector<float> mColumns;
+
+		std::vector<uint8_t> mHasHand;
+
+		float* column(int c);
+		const float* column(int c) const;
+};
+
+#endif
@@ -0,0 +1,108 @@
+/*
+	Philip Romano
+	10/16/2026
+	handframe.h
+*/
+
+#ifndef HANDFRAME_H
+#define HANDFRAME_H
+
+#include <cmath>
+#include <cstddef>
+#include <stdint.h>
+
+/**
+	Plain-data frame of hand tracking input, as read by GestureNodes.
+
+	A HandFrame holds a fixed number of hands, each with a fixed number of
+	fingers, in one contiguous block: there are no handles or pointers to
+	follow, copying one is a memcpy, and nothing is allocated to read it.
+	Every type here is plain data with a fixed layout, so frames can be
+	stored and read back as raw bytes.
+
+	Positions are in millimeters and velocities in millimeters per second,
+	in the tracking device's coordinate system. See leapframe.h to convert
+	from a Leap::Frame.
+*/
+
+struct Vector3 {
+	float x, y, z;
+
+	float magnitude() const {
+		return std::sqrt(x * x + y * y + z * z);
+	}
+};
+
+struct FingerData {
+	int32_t id;
+	Vector3 tipPosition;
+	Vector3 tipVelocity;
+};
+
+struct HandData {
+	static const int MAX_FINGERS = 5;
+
+	int32_t id;
+	Vector3 palmPosition;
+	Vector3 palmVelocity;
+	Vector3 palmNormal;
+
+	// Only the first fingerCount fingers are meaningful
+	int32_t fingerCount;
+	FingerData fingers[MAX_FINGERS];
+
+	/**
+	  Returns the finger with the given ID, or null if the hand has no such
+	  finger.
+	*/
+	const FingerData* findFinger(int32_t fingerId) const {
+		for (int f = 0; f < fingerCount; ++f) {
+			if (fingers[f].id == fingerId)
+				return &fingers[f];
+		}
+		return NULL;
+	}
+};
+
+struct HandFrame {
+	static const int MAX_HANDS = 4;
+
+	// Frame ID, increasing from frame to frame; -1 for an invalid frame
+	int64_t id;
+
+	// Time the frame was captured, in microseconds
+	int64_t timestamp;
+
+	// Only the first handCount hands are meaningful
+	int32_t handCount;
+	int32_t reserved;
+	HandData hands[MAX_HANDS];
+
+	bool isValid() const {
+		return id >= 0;
+	}
+
+	/**
+	  Returns the hand with the given ID, or null if the frame has no such
+	  hand.
+	*/
+	const HandData* findHand(int32_t handId) const {
+		for (int i = 0; i < handCount; ++i) {
+			if (hands[i].id == handId)
+				return &hands[i];
+		}
+		return NULL;
+	}
+
+	/**
+	  Make this an invalid frame with no hands.
+	*/
+	void clear() {
+		id = -1;
+		timestamp = 0;
+		handCount = 0;
+		reserved = 0;
+	}
+};
+
+#endif
@@ -0,0 +1,127 @@
+/*
+	Philip Romano
+	10/16/2026
+	handmotion.h
+*/
+
+#ifndef HANDMOTION_H
+#define HANDMOTION_H
+
+#include <stdint.h>
+
+#include "handframe.h"
+#include "velocityfilter.h"
+
+/**
+	Follows one hand from frame to frame and smooths its velocity; this is
+	the feature that the demo graphs' nodes read.
+
+	When a frame holds exactly one hand, with at least the minimum number of
+	fingers, that hand is the main hand. Its velocity for the frame (see
+	getRawVelocity()) is smoothed by a VelocityFilter, along with its palm
+	position: by default, the mean over the last few frames. Any other
+	frame loses the main hand and restarts the smoothing from zero.
+
+	The box and EMA filters count frames, not time: feed them frames at a
+	fixed rate (see FrameResampler) for them to cover the same time at any
+	device rate.
+*/
+class HandMotion {
+	public:
+		/**
+		  smoothing : number of frames to average the velocity over
+		  minFingers : fewest fingers a hand needs to be followed
+		*/
+		HandMotion(int smoothing = 3, int minFingers = 0);
+
+		/**
+		  Smooth the velocity with filter instead (its state is not used).
+		*/
+		HandMotion(const VelocityFilter& filter, int minFingers = 0);
+
+		/**
+		  Smooth the velocity with filter from now on, and reset.
+		*/
+		void setFilter(const VelocityFilter& filter);
+
+		const VelocityFilter& getFilter() const;
+
+		int getMinFingers() const;
+
+		/**
+		  Follow the hand into the next frame. Nothing is allocated.
+		*/
+		void update(const HandFrame& frame);
+
+		/**
+		  As update(), with the raw velocity of the frame's first hand
+		  already computed (see getRawVelocity() and HandBlock).
+		*/
+		void update(const HandFrame& frame, const Vector3& rawVelocity);
+
+		/**
+		  Follow hand as the main hand of a frame taken at timestamp,
+		  whatever other hands the frame holds, so that each hand of a
+		  frame can be followed by a HandMotion of its own (see
+		  HandTrackSet). A null hand, or one with too few fingers, loses
+		  the main hand.
+		*/
+		void update(const HandData *hand, int64_t timestamp);
+
+		/**
+		  Forget the main hand and restart the smoothing.
+		*/
+		void reset();
+
+		bool hasHand() const;
+
+		/**
+		  Returns the main hand as of the last frame. Only meaningful if
+		  hasHand().
+		*/
+		const HandData& getHand() const;
+
+		/**
+		  Returns the smoothed velocity of the main hand, in millimeters per
+		  second; zero if there is no main hand.
+		*/
+		const Vector3& getVelocity() const;
+
+		/**
+		  Returns the palm position of the main hand at the last frame's
+		  timestamp, as the filter estimates it (see
+		  VelocityFilter::getPosition()); zero if there is no main hand.
+		*/
+		const Vector3& getPosition() const;
+
+		/**
+		  Returns the magnitude of the smoothed velocity in the x-y plane.
+		*/
+		float getXYSpeed() const;
+
+		/**
+		  Returns the velocity of hand for one frame, before smoothing: the
+		  mean of its fingertip velocities averaged with its palm velocity,
+		  or just the palm velocity if it has no fingers.
+		*/
+		static Vector3 getRawVelocity(const HandData& hand);
+
+	private:
+		int mMinFingers;
+
+		VelocityFilter mFilter;
+
+		bool mHasHand;
+		HandData mHand;
+		Vector3 mVelocity;
+		float mXYSpeed;
+
+		/**
+		  Follow hand, whose raw velocity is rawVelocity, or lose the main
+		  hand if it is null or has too few fingers.
+		*/
+		void follow(const HandData *hand, const Vector3& rawVelocity,
+				int64_t timestamp);
+};
+
+#endif
@@ -0,0 +1,214 @@
+/*
+	Philip Romano
+	10/16/2026
+	handsynthesizer.h
+*/
+
+#ifndef HANDSYNTHESIZER_H
+#define HANDSYNTHESIZER_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "handframe.h"
+
+/**
+	Synthesizes HandFrames of scripted hand motion, for load and fuzz
+	testing gesture graphs without a device.
+
+	A script is a list of steps, each a motion held for a duration: a swipe
+	in one of six directions, a backtracking swipe (out and straight back
+	again, as the sw*Backtrack nodes of the demo graphs expect), an idle
+	hand, or no hand at all. Frames are sampled from the script at a fixed
+	rate, optionally with noise on every velocity, randomly dropped hands,
+	and several hands following the script a little behind one another.
+
+	The output depends only on the script, the settings and the seed: the
+	random numbers come from a generator of our own, not <random>, so the
+	same seed gives the same frames on every platform. next() does not
+	allocate, and independent synthesizers can run on separate threads.
+*/
+class HandSynthesizer {
+	public:
+		enum Motion {
+			NONE = 0,    // No hand in view
+			IDLE,        // A hand held still
+			SWIPE_LEFT,  // -x
+			SWIPE_RIGHT, // +x
+			SWIPE_UP,    // +y
+			SWIPE_DOWN,  // -y
+			PUSH,        // -z, towards the screen
+			PULL,        // +z
+			BACKTRACK_LEFT,
+			BACKTRACK_RIGHT,
+			BACKTRACK_UP,
+			BACKTRACK_DOWN,
+			MOTIONS
+		};
+
+		struct Step {
+			Motion motion;
+
+			// Length of the step, in microseconds
+			int64_t duration;
+
+			// Peak speed of the hand, in millimeters per second
+			float speed;
+		};
+
+		/**
+		  rate : frames per second
+		  seed : seed for noise, dropouts and addRandomSteps()
+		*/
+		HandSynthesizer(double rate = 100.0, uint64_t seed = 1);
+
+		/**
+		  Standard deviation of the noise added to every palm and fingertip
+		  velocity, in millimeters per second. 0 (the default) for none.
+		*/
+		void setNoise(float noise);
+
+		/**
+		  Probability that a frame loses all of its hands, as when tracking
+		  drops out. 0 by default.
+		*/
+		void setDropout(double probability);
+
+		/**
+		  Number of hands, from 1 (the default) to HandFrame::MAX_HANDS. Each
+		  hand follows the script 150 ms behind the one before it.
+		*/
+		void setHands(int hands);
+
+		/**
+		  Number of fingers on each hand, from 0 to HandData::MAX_FINGERS.
+		  4 by default.
+		*/
+		void setFingers(int fingers);
+
+		/**
+		  Append a step to the script. duration is in microseconds, speed in
+		  millimeters per second.
+		*/
+		void addStep(Motion motion, int64_t duration, float speed = 800.0f);
+
+		/**
+		  Append count random gestures, each followed by an idle hand or
+		  (now and then) by no hand at all.
+		*/
+		void addRandomSteps(int count);
+
+		const std::vector<Step>& getSteps() const;
+
+		/**
+		  Empty the script and start again from the first frame.
+		*/
+		void clear();
+
+		/**
+		  Start again from the first frame, with the same random numbers.
+		*/
+		void rewind();
+
+		/**
+		  Returns the length of the script in microseconds, including the
+		  delay of the last hand.
+		*/
+		int64_t getDuration() const;
+
+		/**
+		  Returns the number of frames that the script produces.
+		*/
+		int64_t getFrameCount() const;
+
+		/**
+		  Write the next frame of the script into frame.
+
+		  Returns true if a frame was written; false once the script is over
+		*/
+		bool next(HandFrame& frame);
+
+		/**
+		  Returns the name of motion, as used in scripts ("left",
+		  "backtrack-up", "idle"...).
+		*/
+		static const char* getMotionName(Motion motion);
+
+		/**
+		  Look up a motion by the name that getMotionName() gives it.
+
+		  Returns true if name names a motion; false otherwise
+		*/
+		static bool parseMotion(const std::string& name, Motion& motion);
+
+	private:
+		// How far each hand runs behind the one before it
+		static const int64_t HAND_DELAY = 150000;
+
+		struct HandState {
+			// Step the hand is in
+			int step;
+
+			// Hand ID, renewed each time the hand comes back into view
+			int32_t id;
+			bool present;
+
+			Vector3 position;
+		};
+
+		double mRate;
+		uint64_t mSeed;
+		uint64_t mRandom;
+
+		float mNoise;
+		double mDropout;
+		int mHands;
+		int mFingers;
+
+		std::vector<Step> mSteps;
+
+		// Start time of each step in mSteps, then the end of the script
+		std::vector<int64_t> mStarts;
+
+		int64_t mFrame;
+		int32_t mNextId;
+		HandState mState[HandFrame::MAX_HANDS];
+
+		/**
+		  Returns the velocity of a hand partway (0 <= t < 1) through step.
+		*/
+		static Vector3 getVelocity(const Step& step, double t);
+
+		/**
+		  Returns the timestamp of the given frame, in microseconds.
+		*/
+		int64_t getTime(int64_t frame) const;
+
+		/**
+		  Move hand h on to time (in the hand's own script time, in
+		  microseconds), and fill in hand with it.
+
+		  Returns true if the hand is in view; false otherwise
+		*/
+		bool synthesize(int h, int64_t time, HandData& hand);
+
+		/**
+		  Returns the next 64 random bits from the random number generator
+		  with the given state.
+		*/
+		static uint64_t random(uint64_t& state);
+
+		/**
+		  Returns a uniformly distributed number in [0, 1).
+		*/
+		static double uniform(uint64_t& state);
+
+		/**
+		  Returns a roughly normally distributed number with mean 0 and
+		  standard deviation 1, within +-3.5.
+		*/
+		static double gaussian(uint64_t& state);
+};
+
+#endif
@@ -0,0 +1,144 @@
+/*
+	Philip Romano
+	10/16/2026
+	handtrackset.h
+*/
+
+#ifndef HANDTRACKSET_H
+#define HANDTRACKSET_H
+
+#include <vector>
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include "handframe.h"
+#include "featureframe.h"
+#include "handmotion.h"
+#include "compiledgesturegraph.h"
+#include "gesturesession.h"
+
+/**
+	Follows every hand in view through its own session of one gesture
+	graph, so that two hands, or several users, each make gestures without
+	a graph, or a process, per hand.
+
+	Each hand gets a track, keyed by its ID: a HandMotion following it, the
+	FeatureFrame the hand's session was last fed, and a session of the
+	graph (session i of getSessions() is track i). A track's FeatureFrame
+	is the whole frame, as seen from its hand: the hand is the main hand,
+	as FeatureExtractor would make a lone hand, so the nodes written for
+	one hand read each hand the same way.
+
+	A hand that appears takes a free track, starting from rest at the
+	graph's start node. A hand that leaves has its track fed the frame it
+	left in, without it, so that its session takes the graph's exits for a
+	lost hand; then the track is freed. Hands that find no free track are
+	not followed (see getDropped()).
+
+	The tracks are kept in one block, and every frame advances them in a
+	single pass over it, in track order. Nothing is allocated after
+	construction.
+
+	  HandTrackSet tracks(graph.compile(), extractor);
+	  tracks.update(frame);
+	  const FeatureFrame& features = tracks.getFeatures(0);
+*/
+class HandTrackSet {
+	public:
+		/**
+		  Follow up to capacity hands through sessions of graph, each as
+		  extractor follows its main hand: with a copy of its HandMotion
+		  (its state is not used), and its declared features.
+		*/
+		HandTrackSet(boost::shared_ptr<const CompiledGestureGraph> graph,
+				const FeatureExtractor& extractor = FeatureExtractor(),
+				int capacity = HandFrame::MAX_HANDS);
+
+		/**
+		  Declare features (FeatureFrame::Feature flags, or'ed) as read
+		  from now on, as FeatureExtractor::require().
+		*/
+		void require(uint32_t features);
+
+		uint32_t getRequired() const;
+
+		/**
+		  Match each hand of frame to its track, and advance every track's
+		  session. Invalid frames are ignored.
+		*/
+		void update(const HandFrame& frame);
+
+		/**
+		  Free every track, and move every session back to the start node
+		  without calling any callbacks.
+		*/
+		void reset();
+
+		int getCapacity() const;
+
+		/**
+		  Returns the number of tracks following a hand.
+		*/
+		int getTrackCount() const;
+
+		/**
+		  Returns true if track i is following a hand; false otherwise
+		*/
+		bool isActive(int i) const;
+
+		/**
+		  Returns the ID of the hand track i follows, or last followed.
+		*/
+		int32_t getHandId(int i) const;
+
+		/**
+		  Returns the track following the hand with the given ID, or -1 if
+		  there is none.
+		*/
+		int findTrack(int32_t handId) const;
+
+		/**
+		  Returns the frame that track i's session was last fed.
+		*/
+		const FeatureFrame& getFeatures(int i) const;
+
+		GestureSession getSession(int i);
+
+		/**
+		  Returns the sessions, to set a trace, profile or latency recorder
+		  on; their tags are the track indices.
+		*/
+		GestureSessionSet& getSessions();
+
+		/**
+		  Returns the number of times a hand found no free track.
+		*/
+		int64_t getDropped() const;
+
+	private:
+		struct Track {
+			bool active;
+			int32_t handId;
+			HandMotion motion;
+			FeatureFrame features;
+
+			// Index of the track's hand in the frame being processed, or
+			// -1 if it is not in it
+			int hand;
+		};
+
+		std::vector<Track> mTracks;
+		GestureSessionSet mSessions;
+
+		uint32_t mRequired;
+		int64_t mDropped;
+
+		/**
+		  Feed track i frame, with hand as its main hand (null if it has
+		  none).
+		*/
+		void step(int i, const HandFrame& frame, const HandData *hand);
+};
+
+#endif
@@ -0,0 +1,30 @@
+/*
+	Philip Romano
+	10/16/2026
+	leapframe.h
+*/
+
+#ifndef LEAPFRAME_H
+#define LEAPFRAME_H
+
+#include <Leap.h>
+
+#include "handframe.h"
+
+/**
+	Adapter from the Leap Motion SDK to HandFrame. This is the only part of
+	the gesture graph library that needs Leap.h.
+*/
+
+Vector3 toVector3(const Leap::Vector& vector);
+
+/**
+  Copy the hands and fingers of a Leap::Frame into out. Hands and fingers
+  beyond HandFrame's capacity are dropped, in the order the SDK lists them.
+  An invalid frame becomes an invalid HandFrame (id -1) with no hands.
+
+  out is overwritten in place; nothing is allocated.
+*/
+void toHandFrame(const Leap::Frame& frame, HandFrame& out);
+
+#endif
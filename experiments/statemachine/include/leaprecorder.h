@@ -0,0 +1,46 @@
+/*
+	Philip Romano
+	10/16/2026
+	leaprecorder.h
+*/
+
+#ifndef LEAPRECORDER_H
+#define LEAPRECORDER_H
+
+#include <string>
+#include <stdint.h>
+
+#include <Leap.h>
+
+#include "framelog.h"
+
+/**
+	Records every frame from a Leap::Controller to a frame log (see
+	framelog.h).
+
+	onFrame() converts the frame straight into the writer's ring, so the
+	SDK's callback thread never allocates or waits on the disk. Attach with
+	controller.addListener() after open(), and remove before close().
+*/
+class LeapRecorder : public Leap::Listener {
+	public:
+		/**
+		  capacity is the number of frames that may be waiting to be
+		  written; see FrameLogWriter.
+		*/
+		LeapRecorder(int capacity = 4096);
+
+		bool open(const std::string& filename);
+		bool close();
+
+		uint64_t getWritten() const;
+		uint64_t getLost() const;
+		uint64_t getDropped() const;
+
+		virtual void onFrame(const Leap::Controller& controller);
+
+	private:
+		FrameLogWriter mWriter;
+};
+
+#endif
@@ -0,0 +1,354 @@
+/*
+	Philip Romano
+	10/16/2026
+	velocityfilter.h
+*/
+
+#ifndef VELOCITYFILTER_H
+#define VELOCITYFILTER_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "handframe.h"
+
+/**
+	The running sum behind BoxFilter and VelocityFilter's BOX: the mean of
+	a window of vectors, held in a ring by the owner, updated by adding the
+	newest vector and taking away the one it replaces. Each update costs
+	the same whatever the window.
+
+	The sum is kept in double, so that adding and taking away the same
+	values does not drift over a long session.
+*/
+class BoxSum {
+	public:
+		BoxSum() {
+			reset();
+		}
+
+		/**
+		  Start from rest. The owner refills its ring with zero vectors.
+		*/
+		void reset() {
+			mSum[0] = mSum[1] = mSum[2] = 0.0;
+			mNext = 0;
+			mMean.x = mMean.y = mMean.z = 0.0f;
+		}
+
+		/**
+		  Replace the oldest of the size vectors of window with v, and
+		  return the mean of the window.
+		*/
+		const Vector3& update(Vector3 *window, int size, const Vector3& v) {
+			Vector3& oldest = window[mNext];
+			mSum[0] += (double)v.x - oldest.x;
+			mSum[1] += (double)v.y - oldest.y;
+			mSum[2] += (double)v.z - oldest.z;
+			oldest = v;
+			if (++mNext == size)
+				mNext = 0;
+
+			mMean.x = (float)(mSum[0] / size);
+			mMean.y = (float)(mSum[1] / size);
+			mMean.z = (float)(mSum[2] / size);
+			return mMean;
+		}
+
+		/**
+		  As update(), for a window of N vectors known when compiling: the
+		  wrap and the division are by a constant.
+		*/
+		template <int N>
+		const Vector3& update(Vector3 *window, const Vector3& v) {
+			return update(window, N, v);
+		}
+
+		const Vector3& get() const {
+			return mMean;
+		}
+
+	private:
+		double mSum[3];
+		int mNext;
+		Vector3 mMean;
+};
+
+/**
+	Mean of the last N vectors, kept as a running sum (see BoxSum). Starts
+	from rest, as if N zero vectors had come before the first.
+*/
+template <int N>
+class BoxFilter {
+	public:
+		BoxFilter() {
+			reset();
+		}
+
+		/**
+		  Add v, and return the mean of it and the N - 1 vectors before it.
+		*/
+		const Vector3& update(const Vector3& v) {
+			return mSum.update<N>(mWindow, v);
+		}
+
+		void reset() {
+			for (int i = 0; i < N; ++i)
+				mWindow[i].x = mWindow[i].y = mWindow[i].z = 0.0f;
+			mSum.reset();
+		}
+
+		const Vector3& get() const {
+			return mSum.get();
+		}
+
+	private:
+		Vector3 mWindow[N];
+		BoxSum mSum;
+};
+
+/**
+	Smooths a stream of velocities with one of four filters, chosen at run
+	time:
+
+	  BOX       Mean of the last window vectors (as BoxFilter, with the
+	            window set at run time; windows of 2 to 5 frames take
+	            BoxFilter's fixed-size path). Even weighting; lags by half
+	            the window.
+	  EMA       Exponential moving average: each output moves a fraction
+	            alpha of the way to the input. Counts frames, like BOX.
+	  ONE_EURO  The 1-euro filter (Casiez et al., 2012): an exponential
+	            average whose cutoff frequency rises with the rate of
+	            change, so that a hand held still is smoothed hard and a
+	            swipe is followed closely. Uses the frame timestamps.
+	  KALMAN    A constant-acceleration Kalman filter: estimates the
+	            hand's position, velocity and acceleration, and carries
+	            them forward to each frame's timestamp before correcting
+	            them with the frame's measurements. A velocity that
+	            changes steadily is followed without the lag of an
+	            average: by default, no noisier than a 3-frame BOX on a
+	            hand held still, it reaches a fast swipe's speed about a
+	            frame sooner. Uses the frame timestamps.
+
+	Given the palm position too, every filter keeps it (see
+	getPosition()); KALMAN corrects its position with it, and returns its
+	estimate of where the palm is at the frame's timestamp. Given none,
+	KALMAN's position is how far the hand moved since the filter started.
+
+	Every filter starts from rest, as if the hand had been still: the
+	demo graphs reset the filter when they lose the hand, and a hand that
+	appears is taken to have just started moving. Each update costs the
+	same whatever the settings, and nothing is allocated after
+	construction, or after the window is set.
+
+	  VelocityFilter filter(VelocityFilter::ONE_EURO);
+	  const Vector3& smoothed = filter.update(velocity, frame.timestamp);
+*/
+class VelocityFilter {
+	public:
+		enum Kind {
+			BOX,
+			EMA,
+			ONE_EURO,
+			KALMAN
+		};
+
+		/**
+		  A filter of the given kind with its default settings: a window of
+		  3 frames, alpha of 0.5, a minimum cutoff of 1 Hz and beta of
+		  0.002 (see setOneEuro()), or a jerk of 5000 with noise of 40
+		  mm/s and 5 mm (see setKalman()).
+		*/
+		VelocityFilter(Kind kind = BOX);
+
+		/**
+		  A box filter over the last window frames.
+		*/
+		VelocityFilter(int window);
+
+		/**
+		  Switch to a box filter over the last window frames, and reset.
+		*/
+		void setBox(int window);
+
+		/**
+		  Switch to an exponential moving average that moves alpha (0 to 1)
+		  of the way to each input, and reset.
+		*/
+		void setEma(float alpha);
+
+		/**
+		  Switch to a 1-euro filter, and reset.
+
+		  minCutoff : cutoff frequency, in Hz, for a hand at rest
+		  beta : how much the cutoff rises per mm/s^2 of change in the
+		         velocity
+		  derivativeCutoff : cutoff frequency, in Hz, of the rate of change
+		*/
+		void setOneEuro(float minCutoff, float beta,
+				float derivativeCutoff = 1.0f);
+
+		/**
+		  Switch to a constant-acceleration Kalman filter, and reset.
+
+		  jerk : how quickly the acceleration is expected to change, in
+		         mm/s^3 per square root of Hz; higher follows changes more
+		         closely and smooths less
+		  velocityNoise : standard deviation of the measured velocity,
+		         in mm/s
+		  positionNoise : standard deviation of the measured position,
+		         in mm
+		*/
+		void setKalman(float jerk, float velocityNoise,
+				float positionNoise);
+
+		/**
+		  Filter the next velocity, taken at timestamp (microseconds;
+		  ONE_EURO and KALMAN use it), and return the smoothed velocity.
+		*/
+		const Vector3& update(const Vector3& velocity, int64_t timestamp);
+
+		/**
+		  As update(), with the palm position measured at timestamp too.
+		*/
+		const Vector3& update(const Vector3& velocity, const Vector3& position,
+				int64_t timestamp);
+
+		/**
+		  Forget the input so far; the next update starts from rest.
+		*/
+		void reset();
+
+		/**
+		  Returns the latest smoothed velocity; zero after reset().
+		*/
+		const Vector3& get() const;
+
+		/**
+		  Returns the palm position as of the latest update: KALMAN's
+		  estimate, or the position given to the others (zero if none was).
+		*/
+		const Vector3& getPosition() const;
+
+		Kind getKind() const;
+
+		/**
+		  Set filter from a description of the form kind[:settings], where
+		  kind is "box", "ema", "euro" or "kalman", and the settings are the
+		  arguments of setBox(), setEma(), setOneEuro() or setKalman(),
+		  separated by commas; any left out keep their defaults. For
+		  example "box:5", "ema:0.3", "euro:1,0.002" or "kalman:5000,40".
+
+		  Returns true if the description was understood; false otherwise
+		  (filter is unchanged)
+		*/
+		static bool parse(const std::string& description,
+				VelocityFilter& filter);
+
+	private:
+		Kind mKind;
+
+		// BOX: the window, as a ring, and its running sum
+		std::vector<Vector3> mWindow;
+		BoxSum mBox;
+
+		// EMA
+		float mAlpha;
+
+		// ONE_EURO: settings, the smoothed rate of change, and the time of
+		// the last input (KALMAN's too)
+		float mMinCutoff;
+		float mBeta;
+		float mDerivativeCutoff;
+		Vector3 mDerivative;
+		int64_t mLastTime;
+
+		// KALMAN: settings; position, velocity and acceleration, by axis;
+		// and their covariance, which is the same for every axis
+		float mJerk;
+		float mVelocityNoise;
+		float mPositionNoise;
+		double mState[3][3];
+		double mCovariance[3][3];
+
+		Vector3 mValue;
+		Vector3 mPosition;
+
+		const Vector3& filter(const Vector3& velocity,
+				const Vector3 *position, int64_t timestamp);
+
+		/**
+		  Carry the KALMAN estimate forward by step seconds.
+		*/
+		void predict(double step);
+
+		/**
+		  Correct the KALMAN estimate with a measurement, by axis, of
+		  element m of the state, with the given variance.
+		*/
+		void correct(int m, const double *measured, double variance);
+};
+
+/**
+	A filter per hand, for every hand of a frame at once. Each hand is
+	matched by ID to the hand it was in the frame before: a hand that
+	stays keeps its filter, a hand that appears starts one from rest, and
+	a hand that leaves is forgotten. The velocity filtered is each hand's
+	raw velocity, as HandMotion defines it.
+
+	  bank.update(frame);
+	  const Vector3 *velocity = bank.findVelocity(hand.id);
+*/
+class VelocityFilterBank {
+	public:
+		/**
+		  Every hand is filtered as filter is set up (its state is not
+		  used).
+		*/
+		VelocityFilterBank(const VelocityFilter& filter = VelocityFilter());
+
+		/**
+		  Filter every hand of frame. Invalid frames are ignored.
+		*/
+		void update(const HandFrame& frame);
+
+		/**
+		  Forget every hand.
+		*/
+		void reset();
+
+		/**
+		  Returns the number of hands in the last frame.
+		*/
+		int getHandCount() const;
+
+		/**
+		  Returns the ID of hand i of the last frame, in the frame's order.
+		*/
+		int32_t getHandId(int i) const;
+
+		/**
+		  Returns the smoothed velocity of hand i of the last frame.
+		*/
+		const Vector3& getVelocity(int i) const;
+
+		/**
+		  Returns the smoothed velocity of the hand with the given ID, or
+		  null if the last frame has no such hand.
+		*/
+		const Vector3* findVelocity(int32_t handId) const;
+
+	private:
+		// How each new hand is filtered
+		VelocityFilter mPrototype;
+
+		// Filters of the hands of the last frame, in the frame's order, and
+		// spares for the update in progress
+		std::vector<VelocityFilter> mFilters;
+		std::vector<VelocityFilter> mNext;
+		int32_t mIds[HandFrame::MAX_HANDS];
+		int mCount;
+};
+
+#endif
@@ -0,0 +1,121 @@
+/*
+	Philip Romano
+	10/16/2026
+	workpool.h
+*/
+
+#ifndef WORKPOOL_H
+#define WORKPOOL_H
+
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdint.h>
+
+#include <boost/function.hpp>
+
+/**
+	A fixed set of worker threads that run tasks, for spreading coarse,
+	independent jobs (such as replaying one recording each) across cores.
+
+	Each worker has a deque of its own. Tasks submitted from outside the
+	pool are dealt out to the workers in turn; tasks submitted by a task
+	go onto its own worker's deque. A worker takes the newest task from its
+	own deque, and when that is empty, steals the oldest task from another
+	worker's, so that a few long tasks do not leave the other workers idle.
+
+	Tasks may run in any order and on any worker. Anything that must be
+	deterministic (such as merged results) should be written to a slot set
+	aside for the task, and combined in order after wait().
+*/
+class WorkPool {
+	public:
+		typedef boost::function<void()> Task;
+
+		/**
+		  Start the given number of worker threads, or one per core if
+		  threads is 0.
+		*/
+		WorkPool(int threads = 0);
+
+		/**
+		  Waits for every task submitted, then stops the workers.
+		*/
+		~WorkPool();
+
+		/**
+		  Queue task to be run by a worker. May be called from any thread,
+		  including from a task.
+		*/
+		void submit(const Task& task);
+
+		/**
+		  Block until every task submitted so far (and every task that they
+		  submit) has finished. Must not be called from a task.
+
+		  If any task threw an exception, the first one is rethrown here once
+		  the rest have finished
+		*/
+		void wait();
+
+		int getThreadCount() const;
+
+		/**
+		  Returns the number of tasks that were run by a worker other than
+		  the one they were queued on.
+		*/
+		uint64_t getStolen() const;
+
+	private:
+		struct Worker {
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		std::vector<Worker*> mWorkers;
+		std::vector<std::thread> mThreads;
+
+		// Tasks submitted but not yet finished, and tasks queued but not yet
+		// taken by a worker
+		std::atomic<int64_t> mPending;
+		std::atomic<int64_t> mQueued;
+		std::atomic<uint64_t> mStolen;
+		std::atomic<unsigned> mNext;
+		bool mStopping;
+
+		// Idle workers sleep on mWork; wait() sleeps on mDone
+		std::mutex mMutex;
+		std::condition_variable mWork;
+		std::condition_variable mDone;
+
+		std::exception_ptr mError;
+
+		/**
+		  Body of worker thread w.
+		*/
+		void run(int w);
+
+		/**
+		  Take a task for worker w: the newest from its own deque, or else
+		  the oldest from another worker's.
+
+		  Returns true if a task was taken; false if every deque was empty
+		*/
+		bool take(int w, Task& task);
+
+		/**
+		  Returns the index of the worker running on this thread, or -1 if
+		  this thread is not one of the pool's.
+		*/
+		int getCurrentWorker() const;
+
+		// Not copyable
+		WorkPool(const WorkPool&);
+		WorkPool& operator=(const WorkPool&);
+};
+
+#endif
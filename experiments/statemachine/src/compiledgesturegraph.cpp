@@ -0,0 +1,274 @@
+/*
+	Philip Romano
+	10/16/2026
+	compiledgesturegraph.cpp
+*/
+
+#include <string>
+#include <vector>
+#include <climits>
+
+#include <boost/shared_ptr.hpp>
+
+#include "compiledgesturegraph.h"
+#include "gesturestategraph.h"
+#include "gesturenode.h"
+#include "gesturetrace.h"
+#include "gestureprofile.h"
+#include "gesturelatency.h"
+#include "gesturememo.h"
+#include "handframe.h"
+
+CompiledGestureGraph::CompiledGestureGraph()
+		: mMemoSize(0), mReadsFeatures(false),
+		  mStart(GestureStateGraph::INVALID_NODE),
+		  mMaxDecisionChain(0), mMaxSteps(0) {
+
+}
+
+CompiledGestureGraph::NodeHandle CompiledGestureGraph::advance(
+		const HandFrame& frame, NodeHandle current, char *states,
+		GestureMemo *memo, GestureTrace *trace, GestureProfile *profile,
+		int session, GestureLatency *latency) const {
+	if (current < 0 || current >= getNodeCount())
+		return current;
+
+	// Memoized results are only trusted for frames that have an ID
+	int64_t frameId = 0;
+	if (memo) {
+		if (frame.isValid())
+			frameId = frame.id;
+		else
+			memo = NULL;
+	}
+
+	NodeHandle newCurrent = current;
+	int slot = -1;
+	int steps = 0;
+	do {
+		if (newCurrent != current) {
+			if (trace)
+				trace->record(frame.timestamp, current, newCurrent, slot,
+						session);
+			transition(frame, current, newCurrent, states, latency,
+					session);
+			current = newCurrent;
+		}
+
+		// Safety net; validate() guarantees no decision-only cycles, but a
+		// cycle through state nodes could still be followed indefinitely
+		if (steps++ >= mMaxSteps)
+			break;
+
+		GestureNode *node = mNodeTypes[current];
+		int memoIndex = mMemoIndex[current];
+		if (node && memo && memoIndex >= 0
+				&& memo->lookup(memoIndex, frameId, slot))
+			newCurrent = getSlot(current, slot);
+		else if (node) {
+			if (profile) {
+				int64_t start = GestureProfile::now();
+				slot = node->evaluate(frame, mNodeIds[current],
+						getState(states, current));
+				profile->record(current, slot,
+						GestureProfile::now() - start);
+			} else
+				slot = node->evaluate(frame, mNodeIds[current],
+						getState(states, current));
+			if (memo && memoIndex >= 0)
+				memo->store(memoIndex, frameId, slot);
+			newCurrent = getSlot(current, slot);
+		} else
+			newCurrent = GestureStateGraph::INVALID_NODE;
+	} while (newCurrent != current
+			&& newCurrent != GestureStateGraph::INVALID_NODE);
+
+	// With no start node to reset to, stay at the last node reached
+	if (newCurrent == GestureStateGraph::INVALID_NODE
+			&& mStart != GestureStateGraph::INVALID_NODE) {
+		if (trace)
+			trace->record(frame.timestamp, current, mStart, slot, session);
+		transition(frame, current, mStart, states, latency, session);
+		current = mStart;
+	}
+
+	return current;
+}
+
+CompiledGestureGraph::NodeHandle CompiledGestureGraph::getStart() const {
+	return mStart;
+}
+
+int CompiledGestureGraph::getNodeCount() const {
+	return mNodeTypes.size();
+}
+
+const std::string& CompiledGestureGraph::getNodeId(NodeHandle node) const {
+	static const std::string none;
+	if (node >= 0 && node < getNodeCount())
+		return mNodeIds[node];
+	else
+		return none;
+}
+
+GestureNode* CompiledGestureGraph::getNodeType(NodeHandle node) const {
+	if (node >= 0 && node < getNodeCount())
+		return mNodeTypes[node];
+	else
+		return NULL;
+}
+
+bool CompiledGestureGraph::isStateNode(NodeHandle node) const {
+	return mStateNodes[node];
+}
+
+int CompiledGestureGraph::getMaxDecisionChain() const {
+	return mMaxDecisionChain;
+}
+
+int CompiledGestureGraph::getMaxSteps() const {
+	return mMaxSteps;
+}
+
+int CompiledGestureGraph::getMemoSize() const {
+	return mMemoSize;
+}
+
+bool CompiledGestureGraph::readsFeatures() const {
+	return mReadsFeatures;
+}
+
+int CompiledGestureGraph::getStateSize() const {
+	return mInitialState.size();
+}
+
+const char* CompiledGestureGraph::getInitialState() const {
+	if (mInitialState.empty())
+		return NULL;
+	else
+		return &mInitialState[0];
+}
+
+int CompiledGestureGraph::alignState(int offset) {
+	// Enough for any of the plain data types a state block may hold
+	const int alignment = 16;
+	return (offset + alignment - 1) / alignment * alignment;
+}
+
+
+/*
+   Private member functions
+*/
+
+void CompiledGestureGraph::validate() {
+	int count = getNodeCount();
+
+	// A state node has at least one slot that leads back to itself
+	int stateCount = 0;
+	mStateNodes.assign(count, false);
+	for (NodeHandle n = 0; n < count; ++n) {
+		for (int i = mSlotOffsets[n]; i < mSlotOffsets[n + 1]; ++i) {
+			if (mSlotTargets[i] == n) {
+				mStateNodes[n] = true;
+				++stateCount;
+				break;
+			}
+		}
+	}
+
+	// Depth-first search over the decision nodes only. A back edge is a
+	// decision-only cycle; otherwise the subgraph is acyclic and chain[n]
+	// is the length of the longest decision path starting at n.
+	enum { UNVISITED, ACTIVE, DONE };
+	std::vector<int> color(count, UNVISITED);
+	std::vector<int> chain(count, 0);
+	std::vector< std::pair<NodeHandle,int> > stack;
+
+	mMaxDecisionChain = 0;
+	for (NodeHandle root = 0; root < count; ++root) {
+		if (mStateNodes[root] || color[root] != UNVISITED)
+			continue;
+
+		color[root] = ACTIVE;
+		stack.push_back(std::make_pair(root, mSlotOffsets[root]));
+		while (!stack.empty()) {
+			NodeHandle n = stack.back().first;
+			int& edge = stack.back().second;
+
+			if (edge == mSlotOffsets[n + 1]) {
+				chain[n] += 1;
+				if (chain[n] > mMaxDecisionChain)
+					mMaxDecisionChain = chain[n];
+				color[n] = DONE;
+				stack.pop_back();
+				if (!stack.empty()) {
+					NodeHandle parent = stack.back().first;
+					if (chain[n] > chain[parent])
+						chain[parent] = chain[n];
+				}
+				continue;
+			}
+
+			NodeHandle next = mSlotTargets[edge++];
+			if (next == GestureStateGraph::INVALID_NODE || mStateNodes[next])
+				continue;
+
+			if (color[next] == ACTIVE) {
+				std::string message("Decision-only cycle: ");
+				unsigned int i = 0;
+				while (stack[i].first != next)
+					++i;
+				for (; i < stack.size(); ++i) {
+					message.append(mNodeIds[stack[i].first]);
+					message.append(" -> ");
+				}
+				message.append(mNodeIds[next]);
+				throw GestureStateException(message);
+			} else if (color[next] == DONE) {
+				if (chain[next] > chain[n])
+					chain[n] = chain[next];
+			} else {
+				color[next] = ACTIVE;
+				stack.push_back(std::make_pair(next, mSlotOffsets[next]));
+			}
+		}
+	}
+
+	// Every state node may be passed through at most once per frame, with
+	// at most one full decision chain leading into it
+	long long steps = (long long)(stateCount + 1) * (mMaxDecisionChain + 1);
+	mMaxSteps = (steps > INT_MAX) ? INT_MAX : (int)steps;
+}
+
+CompiledGestureGraph::NodeHandle CompiledGestureGraph::getSlot(
+		NodeHandle node, int slot) const {
+	if (slot >= 0 && slot < mSlotOffsets[node + 1] - mSlotOffsets[node])
+		return mSlotTargets[mSlotOffsets[node] + slot];
+	else
+		return GestureStateGraph::INVALID_NODE;
+}
+
+void* CompiledGestureGraph::getState(char *states, NodeHandle node) const {
+	if (mStateOffsets[node] < 0)
+		return NULL;
+	else
+		return states + mStateOffsets[node];
+}
+
+void CompiledGestureGraph::transition(const HandFrame& frame,
+		NodeHandle from, NodeHandle to, char *states, GestureLatency *latency,
+		int session) const {
+	if (mNodeTypes[from])
+		mNodeTypes[from]->onLeave(frame, mNodeIds[from],
+				getState(states, from));
+	if (!mLeaveActions[from].empty())
+		mLeaveActions[from](frame);
+
+	if (mNodeTypes[to])
+		mNodeTypes[to]->onEnter(frame, mNodeIds[to], getState(states, to));
+	if (!mEnterActions[to].empty()) {
+		mEnterActions[to](frame);
+		if (latency)
+			latency->commit(to, frame, session);
+	}
+}
@@ -0,0 +1,21 @@
+/*
+	Philip Romano
+	10/16/2026
+	csv.cpp
+*/
+
+#include <ostream>
+#include <string>
+
+#include "csv.h"
+
+void writeCsvString(std::ostream& out, const std::string& value) {
+	out << '"';
+	for (std::string::const_iterator it = value.begin();
+			it != value.end(); ++it) {
+		if (*it == '"')
+			out << '"';
+		out << *it;
+	}
+	out << '"';
+}
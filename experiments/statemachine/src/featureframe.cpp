@@ -0,0 +1,85 @@
+/*
+	Philip Romano
+	10/16/2026
+	featureframe.cpp
+*/
+
+#include <cmath>
+#include <stdint.h>
+
+#include "featureframe.h"
+#include "handframe.h"
+#include "handmotion.h"
+#include "velocityfilter.h"
+
+namespace {
+	const Vector3 ZERO = { 0.0f, 0.0f, 0.0f };
+}
+
+FeatureExtractor::FeatureExtractor(int smoothing, int minFingers)
+		: mMotion(smoothing, minFingers), mRequired(0) {
+}
+
+void FeatureExtractor::require(uint32_t features) {
+	mRequired |= features & FeatureFrame::ALL;
+}
+
+uint32_t FeatureExtractor::getRequired() const {
+	return mRequired;
+}
+
+void FeatureExtractor::setFilter(const VelocityFilter& filter) {
+	mMotion.setFilter(filter);
+}
+
+void FeatureExtractor::extract(const HandFrame& frame,
+		FeatureFrame& features) {
+	static_cast<HandFrame&>(features) = frame;
+	mMotion.update(frame);
+
+	// HandMotion keeps the velocity zero while there is no main hand
+	writeFeatures(mMotion.hasHand() ? &mMotion.getHand() : NULL,
+			mMotion.getVelocity(), mMotion.getPosition(), mRequired,
+			features);
+}
+
+void FeatureExtractor::extract(const HandFrame& frame,
+		const Vector3& rawVelocity, FeatureFrame& features) {
+	static_cast<HandFrame&>(features) = frame;
+	mMotion.update(frame, rawVelocity);
+	writeFeatures(mMotion.hasHand() ? &mMotion.getHand() : NULL,
+			mMotion.getVelocity(), mMotion.getPosition(), mRequired,
+			features);
+}
+
+void FeatureExtractor::reset() {
+	mMotion.reset();
+}
+
+const HandMotion& FeatureExtractor::getMotion() const {
+	return mMotion;
+}
+
+void FeatureExtractor::writeFeatures(const HandData *hand,
+		const Vector3& velocity, const Vector3& position,
+		uint32_t required, FeatureFrame& features) {
+	features.features = required;
+	features.hasHand = (hand != NULL);
+	features.handId = hand ? hand->id : -1;
+	features.fingerCount = hand ? hand->fingerCount : 0;
+
+	if (required & FeatureFrame::VELOCITY)
+		features.velocity = velocity;
+	if (required & FeatureFrame::SPEED)
+		features.speed = velocity.magnitude();
+	if (required & FeatureFrame::XY_SPEED) {
+		features.xySpeed = std::sqrt(velocity.x * velocity.x
+				+ velocity.y * velocity.y);
+	}
+	if (required & FeatureFrame::PALM) {
+		features.palmPosition = hand ? hand->palmPosition : ZERO;
+		features.palmNormal = hand ? hand->palmNormal : ZERO;
+	}
+	if (required & FeatureFrame::POSITION)
+		features.position = hand ? position : ZERO;
+}
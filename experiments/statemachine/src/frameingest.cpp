@@ -0,0 +1,227 @@
+/*
+	Philip Romano
+	10/16/2026
+	frameingest.cpp
+*/
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <stdint.h>
+
+#include "frameingest.h"
+#include "handframe.h"
+
+namespace {
+	void add(Vector3& sum, const Vector3& v) {
+		sum.x += v.x;
+		sum.y += v.y;
+		sum.z += v.z;
+	}
+
+	void divide(Vector3& sum, int n) {
+		sum.x /= n;
+		sum.y /= n;
+		sum.z /= n;
+	}
+
+	/**
+	  Returns the steady clock's time in nanoseconds, for how long frames
+	  wait.
+	*/
+	int64_t now() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+FrameIngest::FrameIngest(Policy policy, int capacity)
+		: mPolicy(policy), mHead(0), mCount(0), mClosed(false) {
+	if (capacity < 1)
+		capacity = 1;
+	mFrames.resize(capacity);
+	mPushed.resize(capacity);
+
+	mStats.received = 0;
+	mStats.delivered = 0;
+	mStats.coalesced = 0;
+	mStats.dropped = 0;
+	mStats.maxPending = 0;
+	mStats.maxDelay = 0;
+}
+
+void FrameIngest::push(const HandFrame& frame) {
+	int64_t time = now();
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mClosed)
+			return;
+
+		++mStats.received;
+		if (mCount == (int)mFrames.size()) {
+			// Full: the oldest frame makes way
+			mHead = getSlot(1);
+			--mCount;
+			++mStats.dropped;
+		}
+
+		int slot = getSlot(mCount++);
+		mFrames[slot] = frame;
+		mPushed[slot] = time;
+		if (mCount > mStats.maxPending)
+			mStats.maxPending = mCount;
+	}
+	mReady.notify_one();
+}
+
+bool FrameIngest::pop(HandFrame& frame) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (mCount == 0)
+		return false;
+
+	int newest = getSlot(mCount - 1);
+	int64_t pushed;
+	switch (mPolicy) {
+		case LATEST:
+			frame = mFrames[newest];
+			pushed = mPushed[newest];
+			mStats.dropped += mCount - 1;
+			mCount = 0;
+			break;
+		case COALESCE:
+			coalesce(frame);
+			pushed = mPushed[newest];
+			mStats.coalesced += mCount - 1;
+			mCount = 0;
+			break;
+		default:
+			frame = mFrames[mHead];
+			pushed = mPushed[mHead];
+			mHead = getSlot(1);
+			--mCount;
+			break;
+	}
+	if (mCount == 0)
+		mHead = 0;
+
+	++mStats.delivered;
+	int64_t delay = now() - pushed;
+	if (delay > mStats.maxDelay)
+		mStats.maxDelay = delay;
+	return true;
+}
+
+bool FrameIngest::wait(int timeoutMs) {
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (timeoutMs < 0) {
+		while (mCount == 0 && !mClosed)
+			mReady.wait(lock);
+	} else {
+		std::chrono::steady_clock::time_point deadline =
+			std::chrono::steady_clock::now()
+			+ std::chrono::milliseconds(timeoutMs);
+		while (mCount == 0 && !mClosed) {
+			if (mReady.wait_until(lock, deadline)
+					== std::cv_status::timeout)
+				break;
+		}
+	}
+	return mCount > 0;
+}
+
+void FrameIngest::close() {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mClosed = true;
+	}
+	mReady.notify_all();
+}
+
+bool FrameIngest::isClosed() const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mClosed;
+}
+
+int FrameIngest::getPending() const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mCount;
+}
+
+IngestStats FrameIngest::getStats() const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mStats;
+}
+
+FrameIngest::Policy FrameIngest::getPolicy() const {
+	return mPolicy;
+}
+
+int FrameIngest::getCapacity() const {
+	return (int)mFrames.size();
+}
+
+const char* FrameIngest::getPolicyName(Policy policy) {
+	switch (policy) {
+		case LATEST:
+			return "latest";
+		case COALESCE:
+			return "coalesce";
+		default:
+			return "queue";
+	}
+}
+
+bool FrameIngest::parsePolicy(const std::string& name, Policy& policy) {
+	static const Policy POLICIES[] = { QUEUE, LATEST, COALESCE };
+	for (int p = 0; p < 3; ++p) {
+		if (name == getPolicyName(POLICIES[p])) {
+			policy = POLICIES[p];
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/*
+   Private member functions
+*/
+
+int FrameIngest::getSlot(int i) const {
+	return (mHead + i) % (int)mFrames.size();
+}
+
+void FrameIngest::coalesce(HandFrame& frame) const {
+	frame = mFrames[getSlot(mCount - 1)];
+
+	for (int h = 0; h < frame.handCount; ++h) {
+		HandData& hand = frame.hands[h];
+		int hands = 1;
+		int fingers[HandData::MAX_FINGERS];
+		for (int f = 0; f < hand.fingerCount; ++f)
+			fingers[f] = 1;
+
+		for (int i = 0; i < mCount - 1; ++i) {
+			const HandData *older = mFrames[getSlot(i)].findHand(hand.id);
+			if (!older)
+				continue;
+
+			add(hand.palmVelocity, older->palmVelocity);
+			++hands;
+			for (int f = 0; f < hand.fingerCount; ++f) {
+				const FingerData *finger = older->findFinger(
+						hand.fingers[f].id);
+				if (finger) {
+					add(hand.fingers[f].tipVelocity, finger->tipVelocity);
+					++fingers[f];
+				}
+			}
+		}
+
+		divide(hand.palmVelocity, hands);
+		for (int f = 0; f < hand.fingerCount; ++f)
+			divide(hand.fingers[f].tipVelocity, fingers[f]);
+	}
+}
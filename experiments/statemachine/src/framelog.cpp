@@ -0,0 +1,327 @@
+/*
+	Philip Romano
+	10/16/2026
+	framelog.cpp
+*/
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "framelog.h"
+#include "handframe.h"
+
+namespace {
+	const char MAGIC[8] = { 'H', 'A', 'N', 'D', 'L', 'O', 'G', '\0' };
+}
+
+/*
+   FrameLogHeader
+*/
+
+const uint32_t FrameLogHeader::VERSION;
+
+void FrameLogHeader::initialize() {
+	std::memset(this, 0, sizeof(*this));
+	std::memcpy(magic, MAGIC, sizeof(magic));
+	version = VERSION;
+	headerSize = sizeof(FrameLogHeader);
+	stride = sizeof(HandFrame);
+}
+
+bool FrameLogHeader::isCompatible() const {
+	return std::memcmp(magic, MAGIC, sizeof(magic)) == 0
+			&& version == VERSION
+			&& headerSize == sizeof(FrameLogHeader)
+			&& stride == sizeof(HandFrame);
+}
+
+
+/*
+   FrameLogWriter
+*/
+
+FrameLogWriter::FrameLogWriter(int capacity)
+		: mHead(0), mTail(0), mWritten(0), mLost(0), mDropped(0),
+		  mFailed(false), mFile(NULL), mRunning(false) {
+	int size = 1;
+	while (size < capacity)
+		size *= 2;
+	mRing.resize(size);
+	mMask = size - 1;
+}
+
+FrameLogWriter::~FrameLogWriter() {
+	close();
+}
+
+bool FrameLogWriter::open(const std::string& filename) {
+	if (mFile)
+		return false;
+
+	mFile = std::fopen(filename.c_str(), "wb");
+	if (!mFile)
+		return false;
+
+	// The ring already batches the frames; unbuffered, each fwrite() says
+	// how many of them reached the file
+	std::setvbuf(mFile, NULL, _IONBF, 0);
+
+	FrameLogHeader header;
+	header.initialize();
+	if (std::fwrite(&header, sizeof(header), 1, mFile) != 1) {
+		std::fclose(mFile);
+		mFile = NULL;
+		return false;
+	}
+
+	mHead.store(0);
+	mTail.store(0);
+	mWritten.store(0);
+	mLost.store(0);
+	mDropped.store(0);
+	mFailed.store(false);
+	mRunning.store(true);
+	mThread = std::thread(&FrameLogWriter::run, this);
+	return true;
+}
+
+bool FrameLogWriter::close() {
+	if (!mFile)
+		return !mFailed.load();
+
+	mRunning.store(false);
+	mThread.join();
+
+	if (std::fclose(mFile) != 0)
+		mFailed.store(true);
+	mFile = NULL;
+	return !mFailed.load();
+}
+
+bool FrameLogWriter::isOpen() const {
+	return mRunning.load(std::memory_order_relaxed);
+}
+
+HandFrame* FrameLogWriter::beginAppend() {
+	if (!mRunning.load(std::memory_order_relaxed))
+		return NULL;
+
+	uint64_t head = mHead.load(std::memory_order_relaxed);
+	uint64_t tail = mTail.load(std::memory_order_acquire);
+	if (head - tail >= mRing.size()) {
+		mDropped.fetch_add(1, std::memory_order_relaxed);
+		return NULL;
+	}
+	return &mRing[head & mMask];
+}
+
+void FrameLogWriter::commitAppend() {
+	uint64_t head = mHead.load(std::memory_order_relaxed);
+	mHead.store(head + 1, std::memory_order_release);
+}
+
+bool FrameLogWriter::append(const HandFrame& frame) {
+	HandFrame *slot = beginAppend();
+	if (!slot)
+		return false;
+	*slot = frame;
+	commitAppend();
+	return true;
+}
+
+uint64_t FrameLogWriter::getWritten() const {
+	return mWritten.load(std::memory_order_acquire);
+}
+
+uint64_t FrameLogWriter::getLost() const {
+	return mLost.load(std::memory_order_acquire);
+}
+
+uint64_t FrameLogWriter::getDropped() const {
+	return mDropped.load(std::memory_order_relaxed);
+}
+
+
+/*
+   Private member functions
+*/
+
+void FrameLogWriter::run() {
+	while (mRunning.load()) {
+		if (drain() == 0)
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+
+	// Anything appended before close()
+	drain();
+}
+
+uint64_t FrameLogWriter::drain() {
+	uint64_t tail = mTail.load(std::memory_order_relaxed);
+	uint64_t head = mHead.load(std::memory_order_acquire);
+	uint64_t capacity = mRing.size();
+	uint64_t taken = 0;
+
+	while (tail < head) {
+		// Contiguous run of frames up to the end of the ring
+		uint64_t count = head - tail;
+		uint64_t first = tail & mMask;
+		if (count > capacity - first)
+			count = capacity - first;
+
+		// After a short write the file may end in part of a frame, which
+		// readers ignore; writing more would misalign every frame after it
+		uint64_t written = 0;
+		if (!mFailed.load(std::memory_order_relaxed)) {
+			written = std::fwrite(&mRing[first], sizeof(HandFrame), count,
+					mFile);
+			if (written < count)
+				mFailed.store(true);
+		}
+		mWritten.fetch_add(written, std::memory_order_release);
+		mLost.fetch_add(count - written, std::memory_order_release);
+		tail += count;
+		taken += count;
+
+		// The slots can now be reused by beginAppend()
+		mTail.store(tail, std::memory_order_release);
+	}
+	return taken;
+}
+
+
+/*
+   FrameLogReader
+*/
+
+FrameLogReader::FrameLogReader()
+		: mData(NULL), mLength(0), mFrames(NULL), mSize(0) {
+#ifdef _WIN32
+	mFileHandle = INVALID_HANDLE_VALUE;
+	mMappingHandle = NULL;
+#endif
+}
+
+FrameLogReader::~FrameLogReader() {
+	close();
+}
+
+bool FrameLogReader::open(const std::string& filename) {
+	close();
+
+#ifdef _WIN32
+	mFileHandle = CreateFileA(filename.c_str(), GENERIC_READ,
+			FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (mFileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER length;
+	if (!GetFileSizeEx(mFileHandle, &length)
+			|| length.QuadPart < (LONGLONG)sizeof(FrameLogHeader)) {
+		close();
+		return false;
+	}
+	mLength = length.QuadPart;
+
+	mMappingHandle = CreateFileMapping(mFileHandle, NULL, PAGE_READONLY,
+			0, 0, NULL);
+	if (!mMappingHandle) {
+		close();
+		return false;
+	}
+
+	mData = static_cast<const char*>(MapViewOfFile(mMappingHandle,
+			FILE_MAP_READ, 0, 0, 0));
+	if (!mData) {
+		close();
+		return false;
+	}
+#else
+	int file = ::open(filename.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(file, &info) != 0
+			|| info.st_size < (off_t)sizeof(FrameLogHeader)) {
+		::close(file);
+		return false;
+	}
+	mLength = info.st_size;
+
+	void *data = mmap(NULL, mLength, PROT_READ, MAP_PRIVATE, file, 0);
+	::close(file);
+	if (data == MAP_FAILED)
+		return false;
+	mData = static_cast<const char*>(data);
+	madvise(data, mLength, MADV_SEQUENTIAL);
+#endif
+
+	const FrameLogHeader *header =
+			reinterpret_cast<const FrameLogHeader*>(mData);
+	if (!header->isCompatible()) {
+		close();
+		return false;
+	}
+
+	mFrames = reinterpret_cast<const HandFrame*>(mData + header->headerSize);
+	mSize = (mLength - header->headerSize) / header->stride;
+	return true;
+}
+
+void FrameLogReader::close() {
+#ifdef _WIN32
+	if (mData)
+		UnmapViewOfFile(mData);
+	if (mMappingHandle)
+		CloseHandle(mMappingHandle);
+	if (mFileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle(mFileHandle);
+	mMappingHandle = NULL;
+	mFileHandle = INVALID_HANDLE_VALUE;
+#else
+	if (mData)
+		munmap(const_cast<char*>(mData), mLength);
+#endif
+
+	mData = NULL;
+	mLength = 0;
+	mFrames = NULL;
+	mSize = 0;
+}
+
+bool FrameLogReader::isOpen() const {
+	return mData != NULL;
+}
+
+int64_t FrameLogReader::size() const {
+	return mSize;
+}
+
+const HandFrame& FrameLogReader::operator[](int64_t i) const {
+	return mFrames[i];
+}
+
+FrameLogReader::const_iterator FrameLogReader::begin() const {
+	return mFrames;
+}
+
+FrameLogReader::const_iterator FrameLogReader::end() const {
+	return mFrames + mSize;
+}
@@ -0,0 +1,158 @@
+/*
+	Philip Romano
+	10/16/2026
+	frameresampler.cpp
+*/
+
+#include <cmath>
+#include <stdint.h>
+
+#include "frameresampler.h"
+#include "handframe.h"
+
+namespace {
+	Vector3 lerp(const Vector3& a, const Vector3& b, float alpha) {
+		Vector3 v;
+		v.x = a.x + (b.x - a.x) * alpha;
+		v.y = a.y + (b.y - a.y) * alpha;
+		v.z = a.z + (b.z - a.z) * alpha;
+		return v;
+	}
+
+	/**
+	  Write into out the hand a fraction alpha of the way from a to b (the
+	  same hand in two frames). The fingers are those of near, which is a
+	  or b.
+	*/
+	void lerpHand(const HandData& a, const HandData& b, float alpha,
+			const HandData& near, HandData& out) {
+		out.id = near.id;
+		out.palmPosition = lerp(a.palmPosition, b.palmPosition, alpha);
+		out.palmVelocity = lerp(a.palmVelocity, b.palmVelocity, alpha);
+
+		out.palmNormal = lerp(a.palmNormal, b.palmNormal, alpha);
+		float length = out.palmNormal.magnitude();
+		if (length > 0.0f) {
+			out.palmNormal.x /= length;
+			out.palmNormal.y /= length;
+			out.palmNormal.z /= length;
+		}
+
+		const HandData& far = (&near == &a) ? b : a;
+		out.fingerCount = near.fingerCount;
+		for (int f = 0; f < near.fingerCount; ++f) {
+			const FingerData& finger = near.fingers[f];
+			const FingerData *other = far.findFinger(finger.id);
+			if (!other) {
+				out.fingers[f] = finger;
+				continue;
+			}
+
+			const FingerData& fa = (&near == &a) ? finger : *other;
+			const FingerData& fb = (&near == &a) ? *other : finger;
+			out.fingers[f].id = finger.id;
+			out.fingers[f].tipPosition = lerp(fa.tipPosition, fb.tipPosition,
+					alpha);
+			out.fingers[f].tipVelocity = lerp(fa.tipVelocity, fb.tipVelocity,
+					alpha);
+		}
+	}
+}
+
+FrameResampler::FrameResampler(double rate, int64_t maxGap)
+		: mPeriod(1000000.0 / (rate > 0.0 ? rate : 100.0)),
+		  mMaxGap(maxGap), mNextId(0) {
+	reset();
+}
+
+bool FrameResampler::push(const HandFrame& frame) {
+	if (!frame.isValid())
+		return false;
+
+	if (!mHasCurrent) {
+		mStart = frame.timestamp;
+		mIndex = 0;
+	} else if (frame.timestamp <= mCurrent.timestamp) {
+		return false;
+	} else if (frame.timestamp - mCurrent.timestamp > mMaxGap) {
+		// Lost track: start a new grid rather than make up the gap
+		mHasPrevious = false;
+		mStart = frame.timestamp;
+		mIndex = 0;
+	} else {
+		mPrevious = mCurrent;
+		mHasPrevious = true;
+	}
+
+	mCurrent = frame;
+	mHasCurrent = true;
+	return true;
+}
+
+bool FrameResampler::next(HandFrame& frame) {
+	if (!mHasCurrent)
+		return false;
+
+	int64_t time = getNextTime();
+	if (time > mCurrent.timestamp)
+		return false;
+
+	if (!mHasPrevious || time >= mCurrent.timestamp) {
+		frame = mCurrent;
+	} else {
+		double alpha = (double)(time - mPrevious.timestamp)
+				/ (double)(mCurrent.timestamp - mPrevious.timestamp);
+		interpolate(alpha, frame);
+	}
+
+	frame.id = mNextId++;
+	frame.timestamp = time;
+	++mIndex;
+	return true;
+}
+
+void FrameResampler::reset() {
+	mHasPrevious = false;
+	mHasCurrent = false;
+	mStart = 0;
+	mIndex = 0;
+}
+
+double FrameResampler::getRate() const {
+	return 1000000.0 / mPeriod;
+}
+
+double FrameResampler::getPeriod() const {
+	return mPeriod;
+}
+
+
+/*
+   Private member functions
+*/
+
+int64_t FrameResampler::getNextTime() const {
+	return mStart + (int64_t)std::floor(mIndex * mPeriod + 0.5);
+}
+
+void FrameResampler::interpolate(double alpha, HandFrame& out) const {
+	const HandFrame& near = (alpha < 0.5) ? mPrevious : mCurrent;
+	const HandFrame& far = (alpha < 0.5) ? mCurrent : mPrevious;
+	float a = (float)alpha;
+
+	out.handCount = near.handCount;
+	out.reserved = 0;
+	for (int h = 0; h < near.handCount; ++h) {
+		const HandData& hand = near.hands[h];
+		const HandData *other = far.findHand(hand.id);
+		if (!other) {
+			out.hands[h] = hand;
+			continue;
+		}
+
+		if (&near == &mPrevious)
+			lerpHand(hand, *other, a, hand, out.hands[h]);
+		else
+			lerpHand(*other, hand, a, hand, out.hands[h]);
+	}
+}
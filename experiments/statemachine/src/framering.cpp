@@ -0,0 +1,459 @@
+/*
+	Philip Romano
+	10/16/2026
+	framering.cpp
+*/
+
+#include <string>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <climits>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef __linux__
+#include <time.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+#include "framering.h"
+#include "handframe.h"
+
+namespace {
+	const char MAGIC[8] = { 'H', 'A', 'N', 'D', 'R', 'I', 'N', 'G' };
+
+	/**
+	  Returns the name of the shared memory object for the ring with the
+	  given name.
+	*/
+	std::string getObjectName(const std::string& name) {
+#ifdef _WIN32
+		return "Local\\" + name;
+#else
+		// POSIX shared memory names start with a single slash
+		return (!name.empty() && name[0] == '/') ? name : "/" + name;
+#endif
+	}
+
+#ifdef __linux__
+	// The futex calls are not process-private: the word is in memory shared
+	// with other processes
+	void futexWait(std::atomic<uint32_t>& word, uint32_t value,
+			int timeoutMs) {
+		struct timespec timeout;
+		timeout.tv_sec = timeoutMs / 1000;
+		timeout.tv_nsec = (long)(timeoutMs % 1000) * 1000000;
+		syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT,
+				value, timeoutMs >= 0 ? &timeout : NULL, NULL, 0);
+	}
+
+	void futexWake(std::atomic<uint32_t>& word) {
+		syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE,
+				INT_MAX, NULL, NULL, 0);
+	}
+#endif
+}
+
+/*
+   FrameRingHeader
+*/
+
+const uint32_t FrameRingHeader::VERSION;
+
+void FrameRingHeader::initialize(uint32_t slots) {
+	version = VERSION;
+	headerSize = sizeof(FrameRingHeader);
+	stride = sizeof(FrameRingSlot);
+	capacity = slots;
+	head.store(0);
+	signal.store(0);
+	waiters.store(0);
+	closed.store(0);
+
+	// Last, so that a reader never takes a half-written header as valid
+	std::atomic_thread_fence(std::memory_order_release);
+	std::memcpy(magic, MAGIC, sizeof(magic));
+}
+
+bool FrameRingHeader::isCompatible() const {
+	bool compatible = std::memcmp(magic, MAGIC, sizeof(magic)) == 0;
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return compatible && version == VERSION
+			&& headerSize == sizeof(FrameRingHeader)
+			&& stride == sizeof(FrameRingSlot)
+			&& capacity > 0 && (capacity & (capacity - 1)) == 0;
+}
+
+
+/*
+   FrameRingWriter
+*/
+
+FrameRingWriter::FrameRingWriter()
+		: mHeader(NULL), mSlots(NULL), mMask(0), mLength(0) {
+#ifdef _WIN32
+	mMappingHandle = NULL;
+#endif
+}
+
+FrameRingWriter::~FrameRingWriter() {
+	close();
+}
+
+bool FrameRingWriter::create(const std::string& name, int capacity) {
+	close();
+
+	int size = 1;
+	while (size < capacity)
+		size *= 2;
+	int64_t length = sizeof(FrameRingHeader)
+			+ (int64_t)size * sizeof(FrameRingSlot);
+	std::string object = getObjectName(name);
+
+	// A new mapping is zero-filled, so every slot starts with sequence 0
+#ifdef _WIN32
+	mMappingHandle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL,
+			PAGE_READWRITE, (DWORD)(length >> 32), (DWORD)length,
+			object.c_str());
+	if (!mMappingHandle)
+		return false;
+
+	void *data = MapViewOfFile(mMappingHandle, FILE_MAP_ALL_ACCESS, 0, 0,
+			length);
+	if (!data) {
+		CloseHandle(mMappingHandle);
+		mMappingHandle = NULL;
+		return false;
+	}
+#else
+	shm_unlink(object.c_str());
+	int file = shm_open(object.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (file < 0)
+		return false;
+
+	if (ftruncate(file, length) != 0) {
+		::close(file);
+		shm_unlink(object.c_str());
+		return false;
+	}
+
+	void *data = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED,
+			file, 0);
+	::close(file);
+	if (data == MAP_FAILED) {
+		shm_unlink(object.c_str());
+		return false;
+	}
+#endif
+
+	mName = object;
+	mLength = length;
+	mHeader = static_cast<FrameRingHeader*>(data);
+	mSlots = reinterpret_cast<FrameRingSlot*>(
+			static_cast<char*>(data) + sizeof(FrameRingHeader));
+	mMask = size - 1;
+	mHeader->initialize(size);
+	return true;
+}
+
+void FrameRingWriter::close() {
+	if (!mHeader)
+		return;
+
+	mHeader->closed.store(1);
+	mHeader->signal.fetch_add(1);
+#ifdef __linux__
+	futexWake(mHeader->signal);
+#endif
+
+#ifdef _WIN32
+	UnmapViewOfFile(mHeader);
+	CloseHandle(mMappingHandle);
+	mMappingHandle = NULL;
+#else
+	munmap(mHeader, mLength);
+	shm_unlink(mName.c_str());
+#endif
+
+	mHeader = NULL;
+	mSlots = NULL;
+	mLength = 0;
+	mName.clear();
+}
+
+bool FrameRingWriter::isOpen() const {
+	return mHeader != NULL;
+}
+
+HandFrame* FrameRingWriter::beginAppend() {
+	if (!mHeader)
+		return NULL;
+
+	uint64_t index = mHeader->head.load(std::memory_order_relaxed);
+	FrameRingSlot& slot = mSlots[index & mMask];
+
+	// Readers still holding the frame that was here see the sequence move
+	// on, and discard it
+	slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	return &slot.frame;
+}
+
+void FrameRingWriter::commitAppend() {
+	uint64_t index = mHeader->head.load(std::memory_order_relaxed);
+	mSlots[index & mMask].sequence.store(2 * index + 2,
+			std::memory_order_release);
+	mHeader->head.store(index + 1, std::memory_order_release);
+
+	// Paired with wait(): either the reader sees the new signal before it
+	// sleeps, or the writer sees the reader waiting and wakes it
+	mHeader->signal.fetch_add(1);
+#ifdef __linux__
+	if (mHeader->waiters.load() > 0)
+		futexWake(mHeader->signal);
+#endif
+}
+
+bool FrameRingWriter::append(const HandFrame& frame) {
+	HandFrame *slot = beginAppend();
+	if (!slot)
+		return false;
+	*slot = frame;
+	commitAppend();
+	return true;
+}
+
+uint64_t FrameRingWriter::getWritten() const {
+	return mHeader ? mHeader->head.load(std::memory_order_relaxed) : 0;
+}
+
+
+/*
+   FrameRingReader
+*/
+
+FrameRingReader::FrameRingReader()
+		: mHeader(NULL), mSlots(NULL), mMask(0), mLength(0), mNext(0),
+		  mAcquired(NULL), mRead(0), mMissed(0) {
+#ifdef _WIN32
+	mMappingHandle = NULL;
+#endif
+}
+
+FrameRingReader::~FrameRingReader() {
+	close();
+}
+
+bool FrameRingReader::open(const std::string& name) {
+	close();
+	std::string object = getObjectName(name);
+
+#ifdef _WIN32
+	mMappingHandle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE,
+			object.c_str());
+	if (!mMappingHandle)
+		return false;
+
+	void *data = MapViewOfFile(mMappingHandle, FILE_MAP_ALL_ACCESS, 0, 0,
+			0);
+	MEMORY_BASIC_INFORMATION info;
+	if (!data || VirtualQuery(data, &info, sizeof(info)) == 0) {
+		if (data)
+			UnmapViewOfFile(data);
+		CloseHandle(mMappingHandle);
+		mMappingHandle = NULL;
+		return false;
+	}
+	mLength = info.RegionSize;
+#else
+	int file = shm_open(object.c_str(), O_RDWR, 0);
+	if (file < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(file, &info) != 0
+			|| info.st_size < (off_t)sizeof(FrameRingHeader)) {
+		::close(file);
+		return false;
+	}
+	mLength = info.st_size;
+
+	void *data = mmap(NULL, mLength, PROT_READ | PROT_WRITE, MAP_SHARED,
+			file, 0);
+	::close(file);
+	if (data == MAP_FAILED)
+		return false;
+#endif
+
+	mHeader = static_cast<FrameRingHeader*>(data);
+	if (!mHeader->isCompatible() || mLength < (int64_t)mHeader->headerSize
+			+ (int64_t)mHeader->capacity * mHeader->stride) {
+		close();
+		return false;
+	}
+
+	mSlots = reinterpret_cast<const FrameRingSlot*>(
+			static_cast<const char*>(data) + mHeader->headerSize);
+	mMask = mHeader->capacity - 1;
+	mNext = mHeader->head.load(std::memory_order_acquire);
+	mAcquired = NULL;
+	mRead = 0;
+	mMissed = 0;
+	return true;
+}
+
+void FrameRingReader::close() {
+	if (!mHeader)
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(mHeader);
+	CloseHandle(mMappingHandle);
+	mMappingHandle = NULL;
+#else
+	munmap(mHeader, mLength);
+#endif
+
+	mHeader = NULL;
+	mSlots = NULL;
+	mLength = 0;
+	mAcquired = NULL;
+}
+
+bool FrameRingReader::isOpen() const {
+	return mHeader != NULL;
+}
+
+const HandFrame* FrameRingReader::acquire() {
+	if (!mHeader)
+		return NULL;
+	if (mAcquired)
+		return &mAcquired->frame;
+
+	uint64_t capacity = mMask + 1;
+	for (;;) {
+		uint64_t head = mHeader->head.load(std::memory_order_acquire);
+		if (mNext >= head)
+			return NULL;
+
+		// Lapped: the oldest frames have already been overwritten
+		if (head - mNext > capacity) {
+			mMissed += head - capacity - mNext;
+			mNext = head - capacity;
+		}
+
+		const FrameRingSlot& slot = mSlots[mNext & mMask];
+		if (slot.sequence.load(std::memory_order_acquire)
+				== 2 * mNext + 2) {
+			mAcquired = &slot;
+			return &slot.frame;
+		}
+
+		// Overwritten since head was read
+		++mMissed;
+		++mNext;
+	}
+}
+
+bool FrameRingReader::release() {
+	if (!mAcquired)
+		return false;
+
+	// Everything read from the frame happens before the sequence is checked
+	// again
+	std::atomic_thread_fence(std::memory_order_acquire);
+	bool intact = mAcquired->sequence.load(std::memory_order_relaxed)
+			== 2 * mNext + 2;
+
+	mAcquired = NULL;
+	++mNext;
+	if (intact)
+		++mRead;
+	else
+		++mMissed;
+	return intact;
+}
+
+bool FrameRingReader::read(HandFrame& frame) {
+	const HandFrame *next;
+	while ((next = acquire()) != NULL) {
+		frame = *next;
+		if (release())
+			return true;
+	}
+	return false;
+}
+
+void FrameRingReader::skipToLatest() {
+	if (!mHeader || mAcquired)
+		return;
+
+	uint64_t head = mHeader->head.load(std::memory_order_acquire);
+	if (head > mNext + 1)
+		mNext = head - 1;
+}
+
+bool FrameRingReader::wait(int timeoutMs) {
+	if (!mHeader)
+		return false;
+
+	std::chrono::steady_clock::time_point deadline =
+		std::chrono::steady_clock::now()
+		+ std::chrono::milliseconds(timeoutMs > 0 ? timeoutMs : 0);
+
+	for (;;) {
+		uint32_t signal = mHeader->signal.load();
+		if (getAvailable() > 0)
+			return true;
+		if (isWriterClosed())
+			return false;
+
+		int remaining = -1;
+		if (timeoutMs >= 0) {
+			remaining = (int)std::chrono::duration_cast<
+				std::chrono::milliseconds>(
+					deadline - std::chrono::steady_clock::now()).count();
+			if (remaining <= 0)
+				return false;
+		}
+
+#ifdef __linux__
+		// The kernel only puts us to sleep if no frame has been published
+		// since signal was read
+		mHeader->waiters.fetch_add(1);
+		futexWait(mHeader->signal, signal, remaining);
+		mHeader->waiters.fetch_sub(1);
+#else
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#endif
+	}
+}
+
+uint64_t FrameRingReader::getAvailable() const {
+	if (!mHeader)
+		return 0;
+	return mHeader->head.load(std::memory_order_acquire) - mNext;
+}
+
+bool FrameRingReader::isWriterClosed() const {
+	return mHeader && mHeader->closed.load() != 0;
+}
+
+uint64_t FrameRingReader::getRead() const {
+	return mRead;
+}
+
+uint64_t FrameRingReader::getMissed() const {
+	return mMissed;
+}
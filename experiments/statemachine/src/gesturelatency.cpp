@@ -0,0 +1,268 @@
+/*
+	Philip Romano
+	10/16/2026
+	gesturelatency.cpp
+*/
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <iomanip>
+#include <algorithm>
+#include <mutex>
+#include <cmath>
+#include <stdint.h>
+
+#include "gesturelatency.h"
+#include "compiledgesturegraph.h"
+#include "gestureprofile.h"
+#include "csv.h"
+
+namespace {
+	// The spans reported: each stage, then end to end
+	const GestureLatency::Stage SPANS[][2] = {
+		{ GestureLatency::CAPTURE, GestureLatency::ENQUEUE },
+		{ GestureLatency::ENQUEUE, GestureLatency::COMMIT },
+		{ GestureLatency::COMMIT, GestureLatency::CONSUME },
+		{ GestureLatency::CONSUME, GestureLatency::PRESENT },
+		{ GestureLatency::ENQUEUE, GestureLatency::PRESENT },
+		{ GestureLatency::CAPTURE, GestureLatency::PRESENT }
+	};
+	const int SPAN_COUNT = sizeof(SPANS) / sizeof(SPANS[0]);
+}
+
+const int GestureLatency::ARRIVALS;
+const int GestureLatency::OPEN;
+
+GestureLatency::GestureLatency(int capacity)
+		: mEvents(capacity > 0 ? capacity : 1) {
+	reset();
+}
+
+void GestureLatency::arrive(const HandFrame& frame, int64_t time) {
+	if (!frame.isValid())
+		return;
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	int i = mArrivals++ % ARRIVALS;
+	mArrivalFrame[i] = frame.timestamp;
+	mArrivalTime[i] = time;
+
+	int64_t offset = time - frame.timestamp * 1000;
+	if (!mHasClock || offset < mClockOffset) {
+		mClockOffset = offset;
+		mHasClock = true;
+	}
+}
+
+void GestureLatency::commit(int node, const HandFrame& frame, int session,
+		int64_t time) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (mOpenCount == OPEN) {
+		// Nobody is presenting: let the oldest go
+		std::copy(mOpen + 1, mOpen + OPEN, mOpen);
+		--mOpenCount;
+		if (mConsumed > 0)
+			--mConsumed;
+		++mAbandoned;
+	}
+
+	LatencyEvent& event = mOpen[mOpenCount++];
+	event.node = node;
+	event.session = session;
+	event.frameId = frame.id;
+	event.frameTime = frame.timestamp;
+	event.times[CAPTURE] = mHasClock
+		? frame.timestamp * 1000 + mClockOffset : -1;
+	event.times[ENQUEUE] = findArrival(frame.timestamp);
+	event.times[COMMIT] = time;
+	event.times[CONSUME] = -1;
+	event.times[PRESENT] = -1;
+}
+
+void GestureLatency::consume(int64_t time) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	for (; mConsumed < mOpenCount; ++mConsumed)
+		mOpen[mConsumed].times[CONSUME] = time;
+}
+
+void GestureLatency::present(int64_t time) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	for (int e = 0; e < mConsumed; ++e) {
+		mOpen[e].times[PRESENT] = time;
+		mEvents[mCount++ % mEvents.size()] = mOpen[e];
+	}
+
+	std::copy(mOpen + mConsumed, mOpen + mOpenCount, mOpen);
+	mOpenCount -= mConsumed;
+	mConsumed = 0;
+}
+
+void GestureLatency::reset() {
+	std::lock_guard<std::mutex> lock(mMutex);
+	mArrivals = 0;
+	mClockOffset = 0;
+	mHasClock = false;
+	mOpenCount = 0;
+	mConsumed = 0;
+	mAbandoned = 0;
+	mCount = 0;
+}
+
+int GestureLatency::getCount() const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return (int)std::min<uint64_t>(mCount, mEvents.size());
+}
+
+LatencyEvent GestureLatency::getEvent(int i) const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	uint64_t first = (mCount > mEvents.size()) ? mCount - mEvents.size() : 0;
+	return mEvents[(first + i) % mEvents.size()];
+}
+
+std::vector<LatencyEvent> GestureLatency::getEvents() const {
+	std::vector<LatencyEvent> events;
+	uint64_t abandoned;
+	snapshot(events, abandoned);
+	return events;
+}
+
+uint64_t GestureLatency::getAbandoned() const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mAbandoned;
+}
+
+int64_t GestureLatency::getLatency(const LatencyEvent& event, Stage from,
+		Stage to) {
+	if (event.times[from] < 0 || event.times[to] < 0)
+		return -1;
+	return event.times[to] - event.times[from];
+}
+
+int64_t GestureLatency::getPercentile(std::vector<int64_t>& values,
+		double p) {
+	if (values.empty())
+		return -1;
+
+	std::sort(values.begin(), values.end());
+	int rank = (int)std::ceil(p / 100.0 * values.size());
+	if (rank < 1)
+		rank = 1;
+	else if (rank > (int)values.size())
+		rank = values.size();
+	return values[rank - 1];
+}
+
+void GestureLatency::report(std::ostream& out) const {
+	// The table is of one moment, however many events arrive meanwhile
+	std::vector<LatencyEvent> events;
+	uint64_t abandoned;
+	snapshot(events, abandoned);
+
+	out << std::left << std::setw(20) << "latency (ms)" << std::right
+		<< std::setw(8) << "count" << std::setw(10) << "p50"
+		<< std::setw(10) << "p90" << std::setw(10) << "p99"
+		<< std::setw(10) << "max" << "\n";
+
+	std::ios::fmtflags flags = out.flags();
+	std::streamsize precision = out.precision();
+	out << std::fixed << std::setprecision(2);
+
+	std::vector<int64_t> values;
+	for (int s = 0; s < SPAN_COUNT; ++s) {
+		values.clear();
+		for (int e = 0; e < (int)events.size(); ++e) {
+			int64_t latency = getLatency(events[e], SPANS[s][0], SPANS[s][1]);
+			if (latency >= 0)
+				values.push_back(latency);
+		}
+
+		std::string span = std::string(getStageName(SPANS[s][0])) + " > "
+			+ getStageName(SPANS[s][1]);
+		out << std::left << std::setw(20) << span << std::right
+			<< std::setw(8) << values.size();
+		static const double PERCENTILES[] = { 50.0, 90.0, 99.0, 100.0 };
+		for (int p = 0; p < 4; ++p) {
+			int64_t ns = getPercentile(values, PERCENTILES[p]);
+			if (ns < 0)
+				out << std::setw(10) << "-";
+			else
+				out << std::setw(10) << ns / 1e6;
+		}
+		out << "\n";
+	}
+
+	out.flags(flags);
+	out.precision(precision);
+	if (abandoned > 0)
+		out << abandoned << " events never presented\n";
+}
+
+void GestureLatency::writeCsv(std::ostream& out,
+		const CompiledGestureGraph& graph) const {
+	out << "node,session,frame,frame_time";
+	for (int s = 0; s < STAGES; ++s)
+		out << "," << getStageName((Stage)s) << "_ns";
+	out << "\n";
+
+	std::vector<LatencyEvent> events = getEvents();
+	for (int e = 0; e < (int)events.size(); ++e) {
+		const LatencyEvent& event = events[e];
+		if (event.node >= 0 && event.node < graph.getNodeCount())
+			writeCsvString(out, graph.getNodeId(event.node));
+		out << "," << event.session << "," << event.frameId << ","
+			<< event.frameTime;
+
+		Stage origin = (event.times[CAPTURE] >= 0) ? CAPTURE : COMMIT;
+		for (int s = 0; s < STAGES; ++s) {
+			out << ",";
+			int64_t latency = getLatency(event, origin, (Stage)s);
+			if (latency >= 0)
+				out << latency;
+		}
+		out << "\n";
+	}
+}
+
+const char* GestureLatency::getStageName(Stage stage) {
+	switch (stage) {
+		case CAPTURE:
+			return "capture";
+		case ENQUEUE:
+			return "enqueue";
+		case COMMIT:
+			return "commit";
+		case CONSUME:
+			return "consume";
+		case PRESENT:
+			return "present";
+		default:
+			return "";
+	}
+}
+
+
+/*
+   Private member functions
+*/
+
+int64_t GestureLatency::findArrival(int64_t frameTime) const {
+	uint64_t first = (mArrivals > ARRIVALS) ? mArrivals - ARRIVALS : 0;
+	for (uint64_t a = first; a < mArrivals; ++a) {
+		if (mArrivalFrame[a % ARRIVALS] >= frameTime)
+			return mArrivalTime[a % ARRIVALS];
+	}
+	return -1;
+}
+
+void GestureLatency::snapshot(std::vector<LatencyEvent>& events,
+		uint64_t& abandoned) const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	uint64_t kept = std::min<uint64_t>(mCount, mEvents.size());
+	uint64_t first = mCount - kept;
+	events.clear();
+	events.reserve(kept);
+	for (uint64_t e = first; e < mCount; ++e)
+		events.push_back(mEvents[e % mEvents.size()]);
+	abandoned = mAbandoned;
+}
@@ -0,0 +1,41 @@
+/*
+	Philip Romano
+	10/16/2026
+	gesturememo.cpp
+*/
+
+#include <vector>
+#include <stdint.h>
+
+#include "gesturememo.h"
+
+GestureMemo::GestureMemo() {
+
+}
+
+void GestureMemo::resize(int size) {
+	mFrames.assign(size, 0);
+	mSlots.assign(size, 0);
+	mValid.assign(size, false);
+}
+
+int GestureMemo::size() const {
+	return mFrames.size();
+}
+
+bool GestureMemo::lookup(int type, int64_t frame, int& slot) const {
+	if (type >= 0 && type < (int)mFrames.size() && mValid[type]
+			&& mFrames[type] == frame) {
+		slot = mSlots[type];
+		return true;
+	} else
+		return false;
+}
+
+void GestureMemo::store(int type, int64_t frame, int slot) {
+	if (type >= 0 && type < (int)mFrames.size()) {
+		mFrames[type] = frame;
+		mSlots[type] = slot;
+		mValid[type] = true;
+	}
+}
@@ -7,16 +7,36 @@
 */
 
 #include <string>
-#include <Leap.h>
+#include <cstddef>
+#include "handframe.h"
 #include "gesturenode.h"
 
-void GestureNode::onEnter(const Leap::Frame& frame,
-		const std::string& nodeid) {
+GestureNode::~GestureNode() {
+
+}
+
+void GestureNode::onEnter(const HandFrame& frame,
+		const std::string& nodeid, void *state) {
 	// Do nothing
 }
 
-void GestureNode::onLeave(const Leap::Frame& frame,
-		const std::string& nodeid) {
+void GestureNode::onLeave(const HandFrame& frame,
+		const std::string& nodeid, void *state) {
 	// Do nothing
 }
 
+bool GestureNode::isPure() {
+	return false;
+}
+
+bool GestureNode::readsFeatures() {
+	return false;
+}
+
+std::size_t GestureNode::getStateSize() {
+	return 0;
+}
+
+void GestureNode::initState(void *state) {
+	// Do nothing
+}
@@ -0,0 +1,205 @@
+/*
+	Philip Romano
+	10/16/2026
+	gestureprofile.cpp
+*/
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <sstream>
+#include <algorithm>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "gestureprofile.h"
+#include "compiledgesturegraph.h"
+#include "gesturenode.h"
+#include "csv.h"
+
+namespace {
+	const std::string& typeName(const CompiledGestureGraph& graph,
+			int node) {
+		static const std::string none;
+		GestureNode *type = graph.getNodeType(node);
+		if (type)
+			return type->getName();
+		else
+			return none;
+	}
+
+	uint64_t bucketBound(int bucket) {
+		return (bucket == 0) ? 0 : ((uint64_t)1 << bucket);
+	}
+
+	// Node IDs are arbitrary strings, so quote them for JSON (see csv.h
+	// for CSV)
+	void writeJsonString(std::ostream& out, const std::string& value) {
+		static const char hex[] = "0123456789abcdef";
+		out << '"';
+		for (std::string::const_iterator it = value.begin();
+				it != value.end(); ++it) {
+			unsigned char c = *it;
+			if (c == '"' || c == '\\')
+				out << '\\' << c;
+			else if (c < 0x20)
+				out << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+			else
+				out << c;
+		}
+		out << '"';
+	}
+}
+
+const int GestureProfile::BUCKETS;
+
+GestureProfile::NodeCounters::NodeCounters()
+		: visits(0), evaluateNs(0) {
+	std::fill(histogram, histogram + BUCKETS, 0);
+}
+
+GestureProfile::GestureProfile() {
+
+}
+
+GestureProfile::~GestureProfile() {
+
+}
+
+void GestureProfile::record(int node, int slot, int64_t ns) {
+	if (node < 0)
+		return;
+	if (node >= (int)mNodes.size())
+		mNodes.resize(node + 1);
+
+	NodeCounters& counters = mNodes[node];
+	++counters.visits;
+
+	if (ns < 0)
+		ns = 0;
+	counters.evaluateNs += ns;
+
+	int bucket = 0;
+	while (bucket < BUCKETS - 1 && ((uint64_t)ns >> (bucket + 1)) != 0)
+		++bucket;
+	++counters.histogram[bucket];
+
+	if (slot >= 0) {
+		if (slot >= (int)counters.slots.size())
+			counters.slots.resize(slot + 1, 0);
+		++counters.slots[slot];
+	}
+}
+
+void GestureProfile::reset() {
+	mNodes.clear();
+}
+
+const GestureProfile::NodeCounters& GestureProfile::getCounters(int node)
+		const {
+	static const NodeCounters none;
+	if (node >= 0 && node < (int)mNodes.size())
+		return mNodes[node];
+	else
+		return none;
+}
+
+int GestureProfile::getNodeCount() const {
+	return mNodes.size();
+}
+
+void GestureProfile::writeCsv(std::ostream& out,
+		const CompiledGestureGraph& graph) const {
+	out << "node,type,metric,key,value\n";
+	for (int n = 0; n < (int)mNodes.size(); ++n) {
+		const NodeCounters& counters = mNodes[n];
+		if (counters.visits == 0)
+			continue;
+
+		std::string prefix;
+		{
+			std::ostringstream name;
+			writeCsvString(name, graph.getNodeId(n));
+			name << ',';
+			writeCsvString(name, typeName(graph, n));
+			name << ',';
+			prefix = name.str();
+		}
+
+		out << prefix << "visits,," << counters.visits << "\n";
+		out << prefix << "evaluate_ns,," << counters.evaluateNs << "\n";
+		for (int i = 0; i < (int)counters.slots.size(); ++i) {
+			if (counters.slots[i] != 0)
+				out << prefix << "slot," << i << ","
+						<< counters.slots[i] << "\n";
+		}
+		for (int i = 0; i < BUCKETS; ++i) {
+			if (counters.histogram[i] != 0)
+				out << prefix << "histogram," << bucketBound(i) << ","
+						<< counters.histogram[i] << "\n";
+		}
+	}
+}
+
+void GestureProfile::writeJson(std::ostream& out,
+		const CompiledGestureGraph& graph) const {
+	out << "{\n\t\"nodes\": [";
+	bool firstNode = true;
+	for (int n = 0; n < (int)mNodes.size(); ++n) {
+		const NodeCounters& counters = mNodes[n];
+		if (counters.visits == 0)
+			continue;
+
+		out << (firstNode ? "\n" : ",\n") << "\t\t{ \"node\": ";
+		firstNode = false;
+		writeJsonString(out, graph.getNodeId(n));
+		out << ", \"type\": ";
+		writeJsonString(out, typeName(graph, n));
+		out << ", \"visits\": " << counters.visits
+			<< ", \"evaluate_ns\": " << counters.evaluateNs;
+
+		out << ", \"slots\": {";
+		bool first = true;
+		for (int i = 0; i < (int)counters.slots.size(); ++i) {
+			if (counters.slots[i] != 0) {
+				out << (first ? " " : ", ") << "\"" << i << "\": "
+					<< counters.slots[i];
+				first = false;
+			}
+		}
+		out << " }, \"histogram\": {";
+		first = true;
+		for (int i = 0; i < BUCKETS; ++i) {
+			if (counters.histogram[i] != 0) {
+				out << (first ? " " : ", ") << "\"" << bucketBound(i)
+					<< "\": " << counters.histogram[i];
+				first = false;
+			}
+		}
+		out << " } }";
+	}
+	out << "\n\t]\n}\n";
+}
+
+int64_t GestureProfile::now() {
+#ifdef _WIN32
+	static LARGE_INTEGER frequency;
+	if (frequency.QuadPart == 0)
+		QueryPerformanceFrequency(&frequency);
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	int64_t seconds = counter.QuadPart / frequency.QuadPart;
+	int64_t remainder = counter.QuadPart % frequency.QuadPart;
+	return seconds * 1000000000
+			+ remainder * 1000000000 / frequency.QuadPart;
+#else
+	timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (int64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+#endif
+}
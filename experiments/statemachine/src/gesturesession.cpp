@@ -0,0 +1,185 @@
+/*
+	Philip Romano
+	10/16/2026
+	gesturesession.cpp
+*/
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include "gesturesession.h"
+#include "compiledgesturegraph.h"
+#include "gesturestategraph.h"
+#include "gesturetrace.h"
+#include "gestureprofile.h"
+#include "gesturelatency.h"
+#include "gesturememo.h"
+#include "handframe.h"
+#include "featureframe.h"
+
+/*
+   GestureSession
+*/
+
+GestureSession::GestureSession(GestureSessionSet *set, int index)
+		: mSet(set), mIndex(index) {
+
+}
+
+void GestureSession::update(const HandFrame& frame) {
+	mSet->rejectHandFrames();
+	mSet->step(mIndex, frame, &mSet->mMemo);
+}
+
+void GestureSession::update(const FeatureFrame& frame) {
+	mSet->step(mIndex, frame, &mSet->mMemo);
+}
+
+void GestureSession::reset() {
+	mSet->mCurrent[mIndex] = mSet->mGraph->getStart();
+	mSet->mTimeEntered[mIndex] = 0;
+
+	int size = mSet->mGraph->getStateSize();
+	if (size > 0)
+		std::copy(mSet->mGraph->getInitialState(),
+				mSet->mGraph->getInitialState() + size,
+				mSet->getStates(mIndex));
+}
+
+GestureSession::NodeHandle GestureSession::getCurrentNode() const {
+	return mSet->mCurrent[mIndex];
+}
+
+const std::string& GestureSession::getCurrentId() const {
+	return mSet->mGraph->getNodeId(mSet->mCurrent[mIndex]);
+}
+
+int64_t GestureSession::getTimeEntered() const {
+	return mSet->mTimeEntered[mIndex];
+}
+
+int GestureSession::getIndex() const {
+	return mIndex;
+}
+
+
+/*
+   GestureSessionSet
+*/
+
+GestureSessionSet::GestureSessionSet(
+		boost::shared_ptr<const CompiledGestureGraph> graph)
+		: mGraph(graph) {
+	mMemo.resize(mGraph->getMemoSize());
+}
+
+GestureSessionSet::~GestureSessionSet() {
+
+}
+
+GestureSession GestureSessionSet::createSession() {
+	mCurrent.push_back(mGraph->getStart());
+	mTimeEntered.push_back(0);
+	mStates.insert(mStates.end(), mGraph->getInitialState(),
+			mGraph->getInitialState() + mGraph->getStateSize());
+	return GestureSession(this, mCurrent.size() - 1);
+}
+
+GestureSession GestureSessionSet::getSession(int index) {
+	return GestureSession(this, index);
+}
+
+int GestureSessionSet::size() const {
+	return mCurrent.size();
+}
+
+void GestureSessionSet::clear() {
+	mCurrent.clear();
+	mTimeEntered.clear();
+	mStates.clear();
+}
+
+void GestureSessionSet::update(const HandFrame& frame) {
+	rejectHandFrames();
+	int count = mCurrent.size();
+	for (int i = 0; i < count; ++i)
+		step(i, frame, &mMemo);
+}
+
+void GestureSessionSet::update(const FeatureFrame& frame) {
+	int count = mCurrent.size();
+	for (int i = 0; i < count; ++i)
+		step(i, frame, &mMemo);
+}
+
+void GestureSessionSet::update(const std::vector<HandFrame>& frames) {
+	rejectHandFrames();
+	int count = mCurrent.size();
+	for (int i = 0; i < count; ++i)
+		step(i, frames[i], &mMemo);
+}
+
+void GestureSessionSet::update(const std::vector<FeatureFrame>& frames) {
+	int count = mCurrent.size();
+	for (int i = 0; i < count; ++i)
+		step(i, frames[i], &mMemo);
+}
+
+void GestureSessionSet::updateSession(int i, const HandFrame& frame) {
+	rejectHandFrames();
+	step(i, frame, NULL);
+}
+
+void GestureSessionSet::updateSession(int i, const FeatureFrame& frame) {
+	step(i, frame, NULL);
+}
+
+const CompiledGestureGraph& GestureSessionSet::getGraph() const {
+	return *mGraph;
+}
+
+void GestureSessionSet::setTrace(boost::shared_ptr<GestureTrace> trace) {
+	mTrace = trace;
+}
+
+void GestureSessionSet::setProfile(boost::shared_ptr<GestureProfile> profile) {
+	mProfile = profile;
+}
+
+void GestureSessionSet::setLatency(boost::shared_ptr<GestureLatency> latency) {
+	mLatency = latency;
+}
+
+
+/*
+   Private member functions
+*/
+
+void GestureSessionSet::step(int i, const HandFrame& frame,
+		GestureMemo *memo) {
+	NodeHandle next = mGraph->advance(frame, mCurrent[i], getStates(i),
+			memo, mTrace.get(), mProfile.get(), i, mLatency.get());
+	if (next != mCurrent[i]) {
+		mCurrent[i] = next;
+		mTimeEntered[i] = frame.timestamp;
+	}
+}
+
+void GestureSessionSet::rejectHandFrames() const {
+	// The feature nodes would read past the end of a plain frame
+	if (mGraph->readsFeatures())
+		throw GestureStateException(
+				"Graph reads features and must be fed FeatureFrames");
+}
+
+char* GestureSessionSet::getStates(int i) {
+	int size = mGraph->getStateSize();
+	if (size > 0)
+		return &mStates[i * size];
+	else
+		return NULL;
+}
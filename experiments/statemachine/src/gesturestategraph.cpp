@@ -6,16 +6,26 @@
 
 #include <string>
 #include <map>
-#include <iostream>
+#include <vector>
+#include <ostream>
 
 #include <boost/shared_ptr.hpp>
 
-#include <Leap.h>
-
 #include "gesturestategraph.h"
+#include "compiledgesturegraph.h"
 #include "gesturenode.h"
+#include "gesturetrace.h"
+#include "gestureprofile.h"
+#include "gesturelatency.h"
+#include "gesturememo.h"
+#include "handframe.h"
+#include "featureframe.h"
+
+const GestureStateGraph::NodeHandle GestureStateGraph::INVALID_NODE;
+const GestureStateGraph::TypeHandle GestureStateGraph::INVALID_TYPE;
 
-GestureStateGraph::GestureStateGraph() {
+GestureStateGraph::GestureStateGraph()
+		: mStartNode(INVALID_NODE), mCurrentNode(INVALID_NODE) {
 
 }
 
@@ -23,64 +33,175 @@ GestureStateGraph::~GestureStateGraph() {
 
 }
 
-bool GestureStateGraph::createNodeType(boost::shared_ptr<GestureNode> type) {
+GestureStateGraph::TypeHandle GestureStateGraph::createNodeType(
+		boost::shared_ptr<GestureNode> type) {
 	if (type->getName().size() == 0)
-		return false;
+		return INVALID_TYPE;
+
+	TypeHandle handle = mTypes.size();
+	std::pair< std::map<std::string,TypeHandle>::iterator,bool >
+			result = mTypeIndex.insert(
+			std::pair<std::string,TypeHandle>(type->getName(), handle));
+	if (!result.second)
+		return INVALID_TYPE;
 
-	std::pair< std::map<std::string,boost::shared_ptr<GestureNode> >::iterator,
-	bool >
-			result = mTypes.insert(
-			std::pair<std::string,boost::shared_ptr<GestureNode> >
-			(type->getName(), type));
-	return result.second;
+	mTypes.push_back(type);
+	return handle;
 }
 
 boost::shared_ptr<GestureNode> GestureStateGraph::removeNodeType(
 		const std::string& name) {
-	std::map<std::string,boost::shared_ptr<GestureNode> >::iterator it;
-	it = mTypes.find(name);
-	if (it == mTypes.end())
+	std::map<std::string,TypeHandle>::iterator it;
+	it = mTypeIndex.find(name);
+	if (it == mTypeIndex.end())
 		return boost::shared_ptr<GestureNode>();
 	else {
-		boost::shared_ptr<GestureNode> value = it->second;
-		mTypes.erase(it);
+		boost::shared_ptr<GestureNode> value = mTypes[it->second];
+		mTypes[it->second].reset();
+		mTypeIndex.erase(it);
+		mCompiled.reset();
 		return value;
 	}
 }
 
-bool GestureStateGraph::addNode(const std::string& type,
+GestureStateGraph::TypeHandle GestureStateGraph::getTypeHandle(
+		const std::string& type) {
+	std::map<std::string,TypeHandle>::iterator it = mTypeIndex.find(type);
+	if (it == mTypeIndex.end())
+		return INVALID_TYPE;
+	else
+		return it->second;
+}
+
+GestureStateGraph::NodeHandle GestureStateGraph::addNode(
+		const std::string& type, const std::string& nodeid) {
+	return addNode(getTypeHandle(type), nodeid);
+}
+
+GestureStateGraph::NodeHandle GestureStateGraph::addNode(TypeHandle type,
 		const std::string& nodeid) {
 	if (!getType(type).get())
-		return false;
+		return INVALID_NODE;
 
-	std::pair< std::map<std::string,NodeInstance >::iterator,bool >
-			result = mNodes.insert(
-			std::pair<std::string,NodeInstance>(
-				nodeid, NodeInstance(type)));
+	NodeHandle handle;
+	if (mFreeNodes.empty())
+		handle = mNodes.size();
+	else
+		handle = mFreeNodes.back();
+
+	std::pair< std::map<std::string,NodeHandle>::iterator,bool >
+			result = mNodeIndex.insert(
+			std::pair<std::string,NodeHandle>(nodeid, handle));
 
 	if (result.second) {
+		GestureNode *node = mTypes[type].get();
+		int size = node->getStateSize();
+		int offset = -1;
+		int capacity = 0;
+		if (!mFreeNodes.empty())
+			mFreeNodes.pop_back();
+		if (size > 0) {
+			offset = allocateState(size, capacity);
+			node->initState(&mStates[offset]);
+		}
+
+		if (handle == (NodeHandle)mNodes.size())
+			mNodes.push_back(NodeInstance(type, nodeid, offset, capacity));
+		else
+			mNodes[handle] = NodeInstance(type, nodeid, offset, capacity);
+		mCompiled.reset();
+
 		// Initialize start and current nodes, if this is the first node added
-		if (mStartNode.size() == 0) {
-			mStartNode = nodeid;
-			mCurrentNode = nodeid;
+		// (or the start node was removed)
+		if (mStartNode == INVALID_NODE) {
+			mStartNode = handle;
+			if (mCurrentNode == INVALID_NODE)
+				mCurrentNode = handle;
 		}
-		return true;
+		return handle;
 	} else
-		return false;
+		return INVALID_NODE;
 }
 
 bool GestureStateGraph::removeNode(const std::string& nodeid) {
-	// TODO implement!
-	return false;
+	return removeNode(getNode(nodeid));
+}
+
+bool GestureStateGraph::removeNode(NodeHandle node) {
+	if (!nodeExists(node))
+		return false;
+
+	NodeInstance& instance = mNodes[node];
+
+	// Each disconnect() removes one entry from the incoming list
+	while (!instance.incoming.empty()) {
+		const Edge& edge = instance.incoming.back();
+		disconnect(edge.node, edge.slot);
+	}
+	for (int slot = 0; slot < (int)instance.slots.size(); ++slot)
+		disconnect(node, slot);
+
+	mNodeIndex.erase(instance.id);
+	instance.id.clear();
+	instance.slots.clear();
+	instance.slotEdges.clear();
+	instance.enterAction.clear();
+	instance.leaveAction.clear();
+	instance.removed = true;
+	mFreeNodes.push_back(node);
+
+	// The state block goes back to the arena, for whichever stateful node
+	// is added next
+	if (instance.stateOffset >= 0) {
+		mFreeStates.push_back(StateBlock(instance.stateOffset,
+				instance.stateCapacity));
+		instance.stateOffset = -1;
+		instance.stateCapacity = 0;
+	}
+
+	if (mStartNode == node)
+		mStartNode = INVALID_NODE;
+	if (mCurrentNode == node)
+		mCurrentNode = mStartNode;
+
+	mCompiled.reset();
+	return true;
 }
 
 bool GestureStateGraph::nodeExists(const std::string& nodeid) {
-	return (mNodes.count(nodeid) > 0);
+	return (mNodeIndex.count(nodeid) > 0);
+}
+
+bool GestureStateGraph::nodeExists(NodeHandle node) {
+	return (node >= 0 && node < (NodeHandle)mNodes.size()
+			&& !mNodes[node].removed);
+}
+
+GestureStateGraph::NodeHandle GestureStateGraph::getNode(
+		const std::string& nodeid) {
+	std::map<std::string,NodeHandle>::iterator it = mNodeIndex.find(nodeid);
+	if (it == mNodeIndex.end())
+		return INVALID_NODE;
+	else
+		return it->second;
+}
+
+const std::string& GestureStateGraph::getNodeId(NodeHandle node) {
+	static const std::string none;
+	if (nodeExists(node))
+		return mNodes[node].id;
+	else
+		return none;
 }
 
 bool GestureStateGraph::setStart(const std::string& nodeid) {
-	if (nodeExists(nodeid)) {
-		mStartNode = nodeid;
+	return setStart(getNode(nodeid));
+}
+
+bool GestureStateGraph::setStart(NodeHandle node) {
+	if (nodeExists(node)) {
+		mStartNode = node;
+		mCompiled.reset();
 		return true;
 	} else
 		return false;
@@ -94,97 +215,233 @@ boost::shared_ptr<GestureNode> GestureStateGraph::getCurrentState() {
 	return getTypeFromNode(mCurrentNode);
 }
 
+GestureStateGraph::NodeHandle GestureStateGraph::getStartNode() {
+	return mStartNode;
+}
+
+GestureStateGraph::NodeHandle GestureStateGraph::getCurrentNode() {
+	return mCurrentNode;
+}
+
 bool GestureStateGraph::addConnection(const std::string& start, int slot,
 		const std::string& end) {
-	if (nodeExists(start) && nodeExists(end)) {
-		std::map<int,std::string>& slots = getAdjacencies(start);
-		slots[slot] = end;
+	return addConnection(getNode(start), slot, getNode(end));
+}
+
+bool GestureStateGraph::addConnection(NodeHandle start, int slot,
+		NodeHandle end) {
+	if (nodeExists(start) && nodeExists(end) && slot >= 0) {
+		connect(start, slot, end);
+		mCompiled.reset();
+		return true;
+	} else
+		return false;
+}
+
+bool GestureStateGraph::setEnterAction(const std::string& nodeid,
+		const Action& action) {
+	return setEnterAction(getNode(nodeid), action);
+}
+
+bool GestureStateGraph::setEnterAction(NodeHandle node,
+		const Action& action) {
+	if (nodeExists(node)) {
+		mNodes[node].enterAction = action;
+		mCompiled.reset();
+		return true;
+	} else
+		return false;
+}
+
+bool GestureStateGraph::setLeaveAction(const std::string& nodeid,
+		const Action& action) {
+	return setLeaveAction(getNode(nodeid), action);
+}
+
+bool GestureStateGraph::setLeaveAction(NodeHandle node,
+		const Action& action) {
+	if (nodeExists(node)) {
+		mNodes[node].leaveAction = action;
+		mCompiled.reset();
 		return true;
 	} else
 		return false;
 }
 
 bool GestureStateGraph::removeConnection(const std::string& start, int slot) {
-	if (nodeExists(start)) {
-		std::map<int,std::string>& slots = getAdjacencies(start);
-		return (slots.erase(slot) == 1);
+	return removeConnection(getNode(start), slot);
+}
+
+bool GestureStateGraph::removeConnection(NodeHandle start, int slot) {
+	if (getSlot(start, slot) != INVALID_NODE) {
+		disconnect(start, slot);
+		mCompiled.reset();
+		return true;
 	} else
 		return false;
 }
 
 std::string GestureStateGraph::getSlot(const std::string& nodeid, int slot) {
-	if (nodeExists(nodeid)) {
-		std::map<int,std::string> adjacencies = getAdjacencies(nodeid);
-		std::map<int,std::string>::iterator it = adjacencies.find(slot);
-		if (it != adjacencies.end())
-			return it->second;
+	return getNodeId(getSlot(getNode(nodeid), slot));
+}
+
+GestureStateGraph::NodeHandle GestureStateGraph::getSlot(NodeHandle node,
+		int slot) {
+	if (nodeExists(node)) {
+		const std::vector<NodeHandle>& slots = mNodes[node].slots;
+		if (slot >= 0 && slot < (int)slots.size())
+			return slots[slot];
 		else
-			return std::string();
+			return INVALID_NODE;
 	} else
-		return std::string();
+		return INVALID_NODE;
 }
 
-void GestureStateGraph::update(const Leap::Frame& frame) {
-	std::string newCurrent = mCurrentNode;
-	do {
-		if (mCurrentNode.compare(newCurrent) != 0)
-			setCurrent(newCurrent, frame);
+void GestureStateGraph::clear() {
+	mNodes.clear();
+	mNodeIndex.clear();
+	mFreeNodes.clear();
+	mStates.clear();
+	mFreeStates.clear();
+	mStartNode = INVALID_NODE;
+	mCurrentNode = INVALID_NODE;
+	mCompiled.reset();
+}
 
-		boost::shared_ptr<GestureNode> node = getTypeFromNode(mCurrentNode);
-		if (node.get()) {
-			int slot = node->evaluate(frame, mCurrentNode);
-			newCurrent = getSlot(mCurrentNode, slot);
+boost::shared_ptr<const CompiledGestureGraph> GestureStateGraph::compile() {
+	if (mCompiled.get())
+		return mCompiled;
+
+	boost::shared_ptr<CompiledGestureGraph> compiled(
+			new CompiledGestureGraph());
+	compiled->mStart = mStartNode;
+	compiled->mSlotOffsets.reserve(mNodes.size() + 1);
+	compiled->mSlotOffsets.push_back(0);
+
+	// Pure types without state are numbered for memoization, in order of
+	// first use
+	std::vector<int> memoIndex(mTypes.size(), -1);
+
+	for (std::vector<NodeInstance>::iterator it = mNodes.begin();
+			it != mNodes.end(); ++it) {
+		// Removed nodes keep their handle, with no type and no slots
+		boost::shared_ptr<GestureNode> type;
+		if (!it->removed)
+			type = getType(it->type);
+		compiled->mNodeTypes.push_back(type.get());
+		compiled->mTypes.push_back(type);
+		compiled->mNodeIds.push_back(it->id);
+		compiled->mStateOffsets.push_back(it->stateOffset);
+		if (type.get() && type->readsFeatures())
+			compiled->mReadsFeatures = true;
+		if (type.get() && type->isPure() && type->getStateSize() == 0) {
+			if (memoIndex[it->type] < 0)
+				memoIndex[it->type] = compiled->mMemoSize++;
+			compiled->mMemoIndex.push_back(memoIndex[it->type]);
 		} else
-			newCurrent = "";
-	} while (newCurrent.compare(mCurrentNode) != 0 && newCurrent.size() > 0);
+			compiled->mMemoIndex.push_back(-1);
+		compiled->mEnterActions.push_back(it->enterAction);
+		compiled->mLeaveActions.push_back(it->leaveAction);
+		compiled->mSlotTargets.insert(compiled->mSlotTargets.end(),
+				it->slots.begin(), it->slots.end());
+		compiled->mSlotOffsets.push_back(compiled->mSlotTargets.size());
+	}
+
+	// Fresh state for new sessions, laid out the same as mStates
+	compiled->mInitialState.resize(mStates.size());
+	for (std::vector<NodeInstance>::iterator it = mNodes.begin();
+			it != mNodes.end(); ++it) {
+		if (!it->removed && it->stateOffset >= 0 && getType(it->type).get())
+			getType(it->type)->initState(
+					&compiled->mInitialState[it->stateOffset]);
+	}
+
+	compiled->validate();
 
-	if (newCurrent.size() == 0)
-		setCurrent(mStartNode, frame);
-	else if (mCurrentNode.compare(newCurrent) != 0)
-		setCurrent(newCurrent, frame);
+	mMemo.resize(compiled->getMemoSize());
+	mCompiled = compiled;
+	return mCompiled;
+}
+
+void GestureStateGraph::update(const HandFrame& frame) {
+	if (mCurrentNode == INVALID_NODE)
+		return;
+
+	if (!mCompiled.get())
+		compile();
+
+	// The feature nodes would read past the end of a plain frame
+	if (mCompiled->readsFeatures())
+		throw GestureStateException(
+				"Graph reads features and must be fed FeatureFrames");
+	advance(frame);
+}
+
+void GestureStateGraph::update(const FeatureFrame& frame) {
+	advance(frame);
 }
 
 boost::shared_ptr<GestureNode> GestureStateGraph::getType(
 		const std::string& name) {
-	std::map< std::string,boost::shared_ptr<GestureNode> >::iterator
-		it = mTypes.find(name);
-	if (it == mTypes.end())
+	return getType(getTypeHandle(name));
+}
+
+boost::shared_ptr<GestureNode> GestureStateGraph::getType(TypeHandle type) {
+	if (type < 0 || type >= (TypeHandle)mTypes.size())
 		return boost::shared_ptr<GestureNode>();
 	else
-		return it->second;
+		return mTypes[type];
 }
 
 boost::shared_ptr<GestureNode> GestureStateGraph::getTypeFromNode(
 		const std::string& nodeid) {
-	std::map<std::string,NodeInstance>::iterator it = mNodes.find(nodeid);
-	if (it == mNodes.end())
-		return boost::shared_ptr<GestureNode>();
+	return getTypeFromNode(getNode(nodeid));
+}
+
+boost::shared_ptr<GestureNode> GestureStateGraph::getTypeFromNode(
+		NodeHandle node) {
+	if (nodeExists(node))
+		return getType(mNodes[node].type);
 	else
-		return getType((it->second).type);
+		return boost::shared_ptr<GestureNode>();
 }
 
-void GestureStateGraph::updateWithPrint(const Leap::Frame& frame) {
-	std::string newCurrent = mCurrentNode;
-	do {
-		if (mCurrentNode.compare(newCurrent) != 0) {
-			std::cout << newCurrent << std::endl;
-			setCurrent(newCurrent, frame);
-		}
+void GestureStateGraph::setTrace(boost::shared_ptr<GestureTrace> trace) {
+	mTrace = trace;
+}
 
-		boost::shared_ptr<GestureNode> node = getTypeFromNode(mCurrentNode);
-		if (node.get()) {
-			int slot = node->evaluate(frame, mCurrentNode);
-			newCurrent = getSlot(mCurrentNode, slot);
-		} else
-			newCurrent = "";
-	} while (newCurrent.compare(mCurrentNode) != 0 && newCurrent.size() > 0);
+boost::shared_ptr<GestureTrace> GestureStateGraph::getTrace() {
+	return mTrace;
+}
+
+bool GestureStateGraph::writeTrace(std::ostream& out) {
+	if (!mTrace.get())
+		return false;
+
+	std::vector<std::string> nodeIds;
+	nodeIds.reserve(mNodes.size());
+	for (std::vector<NodeInstance>::iterator it = mNodes.begin();
+			it != mNodes.end(); ++it)
+		nodeIds.push_back(it->id);
 
-	if (newCurrent.size() == 0)
-		setCurrent(mStartNode, frame);
-	else if (mCurrentNode.compare(newCurrent) != 0)
-		setCurrent(newCurrent, frame);
+	mTrace->write(out, nodeIds);
+	return true;
+}
+
+void GestureStateGraph::setProfile(boost::shared_ptr<GestureProfile> profile) {
+	mProfile = profile;
+}
+
+boost::shared_ptr<GestureProfile> GestureStateGraph::getProfile() {
+	return mProfile;
+}
+
+void GestureStateGraph::setLatency(boost::shared_ptr<GestureLatency> latency) {
+	mLatency = latency;
+}
 
-	std::cout << "STATE: " << mCurrentNode << std::endl;
+boost::shared_ptr<GestureLatency> GestureStateGraph::getLatency() {
+	return mLatency;
 }
 
 
@@ -192,21 +449,69 @@ void GestureStateGraph::updateWithPrint(const Leap::Frame& frame) {
    Private member functions
 */
 
-std::map<int,std::string>& GestureStateGraph::getAdjacencies(
-		const std::string& nodeid) {
-	std::map<std::string,NodeInstance>::iterator it = mNodes.find(nodeid);
-	if (it == mNodes.end())
-		throw GestureStateException();
-	else
-		return (it->second).slots;
+void GestureStateGraph::connect(NodeHandle start, int slot, NodeHandle end) {
+	disconnect(start, slot);
+
+	NodeInstance& instance = mNodes[start];
+	if (slot >= (int)instance.slots.size()) {
+		instance.slots.resize(slot + 1, INVALID_NODE);
+		instance.slotEdges.resize(slot + 1, -1);
+	}
+
+	std::vector<Edge>& incoming = mNodes[end].incoming;
+	instance.slots[slot] = end;
+	instance.slotEdges[slot] = incoming.size();
+	incoming.push_back(Edge(start, slot));
 }
 
-void GestureStateGraph::setCurrent(const std::string& nodeid,
-		const Leap::Frame& frame) {
-	boost::shared_ptr<GestureNode> previous = getTypeFromNode(mCurrentNode);
-	boost::shared_ptr<GestureNode> next = getTypeFromNode(nodeid);
-	previous->onLeave(frame, mCurrentNode);
-	next->onEnter(frame, nodeid);
-	mCurrentNode = nodeid;
+void GestureStateGraph::disconnect(NodeHandle start, int slot) {
+	NodeInstance& instance = mNodes[start];
+	if (slot >= (int)instance.slots.size()
+			|| instance.slots[slot] == INVALID_NODE)
+		return;
+
+	// Swap the edge with the last one in the target's incoming list, so it
+	// can be removed in constant time
+	std::vector<Edge>& incoming = mNodes[instance.slots[slot]].incoming;
+	int position = instance.slotEdges[slot];
+	const Edge& last = incoming.back();
+	mNodes[last.node].slotEdges[last.slot] = position;
+	incoming[position] = last;
+	incoming.pop_back();
+
+	instance.slots[slot] = INVALID_NODE;
+	instance.slotEdges[slot] = -1;
 }
 
+void GestureStateGraph::advance(const HandFrame& frame) {
+	if (mCurrentNode == INVALID_NODE)
+		return;
+
+	if (!mCompiled.get())
+		compile();
+	mCurrentNode = mCompiled->advance(frame, mCurrentNode,
+			mStates.empty() ? NULL : &mStates[0], &mMemo, mTrace.get(),
+			mProfile.get(), 0, mLatency.get());
+}
+
+int GestureStateGraph::allocateState(int size, int& capacity) {
+	int best = -1;
+	for (int b = 0; b < (int)mFreeStates.size(); ++b) {
+		if (mFreeStates[b].capacity >= size && (best < 0
+				|| mFreeStates[b].capacity < mFreeStates[best].capacity))
+			best = b;
+	}
+
+	if (best >= 0) {
+		StateBlock block = mFreeStates[best];
+		mFreeStates[best] = mFreeStates.back();
+		mFreeStates.pop_back();
+		capacity = block.capacity;
+		return block.offset;
+	}
+
+	int offset = CompiledGestureGraph::alignState(mStates.size());
+	capacity = size;
+	mStates.resize(offset + size);
+	return offset;
+}
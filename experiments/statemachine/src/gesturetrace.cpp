@@ -0,0 +1,177 @@
+/*
+	Philip Romano
+	10/16/2026
+	gesturetrace.cpp
+*/
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <atomic>
+#include <stdint.h>
+
+#include "gesturetrace.h"
+
+namespace {
+	const char MAGIC[4] = { 'G', 'S', 'T', 'R' };
+	const uint32_t VERSION = 1;
+
+	template <class T>
+	void writeValue(std::ostream& out, const T& value) {
+		out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <class T>
+	bool readValue(std::istream& in, T& value) {
+		in.read(reinterpret_cast<char*>(&value), sizeof(T));
+		return in.good();
+	}
+}
+
+GestureTrace::GestureTrace(int capacity)
+		: mHead(0), mClaimed(0) {
+	int size = 1;
+	while (size < capacity)
+		size *= 2;
+	mRecords.resize(size);
+	mMask = size - 1;
+}
+
+GestureTrace::~GestureTrace() {
+
+}
+
+void GestureTrace::record(int64_t timestamp, int from, int to, int slot,
+		int session) {
+	uint64_t index = mHead.load(std::memory_order_relaxed);
+
+	// Readers that copy this slot while it is being written see mClaimed
+	// move past it, and discard it
+	mClaimed.store(index + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	TraceRecord& record = mRecords[index & mMask];
+	record.timestamp = timestamp;
+	record.from = from;
+	record.to = to;
+	record.slot = slot;
+	record.session = session;
+
+	mHead.store(index + 1, std::memory_order_release);
+}
+
+int GestureTrace::getCapacity() const {
+	return mRecords.size();
+}
+
+uint64_t GestureTrace::getCount() const {
+	return mHead.load(std::memory_order_acquire);
+}
+
+void GestureTrace::snapshot(std::vector<TraceRecord>& records) const {
+	uint64_t capacity = mRecords.size();
+	uint64_t head = mHead.load(std::memory_order_acquire);
+	uint64_t first = (head > capacity) ? head - capacity : 0;
+
+	records.clear();
+	records.reserve(head - first);
+	for (uint64_t i = first; i < head; ++i)
+		records.push_back(mRecords[i & mMask]);
+
+	// Anything the writer has started since may have overwritten the
+	// oldest records that were copied
+	std::atomic_thread_fence(std::memory_order_acquire);
+	uint64_t claimed = mClaimed.load(std::memory_order_relaxed);
+	if (claimed > first + capacity) {
+		uint64_t stale = claimed - capacity - first;
+		if (stale > records.size())
+			stale = records.size();
+		records.erase(records.begin(), records.begin() + stale);
+	}
+}
+
+void GestureTrace::write(std::ostream& out,
+		const std::vector<std::string>& nodeIds) const {
+	std::vector<TraceRecord> records;
+	snapshot(records);
+
+	out.write(MAGIC, sizeof(MAGIC));
+	writeValue(out, VERSION);
+
+	writeValue(out, (uint32_t)nodeIds.size());
+	for (std::vector<std::string>::const_iterator it = nodeIds.begin();
+			it != nodeIds.end(); ++it) {
+		writeValue(out, (uint32_t)it->size());
+		out.write(it->data(), it->size());
+	}
+
+	writeValue(out, (uint64_t)records.size());
+	if (!records.empty())
+		out.write(reinterpret_cast<const char*>(&records[0]),
+				records.size() * sizeof(TraceRecord));
+}
+
+bool GestureTrace::read(std::istream& in, std::vector<std::string>& nodeIds,
+		std::vector<TraceRecord>& records) {
+	char magic[sizeof(MAGIC)];
+	uint32_t version;
+	in.read(magic, sizeof(magic));
+	if (!in.good() || std::string(magic, sizeof(magic))
+			!= std::string(MAGIC, sizeof(MAGIC)))
+		return false;
+	if (!readValue(in, version) || version != VERSION)
+		return false;
+
+	uint32_t nodeCount;
+	if (!readValue(in, nodeCount))
+		return false;
+	nodeIds.clear();
+	for (uint32_t i = 0; i < nodeCount; ++i) {
+		uint32_t length;
+		if (!readValue(in, length))
+			return false;
+		std::string id(length, '\0');
+		if (length > 0)
+			in.read(&id[0], length);
+		if (!in.good())
+			return false;
+		nodeIds.push_back(id);
+	}
+
+	uint64_t recordCount;
+	if (!readValue(in, recordCount))
+		return false;
+	records.clear();
+	for (uint64_t i = 0; i < recordCount; ++i) {
+		TraceRecord record;
+		in.read(reinterpret_cast<char*>(&record), sizeof(record));
+		if (in.gcount() != sizeof(record))
+			return false;
+		records.push_back(record);
+	}
+	return true;
+}
+
+void GestureTrace::print(std::ostream& out,
+		const std::vector<std::string>& nodeIds,
+		const std::vector<TraceRecord>& records) {
+	for (std::vector<TraceRecord>::const_iterator it = records.begin();
+			it != records.end(); ++it) {
+		out << it->timestamp << " " << it->session << ": ";
+
+		if (it->from >= 0 && it->from < (int32_t)nodeIds.size())
+			out << nodeIds[it->from];
+		else
+			out << "#" << it->from;
+
+		out << " -" << it->slot << "-> ";
+
+		if (it->to >= 0 && it->to < (int32_t)nodeIds.size())
+			out << nodeIds[it->to];
+		else
+			out << "#" << it->to;
+
+		out << "\n";
+	}
+}
@@ -0,0 +1,136 @@
+/*
+	Philip Romano
+	10/16/2026
+	handblock.cpp
+*/
+
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+
+#include "handblock.h"
+#include "handframe.h"
+
+namespace {
+	const Vector3 ZERO = { 0.0f, 0.0f, 0.0f };
+
+	// Frames reduced together: a fixed count, which the compiler turns
+	// into vector operations without checks or a scalar remainder
+	const int LANES = 8;
+
+	// Floats in a cache line. Columns a multiple of 4 KB apart fall in
+	// the same cache sets, and evict each other as load() fills them all
+	const int LINE = 16;
+
+	/**
+	  Reduce one axis of frames [0, count), rounded up to LANES: out is
+	  the sum of the tips, from zero and in finger order, divided by the
+	  divisors, plus the palm, times the scales.
+	*/
+	void reduceAxis(const float *const *tips, const float *palm,
+			const float *divisors, const float *scales, float *out,
+			int count) {
+		for (int b = 0; b < count; b += LANES) {
+			float sum[LANES];
+			for (int k = 0; k < LANES; ++k)
+				sum[k] = 0.0f;
+			for (int f = 0; f < HandData::MAX_FINGERS; ++f) {
+				for (int k = 0; k < LANES; ++k)
+					sum[k] += tips[f][b + k];
+			}
+			for (int k = 0; k < LANES; ++k) {
+				sum[k] = (sum[k] / divisors[b + k] + palm[b + k])
+					* scales[b + k];
+			}
+
+			// Stored once every column is read, out being a column too
+			for (int k = 0; k < LANES; ++k)
+				out[b + k] = sum[k];
+		}
+	}
+}
+
+HandBlock::HandBlock(int capacity)
+		: mCapacity(std::max(capacity, 1)), mSize(0),
+		  mStride((mCapacity + LANES - 1) / LANES * LANES + LINE),
+		  mColumns((size_t)mStride * COLUMNS, 0.0f),
+		  mHasHand(mCapacity, 0) {
+	std::fill(column(DIVISOR), column(DIVISOR) + mStride, 1.0f);
+	std::fill(column(SCALE), column(SCALE) + mStride, 1.0f);
+}
+
+int HandBlock::load(const HandFrame *frames, int count, int hand) {
+	mSize = std::min(std::max(count, 0), mCapacity);
+	float *divisors = column(DIVISOR);
+	float *scales = column(SCALE);
+	for (int i = 0; i < mSize; ++i) {
+		const HandFrame& frame = frames[i];
+		bool present = hand >= 0 && hand < frame.handCount
+			&& hand < HandFrame::MAX_HANDS;
+		const HandData *data = present ? &frame.hands[hand] : NULL;
+		int fingers = present ? std::min(std::max(data->fingerCount, 0),
+				(int)HandData::MAX_FINGERS) : 0;
+
+		mHasHand[i] = present ? 1 : 0;
+		for (int f = 0; f < HandData::MAX_FINGERS; ++f) {
+			const Vector3& tip = (f < fingers)
+				? data->fingers[f].tipVelocity : ZERO;
+			column(TIP_X + f)[i] = tip.x;
+			column(TIP_Y + f)[i] = tip.y;
+			column(TIP_Z + f)[i] = tip.z;
+		}
+
+		const Vector3& palm = present ? data->palmVelocity : ZERO;
+		column(PALM_X)[i] = palm.x;
+		column(PALM_Y)[i] = palm.y;
+		column(PALM_Z)[i] = palm.z;
+
+		// As getRawVelocity(): the mean of the fingers, averaged with the
+		// palm. Without fingers, the sum is zero and divided by one, and
+		// the palm is kept whole; halving is exact either way
+		divisors[i] = (fingers > 0) ? (float)fingers : 1.0f;
+		scales[i] = (fingers > 0) ? 0.5f : 1.0f;
+	}
+	return mSize;
+}
+
+void HandBlock::reduce() {
+	for (int axis = 0; axis < 3; ++axis) {
+		const float *tips[HandData::MAX_FINGERS];
+		for (int f = 0; f < HandData::MAX_FINGERS; ++f)
+			tips[f] = column(TIP_X + axis * HandData::MAX_FINGERS + f);
+		reduceAxis(tips, column(PALM_X + axis), column(DIVISOR),
+				column(SCALE), column(VELOCITY_X + axis), mSize);
+	}
+}
+
+int HandBlock::getCapacity() const {
+	return mCapacity;
+}
+
+int HandBlock::size() const {
+	return mSize;
+}
+
+bool HandBlock::hasHand(int i) const {
+	return mHasHand[i] != 0;
+}
+
+Vector3 HandBlock::getVelocity(int i) const {
+	Vector3 velocity = { column(VELOCITY_X)[i], column(VELOCITY_Y)[i],
+		column(VELOCITY_Z)[i] };
+	return velocity;
+}
+
+
+/*
+   Private member functions
+*/
+
+float* HandBlock::column(int c) {
+	return &mColumns[(size_t)c * mStride];
+}
+
+const float* HandBlock::column(int c) const {
+	return &mColumns[(size_t)c * mStride];
+}
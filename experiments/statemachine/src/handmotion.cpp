@@ -0,0 +1,128 @@
+/*
+	Philip Romano
+	10/16/2026
+	handmotion.cpp
+*/
+
+#include <cmath>
+#include <cstddef>
+#include <stdint.h>
+
+#include "handmotion.h"
+#include "handframe.h"
+#include "velocityfilter.h"
+
+namespace {
+	const Vector3 ZERO = { 0.0f, 0.0f, 0.0f };
+}
+
+HandMotion::HandMotion(int smoothing, int minFingers)
+		: mMinFingers(minFingers), mFilter(smoothing > 0 ? smoothing : 1) {
+	reset();
+}
+
+HandMotion::HandMotion(const VelocityFilter& filter, int minFingers)
+		: mMinFingers(minFingers), mFilter(filter) {
+	reset();
+}
+
+void HandMotion::setFilter(const VelocityFilter& filter) {
+	mFilter = filter;
+	reset();
+}
+
+const VelocityFilter& HandMotion::getFilter() const {
+	return mFilter;
+}
+
+int HandMotion::getMinFingers() const {
+	return mMinFingers;
+}
+
+void HandMotion::update(const HandFrame& frame) {
+	update(frame.handCount == 1 ? &frame.hands[0] : NULL, frame.timestamp);
+}
+
+void HandMotion::update(const HandFrame& frame, const Vector3& rawVelocity) {
+	follow(frame.handCount == 1 ? &frame.hands[0] : NULL, rawVelocity,
+			frame.timestamp);
+}
+
+void HandMotion::update(const HandData *hand, int64_t timestamp) {
+	// The raw velocity of a hand that is not followed is not needed
+	if (hand && hand->fingerCount >= mMinFingers)
+		follow(hand, getRawVelocity(*hand), timestamp);
+	else
+		reset();
+}
+
+void HandMotion::reset() {
+	mFilter.reset();
+	mHasHand = false;
+	mVelocity = ZERO;
+	mXYSpeed = 0.0f;
+}
+
+bool HandMotion::hasHand() const {
+	return mHasHand;
+}
+
+const HandData& HandMotion::getHand() const {
+	return mHand;
+}
+
+const Vector3& HandMotion::getVelocity() const {
+	return mVelocity;
+}
+
+const Vector3& HandMotion::getPosition() const {
+	return mFilter.getPosition();
+}
+
+float HandMotion::getXYSpeed() const {
+	return mXYSpeed;
+}
+
+Vector3 HandMotion::getRawVelocity(const HandData& hand) {
+	// Average of fingers + palm
+	Vector3 velocity = ZERO;
+	if (hand.fingerCount > 0) {
+		for (int i = 0; i < hand.fingerCount; ++i) {
+			velocity.x += hand.fingers[i].tipVelocity.x;
+			velocity.y += hand.fingers[i].tipVelocity.y;
+			velocity.z += hand.fingers[i].tipVelocity.z;
+		}
+		velocity.x /= (float)hand.fingerCount;
+		velocity.y /= (float)hand.fingerCount;
+		velocity.z /= (float)hand.fingerCount;
+	}
+	velocity.x += hand.palmVelocity.x;
+	velocity.y += hand.palmVelocity.y;
+	velocity.z += hand.palmVelocity.z;
+	if (hand.fingerCount > 0) {
+		velocity.x /= 2.0f;
+		velocity.y /= 2.0f;
+		velocity.z /= 2.0f;
+	}
+	return velocity;
+}
+
+
+/*
+   Private member functions
+*/
+
+void HandMotion::follow(const HandData *hand, const Vector3& rawVelocity,
+		int64_t timestamp) {
+	if (!hand || hand->fingerCount < mMinFingers) {
+		reset();
+		return;
+	}
+
+	mHasHand = true;
+	mHand = *hand;
+	mVelocity = mFilter.update(rawVelocity, mHand.palmPosition, timestamp);
+
+	mXYSpeed = std::sqrt(mVelocity.x * mVelocity.x
+			+ mVelocity.y * mVelocity.y);
+}
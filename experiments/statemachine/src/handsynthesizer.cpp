@@ -0,0 +1,341 @@
+/*
+	Philip Romano
+	10/16/2026
+	handsynthesizer.cpp
+*/
+
+#include <string>
+#include <vector>
+#include <cmath>
+#include <stdint.h>
+
+#include "handsynthesizer.h"
+#include "handframe.h"
+
+namespace {
+	const double PI = 3.14159265358979323846;
+
+	const char* const MOTION_NAMES[HandSynthesizer::MOTIONS] = {
+		"none",
+		"idle",
+		"left",
+		"right",
+		"up",
+		"down",
+		"push",
+		"pull",
+		"backtrack-left",
+		"backtrack-right",
+		"backtrack-up",
+		"backtrack-down"
+	};
+
+	// Height of the hands above the device, and spacing between them, in
+	// millimeters
+	const float REST_HEIGHT = 200.0f;
+	const float HAND_SPACING = 150.0f;
+
+	// splitmix64, to turn a seed into a well-mixed generator state
+	uint64_t mix(uint64_t x) {
+		x += 0x9e3779b97f4a7c15ULL;
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+		x = x ^ (x >> 31);
+		return x ? x : 1;
+	}
+
+	Vector3 makeVector(float x, float y, float z) {
+		Vector3 v;
+		v.x = x;
+		v.y = y;
+		v.z = z;
+		return v;
+	}
+}
+
+const int64_t HandSynthesizer::HAND_DELAY;
+
+HandSynthesizer::HandSynthesizer(double rate, uint64_t seed)
+		: mRate(rate > 0.0 ? rate : 100.0), mSeed(seed), mNoise(0.0f),
+		  mDropout(0.0), mHands(1), mFingers(4) {
+	clear();
+}
+
+void HandSynthesizer::setNoise(float noise) {
+	mNoise = (noise > 0.0f) ? noise : 0.0f;
+}
+
+void HandSynthesizer::setDropout(double probability) {
+	mDropout = probability;
+}
+
+void HandSynthesizer::setHands(int hands) {
+	if (hands < 1)
+		hands = 1;
+	else if (hands > HandFrame::MAX_HANDS)
+		hands = HandFrame::MAX_HANDS;
+	mHands = hands;
+}
+
+void HandSynthesizer::setFingers(int fingers) {
+	if (fingers < 0)
+		fingers = 0;
+	else if (fingers > HandData::MAX_FINGERS)
+		fingers = HandData::MAX_FINGERS;
+	mFingers = fingers;
+}
+
+void HandSynthesizer::addStep(Motion motion, int64_t duration, float speed) {
+	if (motion < NONE || motion >= MOTIONS || duration <= 0)
+		return;
+
+	Step step;
+	step.motion = motion;
+	step.duration = duration;
+	step.speed = speed;
+	mSteps.push_back(step);
+	mStarts.push_back(mStarts.back() + duration);
+}
+
+void HandSynthesizer::addRandomSteps(int count) {
+	// A stream of its own, so that the script does not depend on how many
+	// frames have been taken
+	uint64_t state = mix(mSeed ^ mix(mSteps.size()));
+
+	for (int i = 0; i < count; ++i) {
+		Motion motion = (Motion)(SWIPE_LEFT
+				+ (int)(uniform(state) * (MOTIONS - SWIPE_LEFT)));
+		bool backtrack = motion >= BACKTRACK_LEFT;
+		int64_t duration = backtrack
+				? 500000 + (int64_t)(uniform(state) * 300000)
+				: 250000 + (int64_t)(uniform(state) * 250000);
+		float speed = 600.0f + (float)(uniform(state) * 600.0);
+		addStep(motion, duration, speed);
+
+		if (uniform(state) < 0.1)
+			addStep(NONE, 300000 + (int64_t)(uniform(state) * 700000));
+		else
+			addStep(IDLE, 200000 + (int64_t)(uniform(state) * 400000));
+	}
+}
+
+const std::vector<HandSynthesizer::Step>& HandSynthesizer::getSteps() const {
+	return mSteps;
+}
+
+void HandSynthesizer::clear() {
+	mSteps.clear();
+	mStarts.assign(1, 0);
+	rewind();
+}
+
+void HandSynthesizer::rewind() {
+	mRandom = mix(mSeed);
+	mFrame = 0;
+	mNextId = 1;
+	for (int h = 0; h < HandFrame::MAX_HANDS; ++h) {
+		mState[h].step = 0;
+		mState[h].id = 0;
+		mState[h].present = false;
+	}
+}
+
+int64_t HandSynthesizer::getDuration() const {
+	if (mSteps.empty())
+		return 0;
+	return mStarts.back() + (mHands - 1) * HAND_DELAY;
+}
+
+int64_t HandSynthesizer::getFrameCount() const {
+	int64_t duration = getDuration();
+	int64_t count = (int64_t)std::ceil(duration * mRate / 1000000.0);
+	while (count > 0 && getTime(count - 1) >= duration)
+		--count;
+	while (getTime(count) < duration)
+		++count;
+	return count;
+}
+
+bool HandSynthesizer::next(HandFrame& frame) {
+	int64_t time = getTime(mFrame);
+	if (time >= getDuration())
+		return false;
+
+	frame.clear();
+	frame.id = mFrame;
+	frame.timestamp = time;
+
+	bool dropped = (mDropout > 0.0 && uniform(mRandom) < mDropout);
+	for (int h = 0; h < mHands; ++h) {
+		HandData& hand = frame.hands[frame.handCount];
+		if (synthesize(h, time - h * HAND_DELAY, hand) && !dropped)
+			++frame.handCount;
+	}
+
+	++mFrame;
+	return true;
+}
+
+const char* HandSynthesizer::getMotionName(Motion motion) {
+	if (motion < NONE || motion >= MOTIONS)
+		return "";
+	return MOTION_NAMES[motion];
+}
+
+bool HandSynthesizer::parseMotion(const std::string& name, Motion& motion) {
+	for (int m = 0; m < MOTIONS; ++m) {
+		if (name == MOTION_NAMES[m]) {
+			motion = (Motion)m;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/*
+   Private member functions
+*/
+
+Vector3 HandSynthesizer::getVelocity(const Step& step, double t) {
+	// Swipes ease in and out along one axis; backtracks go out and come
+	// straight back over the same distance
+	double speed = step.speed;
+	switch (step.motion) {
+		case SWIPE_LEFT:
+		case SWIPE_RIGHT:
+		case SWIPE_UP:
+		case SWIPE_DOWN:
+		case PUSH:
+		case PULL:
+			speed *= std::sin(PI * t);
+			break;
+
+		case BACKTRACK_LEFT:
+		case BACKTRACK_RIGHT:
+		case BACKTRACK_UP:
+		case BACKTRACK_DOWN:
+			speed *= std::sin(2.0 * PI * t);
+			break;
+
+		default:
+			speed = 0.0;
+			break;
+	}
+
+	float s = (float)speed;
+	switch (step.motion) {
+		case SWIPE_LEFT:
+		case BACKTRACK_LEFT:
+			return makeVector(-s, 0.0f, 0.0f);
+
+		case SWIPE_RIGHT:
+		case BACKTRACK_RIGHT:
+			return makeVector(s, 0.0f, 0.0f);
+
+		case SWIPE_UP:
+		case BACKTRACK_UP:
+			return makeVector(0.0f, s, 0.0f);
+
+		case SWIPE_DOWN:
+		case BACKTRACK_DOWN:
+			return makeVector(0.0f, -s, 0.0f);
+
+		case PUSH:
+			return makeVector(0.0f, 0.0f, -s);
+
+		case PULL:
+			return makeVector(0.0f, 0.0f, s);
+
+		default:
+			return makeVector(0.0f, 0.0f, 0.0f);
+	}
+}
+
+int64_t HandSynthesizer::getTime(int64_t frame) const {
+	return (int64_t)(frame * 1000000.0 / mRate);
+}
+
+bool HandSynthesizer::synthesize(int h, int64_t time, HandData& hand) {
+	HandState& state = mState[h];
+	if (time < 0 || time >= mStarts.back()) {
+		state.present = false;
+		return false;
+	}
+
+	while (time >= mStarts[state.step + 1])
+		++state.step;
+	const Step& step = mSteps[state.step];
+
+	if (step.motion == NONE) {
+		state.present = false;
+		return false;
+	}
+
+	if (!state.present) {
+		// Back in view: a new hand, at rest
+		state.present = true;
+		state.id = mNextId++;
+		state.position = makeVector(h * HAND_SPACING, REST_HEIGHT, 0.0f);
+	}
+
+	double t = (double)(time - mStarts[state.step]) / step.duration;
+	Vector3 velocity = getVelocity(step, t);
+
+	float dt = (float)(1.0 / mRate);
+	state.position.x += velocity.x * dt;
+	state.position.y += velocity.y * dt;
+	state.position.z += velocity.z * dt;
+
+	hand.id = state.id;
+	hand.palmPosition = state.position;
+	hand.palmVelocity = velocity;
+	hand.palmNormal = makeVector(0.0f, -1.0f, 0.0f);
+	if (mNoise > 0.0f) {
+		hand.palmVelocity.x += mNoise * (float)gaussian(mRandom);
+		hand.palmVelocity.y += mNoise * (float)gaussian(mRandom);
+		hand.palmVelocity.z += mNoise * (float)gaussian(mRandom);
+	}
+
+	hand.fingerCount = mFingers;
+	for (int f = 0; f < mFingers; ++f) {
+		FingerData& finger = hand.fingers[f];
+		finger.id = state.id * 10 + f;
+
+		// Fingers spread out in front of the palm
+		finger.tipPosition = state.position;
+		finger.tipPosition.x += (f - 2) * 20.0f;
+		finger.tipPosition.z -= 60.0f;
+
+		finger.tipVelocity = velocity;
+		if (mNoise > 0.0f) {
+			finger.tipVelocity.x += mNoise * (float)gaussian(mRandom);
+			finger.tipVelocity.y += mNoise * (float)gaussian(mRandom);
+			finger.tipVelocity.z += mNoise * (float)gaussian(mRandom);
+		}
+	}
+
+	return true;
+}
+
+uint64_t HandSynthesizer::random(uint64_t& state) {
+	// xorshift64*
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+	return state * 0x2545f4914f6cdd1dULL;
+}
+
+double HandSynthesizer::uniform(uint64_t& state) {
+	return (random(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+double HandSynthesizer::gaussian(uint64_t& state) {
+	// The sum of four uniform numbers (here the four 16-bit quarters of one
+	// random number) is close enough to normal for noise, and several
+	// times cheaper than Box-Muller's log, sqrt and cos
+	uint64_t x = random(state);
+	double sum = (double)(x & 0xffff) + (double)((x >> 16) & 0xffff)
+		+ (double)((x >> 32) & 0xffff) + (double)(x >> 48);
+	return (sum / 65536.0 - 2.0) * 1.7320508075688772;
+}
@@ -0,0 +1,171 @@
+/*
+	Philip Romano
+	10/16/2026
+	handtrackset.cpp
+*/
+
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include "handtrackset.h"
+#include "handframe.h"
+#include "handmotion.h"
+#include "featureframe.h"
+#include "compiledgesturegraph.h"
+#include "gesturesession.h"
+
+HandTrackSet::HandTrackSet(
+		boost::shared_ptr<const CompiledGestureGraph> graph,
+		const FeatureExtractor& extractor, int capacity)
+		: mSessions(graph),
+		  mRequired(extractor.getRequired()),
+		  mDropped(0) {
+	Track track;
+	track.active = false;
+	track.handId = -1;
+	track.motion = extractor.getMotion();
+	track.motion.reset();
+	track.features.clear();
+	track.hand = -1;
+	mTracks.assign(std::max(capacity, 1), track);
+
+	for (int i = 0; i < (int)mTracks.size(); ++i)
+		mSessions.createSession();
+}
+
+void HandTrackSet::require(uint32_t features) {
+	mRequired |= features & FeatureFrame::ALL;
+}
+
+uint32_t HandTrackSet::getRequired() const {
+	return mRequired;
+}
+
+void HandTrackSet::update(const HandFrame& frame) {
+	if (!frame.isValid())
+		return;
+
+	int count = (int)mTracks.size();
+	for (int i = 0; i < count; ++i)
+		mTracks[i].hand = -1;
+
+	// Hands that have a track keep it; the others take a free one
+	int hands = std::min((int)frame.handCount, (int)HandFrame::MAX_HANDS);
+	int unmatched[HandFrame::MAX_HANDS];
+	int unmatchedCount = 0;
+	for (int h = 0; h < hands; ++h) {
+		int i = findTrack(frame.hands[h].id);
+		if (i >= 0 && mTracks[i].hand < 0)
+			mTracks[i].hand = h;
+		else
+			unmatched[unmatchedCount++] = h;
+	}
+
+	// Tracks whose hand left see the frame without it, and are freed
+	for (int i = 0; i < count; ++i) {
+		Track& track = mTracks[i];
+		if (track.active && track.hand < 0) {
+			step(i, frame, NULL);
+			track.active = false;
+		}
+	}
+
+	for (int u = 0, i = 0; u < unmatchedCount; ++u) {
+		while (i < count && mTracks[i].active)
+			++i;
+		if (i == count) {
+			mDropped += unmatchedCount - u;
+			break;
+		}
+
+		// From rest, at the start node
+		Track& track = mTracks[i];
+		track.active = true;
+		track.handId = frame.hands[unmatched[u]].id;
+		track.hand = unmatched[u];
+		track.motion.reset();
+		mSessions.getSession(i).reset();
+	}
+
+	for (int i = 0; i < count; ++i) {
+		if (mTracks[i].active)
+			step(i, frame, &frame.hands[mTracks[i].hand]);
+	}
+}
+
+void HandTrackSet::reset() {
+	for (int i = 0; i < (int)mTracks.size(); ++i) {
+		mTracks[i].active = false;
+		mTracks[i].motion.reset();
+		mTracks[i].features.clear();
+		mSessions.getSession(i).reset();
+	}
+}
+
+int HandTrackSet::getCapacity() const {
+	return mTracks.size();
+}
+
+int HandTrackSet::getTrackCount() const {
+	int active = 0;
+	for (int i = 0; i < (int)mTracks.size(); ++i)
+		active += mTracks[i].active ? 1 : 0;
+	return active;
+}
+
+bool HandTrackSet::isActive(int i) const {
+	return mTracks[i].active;
+}
+
+int32_t HandTrackSet::getHandId(int i) const {
+	return mTracks[i].handId;
+}
+
+int HandTrackSet::findTrack(int32_t handId) const {
+	for (int i = 0; i < (int)mTracks.size(); ++i) {
+		if (mTracks[i].active && mTracks[i].handId == handId)
+			return i;
+	}
+	return -1;
+}
+
+const FeatureFrame& HandTrackSet::getFeatures(int i) const {
+	return mTracks[i].features;
+}
+
+GestureSession HandTrackSet::getSession(int i) {
+	return mSessions.getSession(i);
+}
+
+GestureSessionSet& HandTrackSet::getSessions() {
+	return mSessions;
+}
+
+int64_t HandTrackSet::getDropped() const {
+	return mDropped;
+}
+
+
+/*
+   Private member functions
+*/
+
+void HandTrackSet::step(int i, const HandFrame& frame,
+		const HandData *hand) {
+	Track& track = mTracks[i];
+	FeatureFrame& features = track.features;
+	static_cast<HandFrame&>(features) = frame;
+
+	// The track's hand is its main hand, among however many others
+	HandMotion& motion = track.motion;
+	motion.update(hand, frame.timestamp);
+	FeatureExtractor::writeFeatures(
+			motion.hasHand() ? &motion.getHand() : NULL,
+			motion.getVelocity(), motion.getPosition(), mRequired, features);
+
+	// Each track sees the frame differently under the same frame ID
+	mSessions.updateSession(i, features);
+}
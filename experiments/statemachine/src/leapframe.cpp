@@ -0,0 +1,50 @@
+/*
+	Philip Romano
+	10/16/2026
+	leapframe.cpp
+*/
+
+#include <Leap.h>
+
+#include "leapframe.h"
+#include "handframe.h"
+
+Vector3 toVector3(const Leap::Vector& vector) {
+	Vector3 result;
+	result.x = vector.x;
+	result.y = vector.y;
+	result.z = vector.z;
+	return result;
+}
+
+void toHandFrame(const Leap::Frame& frame, HandFrame& out) {
+	out.clear();
+	if (!frame.isValid())
+		return;
+
+	out.id = frame.id();
+	out.timestamp = frame.timestamp();
+
+	Leap::HandList hands = frame.hands();
+	for (Leap::HandList::const_iterator hand = hands.begin();
+			hand != hands.end() && out.handCount < HandFrame::MAX_HANDS;
+			++hand) {
+		HandData& data = out.hands[out.handCount++];
+		data.id = (*hand).id();
+		data.palmPosition = toVector3((*hand).palmPosition());
+		data.palmVelocity = toVector3((*hand).palmVelocity());
+		data.palmNormal = toVector3((*hand).palmNormal());
+
+		data.fingerCount = 0;
+		Leap::FingerList fingers = (*hand).fingers();
+		for (Leap::FingerList::const_iterator finger = fingers.begin();
+				finger != fingers.end()
+				&& data.fingerCount < HandData::MAX_FINGERS;
+				++finger) {
+			FingerData& tip = data.fingers[data.fingerCount++];
+			tip.id = (*finger).id();
+			tip.tipPosition = toVector3((*finger).tipPosition());
+			tip.tipVelocity = toVector3((*finger).tipVelocity());
+		}
+	}
+}
@@ -0,0 +1,48 @@
+/*
+	Philip Romano
+	10/16/2026
+	leaprecorder.cpp
+*/
+
+#include <string>
+#include <stdint.h>
+
+#include <Leap.h>
+
+#include "leaprecorder.h"
+#include "leapframe.h"
+#include "framelog.h"
+#include "handframe.h"
+
+LeapRecorder::LeapRecorder(int capacity)
+		: mWriter(capacity) {
+
+}
+
+bool LeapRecorder::open(const std::string& filename) {
+	return mWriter.open(filename);
+}
+
+bool LeapRecorder::close() {
+	return mWriter.close();
+}
+
+uint64_t LeapRecorder::getWritten() const {
+	return mWriter.getWritten();
+}
+
+uint64_t LeapRecorder::getLost() const {
+	return mWriter.getLost();
+}
+
+uint64_t LeapRecorder::getDropped() const {
+	return mWriter.getDropped();
+}
+
+void LeapRecorder::onFrame(const Leap::Controller& controller) {
+	HandFrame *frame = mWriter.beginAppend();
+	if (frame) {
+		toHandFrame(controller.frame(0), *frame);
+		mWriter.commitAppend();
+	}
+}
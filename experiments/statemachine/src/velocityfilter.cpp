@@ -0,0 +1,413 @@
+/*
+	Philip Romano
+	10/16/2026
+	velocityfilter.cpp
+*/
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <stdint.h>
+
+#include "velocityfilter.h"
+#include "handmotion.h"
+#include "handframe.h"
+
+namespace {
+	const Vector3 ZERO = { 0.0f, 0.0f, 0.0f };
+	const double PI = 3.14159265358979323846;
+
+	// Time step assumed for the first frame, and for frames with no time
+	// between them, in seconds
+	const float DEFAULT_STEP = 0.01f;
+
+	const int DEFAULT_WINDOW = 3;
+	const float DEFAULT_ALPHA = 0.5f;
+	const float DEFAULT_MIN_CUTOFF = 1.0f;
+	const float DEFAULT_BETA = 0.002f;
+	const float DEFAULT_DERIVATIVE_CUTOFF = 1.0f;
+	const float DEFAULT_JERK = 5000.0f;
+	const float DEFAULT_VELOCITY_NOISE = 40.0f;
+	const float DEFAULT_POSITION_NOISE = 5.0f;
+
+	/**
+	  Smoothing factor of an exponential average with the given cutoff
+	  frequency, for samples step seconds apart.
+	*/
+	float getAlpha(float cutoff, float step) {
+		float tau = 1.0f / (2.0f * (float)PI * cutoff);
+		return 1.0f / (1.0f + tau / step);
+	}
+
+	void moveToward(Vector3& value, const Vector3& target, float alpha) {
+		value.x += (target.x - value.x) * alpha;
+		value.y += (target.y - value.y) * alpha;
+		value.z += (target.z - value.z) * alpha;
+	}
+
+	/**
+	  Read up to count comma-separated numbers from settings into values;
+	  any not given are left as they are.
+
+	  Returns true if settings held nothing else; false otherwise
+	*/
+	bool parseSettings(const std::string& settings, float *values,
+			int count) {
+		std::istringstream in(settings);
+		for (int i = 0; i < count && in.peek() != EOF; ++i) {
+			if (!(in >> values[i]))
+				return false;
+			if (in.peek() == ',')
+				in.get();
+			else
+				break;
+		}
+		return in.peek() == EOF;
+	}
+}
+
+VelocityFilter::VelocityFilter(Kind kind)
+		: mAlpha(DEFAULT_ALPHA), mMinCutoff(DEFAULT_MIN_CUTOFF),
+		  mBeta(DEFAULT_BETA), mDerivativeCutoff(DEFAULT_DERIVATIVE_CUTOFF),
+		  mJerk(DEFAULT_JERK), mVelocityNoise(DEFAULT_VELOCITY_NOISE),
+		  mPositionNoise(DEFAULT_POSITION_NOISE) {
+	mKind = kind;
+	mWindow.resize(DEFAULT_WINDOW);
+	reset();
+}
+
+VelocityFilter::VelocityFilter(int window)
+		: mAlpha(DEFAULT_ALPHA), mMinCutoff(DEFAULT_MIN_CUTOFF),
+		  mBeta(DEFAULT_BETA), mDerivativeCutoff(DEFAULT_DERIVATIVE_CUTOFF),
+		  mJerk(DEFAULT_JERK), mVelocityNoise(DEFAULT_VELOCITY_NOISE),
+		  mPositionNoise(DEFAULT_POSITION_NOISE) {
+	setBox(window);
+}
+
+void VelocityFilter::setBox(int window) {
+	mKind = BOX;
+	mWindow.resize(window > 0 ? window : 1);
+	reset();
+}
+
+void VelocityFilter::setEma(float alpha) {
+	mKind = EMA;
+	mAlpha = std::min(std::max(alpha, 0.0f), 1.0f);
+	reset();
+}
+
+void VelocityFilter::setOneEuro(float minCutoff, float beta,
+		float derivativeCutoff) {
+	mKind = ONE_EURO;
+	mMinCutoff = minCutoff;
+	mBeta = beta;
+	mDerivativeCutoff = derivativeCutoff;
+	reset();
+}
+
+void VelocityFilter::setKalman(float jerk, float velocityNoise,
+		float positionNoise) {
+	mKind = KALMAN;
+	mJerk = jerk;
+	mVelocityNoise = velocityNoise;
+	mPositionNoise = positionNoise;
+	reset();
+}
+
+const Vector3& VelocityFilter::update(const Vector3& velocity,
+		int64_t timestamp) {
+	return filter(velocity, NULL, timestamp);
+}
+
+const Vector3& VelocityFilter::update(const Vector3& velocity,
+		const Vector3& position, int64_t timestamp) {
+	return filter(velocity, &position, timestamp);
+}
+
+void VelocityFilter::reset() {
+	std::fill(mWindow.begin(), mWindow.end(), ZERO);
+	mBox.reset();
+	mDerivative = ZERO;
+	mLastTime = -1;
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j)
+			mState[i][j] = mCovariance[i][j] = 0.0;
+	}
+	mValue = ZERO;
+	mPosition = ZERO;
+}
+
+const Vector3& VelocityFilter::get() const {
+	return mValue;
+}
+
+const Vector3& VelocityFilter::getPosition() const {
+	return mPosition;
+}
+
+VelocityFilter::Kind VelocityFilter::getKind() const {
+	return mKind;
+}
+
+bool VelocityFilter::parse(const std::string& description,
+		VelocityFilter& filter) {
+	std::string::size_type colon = description.find(':');
+	std::string kind = description.substr(0, colon);
+	std::string settings = (colon == std::string::npos)
+		? std::string() : description.substr(colon + 1);
+
+	if (kind == "box") {
+		float window = DEFAULT_WINDOW;
+		if (!parseSettings(settings, &window, 1) || window < 1.0f)
+			return false;
+		filter.setBox((int)window);
+	} else if (kind == "ema") {
+		float alpha = DEFAULT_ALPHA;
+		if (!parseSettings(settings, &alpha, 1) || alpha <= 0.0f
+				|| alpha > 1.0f)
+			return false;
+		filter.setEma(alpha);
+	} else if (kind == "euro") {
+		float values[3] = { DEFAULT_MIN_CUTOFF, DEFAULT_BETA,
+			DEFAULT_DERIVATIVE_CUTOFF };
+		if (!parseSettings(settings, values, 3) || values[0] <= 0.0f
+				|| values[1] < 0.0f || values[2] <= 0.0f)
+			return false;
+		filter.setOneEuro(values[0], values[1], values[2]);
+	} else if (kind == "kalman") {
+		float values[3] = { DEFAULT_JERK, DEFAULT_VELOCITY_NOISE,
+			DEFAULT_POSITION_NOISE };
+		if (!parseSettings(settings, values, 3) || values[0] <= 0.0f
+				|| values[1] <= 0.0f || values[2] <= 0.0f)
+			return false;
+		filter.setKalman(values[0], values[1], values[2]);
+	} else
+		return false;
+	return true;
+}
+
+
+/*
+   Private member functions
+*/
+
+const Vector3& VelocityFilter::filter(const Vector3& velocity,
+		const Vector3 *position, int64_t timestamp) {
+	switch (mKind) {
+		case BOX: {
+			// The usual windows with their size fixed, as in BoxFilter
+			Vector3 *window = &mWindow[0];
+			switch (mWindow.size()) {
+				case 2:
+					mValue = mBox.update<2>(window, velocity);
+					break;
+				case 3:
+					mValue = mBox.update<3>(window, velocity);
+					break;
+				case 4:
+					mValue = mBox.update<4>(window, velocity);
+					break;
+				case 5:
+					mValue = mBox.update<5>(window, velocity);
+					break;
+				default:
+					mValue = mBox.update(window, (int)mWindow.size(),
+							velocity);
+					break;
+			}
+			break;
+		}
+
+		case EMA:
+			moveToward(mValue, velocity, mAlpha);
+			break;
+
+		case ONE_EURO: {
+			float step = DEFAULT_STEP;
+			if (mLastTime >= 0 && timestamp > mLastTime)
+				step = (timestamp - mLastTime) / 1000000.0f;
+			mLastTime = timestamp;
+
+			// The faster the velocity changes, the higher the cutoff
+			Vector3 change;
+			change.x = (velocity.x - mValue.x) / step;
+			change.y = (velocity.y - mValue.y) / step;
+			change.z = (velocity.z - mValue.z) / step;
+			moveToward(mDerivative, change,
+					getAlpha(mDerivativeCutoff, step));
+
+			float cutoff = mMinCutoff + mBeta * mDerivative.magnitude();
+			moveToward(mValue, velocity, getAlpha(cutoff, step));
+			break;
+		}
+
+		case KALMAN: {
+			// From rest, a step before the first input: still, and known to
+			// be, where the palm first is
+			if (mLastTime < 0 && position) {
+				mState[0][0] = position->x;
+				mState[1][0] = position->y;
+				mState[2][0] = position->z;
+				mCovariance[0][0] = (double)mPositionNoise * mPositionNoise;
+			}
+			double step = DEFAULT_STEP;
+			if (mLastTime >= 0 && timestamp > mLastTime)
+				step = (timestamp - mLastTime) / 1000000.0;
+			mLastTime = timestamp;
+			predict(step);
+
+			if (position) {
+				double measured[3] = { position->x, position->y,
+					position->z };
+				correct(0, measured, (double)mPositionNoise * mPositionNoise);
+			}
+			double measured[3] = { velocity.x, velocity.y, velocity.z };
+			correct(1, measured, (double)mVelocityNoise * mVelocityNoise);
+
+			mValue.x = (float)mState[0][1];
+			mValue.y = (float)mState[1][1];
+			mValue.z = (float)mState[2][1];
+			mPosition.x = (float)mState[0][0];
+			mPosition.y = (float)mState[1][0];
+			mPosition.z = (float)mState[2][0];
+			return mValue;
+		}
+	}
+
+	if (position)
+		mPosition = *position;
+	return mValue;
+}
+
+void VelocityFilter::predict(double step) {
+	// Constant acceleration: x' = Fx, with F = [1 t t^2/2; 0 1 t; 0 0 1]
+	double half = step * step / 2.0;
+	for (int axis = 0; axis < 3; ++axis) {
+		double *x = mState[axis];
+		x[0] += x[1] * step + x[2] * half;
+		x[1] += x[2] * step;
+	}
+
+	// P' = FPF' + Q, Q being the covariance that white noise in the jerk
+	// adds over the step
+	double f[3][3] = { { 1.0, step, half }, { 0.0, 1.0, step },
+		{ 0.0, 0.0, 1.0 } };
+	double fp[3][3], next[3][3];
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			fp[i][j] = 0.0;
+			for (int k = 0; k < 3; ++k)
+				fp[i][j] += f[i][k] * mCovariance[k][j];
+		}
+	}
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			next[i][j] = 0.0;
+			for (int k = 0; k < 3; ++k)
+				next[i][j] += fp[i][k] * f[j][k];
+		}
+	}
+
+	double q = (double)mJerk * mJerk;
+	double t2 = step * step, t3 = t2 * step;
+	double noise[3][3] = {
+		{ t3 * t2 / 20.0, t2 * t2 / 8.0, t3 / 6.0 },
+		{ t2 * t2 / 8.0, t3 / 3.0, t2 / 2.0 },
+		{ t3 / 6.0, t2 / 2.0, step }
+	};
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j)
+			mCovariance[i][j] = next[i][j] + q * noise[i][j];
+	}
+}
+
+void VelocityFilter::correct(int m, const double *measured,
+		double variance) {
+	// One measurement at a time: the gain is a column, and no matrix is
+	// inverted
+	double innovation = mCovariance[m][m] + variance;
+	double gain[3];
+	for (int i = 0; i < 3; ++i)
+		gain[i] = mCovariance[i][m] / innovation;
+
+	for (int axis = 0; axis < 3; ++axis) {
+		double residual = measured[axis] - mState[axis][m];
+		for (int i = 0; i < 3; ++i)
+			mState[axis][i] += gain[i] * residual;
+	}
+
+	// P' = (I - KH)P
+	double row[3] = { mCovariance[m][0], mCovariance[m][1],
+		mCovariance[m][2] };
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j)
+			mCovariance[i][j] -= gain[i] * row[j];
+	}
+}
+
+VelocityFilterBank::VelocityFilterBank(const VelocityFilter& filter)
+		: mPrototype(filter),
+		  mFilters(HandFrame::MAX_HANDS, filter),
+		  mNext(HandFrame::MAX_HANDS, filter),
+		  mCount(0) {
+	mPrototype.reset();
+}
+
+void VelocityFilterBank::update(const HandFrame& frame) {
+	if (!frame.isValid())
+		return;
+
+	int32_t ids[HandFrame::MAX_HANDS];
+	bool taken[HandFrame::MAX_HANDS] = { false };
+	int count = std::min((int)frame.handCount, (int)HandFrame::MAX_HANDS);
+	for (int h = 0; h < count; ++h) {
+		const HandData& hand = frame.hands[h];
+		ids[h] = hand.id;
+
+		// Carry the hand's filter over (swapping costs no copy), or start
+		// one from rest
+		int previous = -1;
+		for (int p = 0; p < mCount && previous < 0; ++p) {
+			if (mIds[p] == hand.id && !taken[p])
+				previous = p;
+		}
+		if (previous >= 0) {
+			std::swap(mNext[h], mFilters[previous]);
+			taken[previous] = true;
+		} else
+			mNext[h] = mPrototype;
+
+		mNext[h].update(HandMotion::getRawVelocity(hand), hand.palmPosition,
+				frame.timestamp);
+	}
+
+	mFilters.swap(mNext);
+	std::copy(ids, ids + count, mIds);
+	mCount = count;
+}
+
+void VelocityFilterBank::reset() {
+	mCount = 0;
+}
+
+int VelocityFilterBank::getHandCount() const {
+	return mCount;
+}
+
+int32_t VelocityFilterBank::getHandId(int i) const {
+	return mIds[i];
+}
+
+const Vector3& VelocityFilterBank::getVelocity(int i) const {
+	return mFilters[i].get();
+}
+
+const Vector3* VelocityFilterBank::findVelocity(int32_t handId) const {
+	for (int i = 0; i < mCount; ++i) {
+		if (mIds[i] == handId)
+			return &mFilters[i].get();
+	}
+	return NULL;
+}
@@ -0,0 +1,152 @@
+/*
+	Philip Romano
+	10/16/2026
+	workpool.cpp
+*/
+
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdint.h>
+
+#include "workpool.h"
+
+WorkPool::WorkPool(int threads)
+		: mPending(0), mQueued(0), mStolen(0), mNext(0), mStopping(false) {
+	if (threads <= 0)
+		threads = std::thread::hardware_concurrency();
+	if (threads <= 0)
+		threads = 1;
+
+	for (int w = 0; w < threads; ++w)
+		mWorkers.push_back(new Worker());
+
+	// Workers look themselves up in mThreads, which must not move
+	mThreads.reserve(threads);
+	for (int w = 0; w < threads; ++w)
+		mThreads.push_back(std::thread(&WorkPool::run, this, w));
+}
+
+WorkPool::~WorkPool() {
+	try {
+		wait();
+	} catch (...) {
+		// Nobody is left to hear about it
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+	}
+	mWork.notify_all();
+	for (int w = 0; w < (int)mThreads.size(); ++w)
+		mThreads[w].join();
+
+	for (int w = 0; w < (int)mWorkers.size(); ++w)
+		delete mWorkers[w];
+}
+
+void WorkPool::submit(const Task& task) {
+	int w = getCurrentWorker();
+	if (w < 0)
+		w = mNext.fetch_add(1, std::memory_order_relaxed) % mWorkers.size();
+
+	mPending.fetch_add(1);
+	{
+		std::lock_guard<std::mutex> lock(mWorkers[w]->mutex);
+		mWorkers[w]->tasks.push_back(task);
+	}
+	mQueued.fetch_add(1);
+
+	// Under mMutex, so that a worker about to sleep cannot miss it
+	std::lock_guard<std::mutex> lock(mMutex);
+	mWork.notify_one();
+}
+
+void WorkPool::wait() {
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (mPending.load() > 0)
+		mDone.wait(lock);
+
+	if (mError) {
+		std::exception_ptr error = mError;
+		mError = std::exception_ptr();
+		std::rethrow_exception(error);
+	}
+}
+
+int WorkPool::getThreadCount() const {
+	return mThreads.size();
+}
+
+uint64_t WorkPool::getStolen() const {
+	return mStolen.load(std::memory_order_relaxed);
+}
+
+
+/*
+   Private member functions
+*/
+
+void WorkPool::run(int w) {
+	Task task;
+	for (;;) {
+		if (!take(w, task)) {
+			std::unique_lock<std::mutex> lock(mMutex);
+			while (mQueued.load() == 0 && !mStopping)
+				mWork.wait(lock);
+			if (mStopping && mQueued.load() == 0)
+				return;
+			continue;
+		}
+
+		try {
+			task();
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (!mError)
+				mError = std::current_exception();
+		}
+		task = Task();
+
+		if (mPending.fetch_sub(1) == 1) {
+			std::lock_guard<std::mutex> lock(mMutex);
+			mDone.notify_all();
+		}
+	}
+}
+
+bool WorkPool::take(int w, Task& task) {
+	int count = mWorkers.size();
+	for (int i = 0; i < count; ++i) {
+		Worker& worker = *mWorkers[(w + i) % count];
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		if (worker.tasks.empty())
+			continue;
+
+		if (i == 0) {
+			task.swap(worker.tasks.back());
+			worker.tasks.pop_back();
+		} else {
+			task.swap(worker.tasks.front());
+			worker.tasks.pop_front();
+			mStolen.fetch_add(1, std::memory_order_relaxed);
+		}
+		mQueued.fetch_sub(1);
+		return true;
+	}
+	return false;
+}
+
+int WorkPool::getCurrentWorker() const {
+	std::thread::id id = std::this_thread::get_id();
+	for (int w = 0; w < (int)mThreads.size(); ++w) {
+		if (mThreads[w].get_id() == id)
+			return w;
+	}
+	return -1;
+}
@@ -0,0 +1,63 @@
+/*
+	Philip Romano
+	10/16/2026
+	allocationcount.h
+
+	Replaces the global operator new and delete with versions that count
+	every allocation in gAllocations, so that tests and benchmarks can
+	check what a piece of code allocates. Include it in exactly one source
+	file of a program.
+*/
+
+#ifndef ALLOCATIONCOUNT_H
+#define ALLOCATIONCOUNT_H
+
+#include <new>
+#include <cstdlib>
+
+// Number of allocations made so far by the whole program
+long gAllocations = 0;
+
+void* operator new(std::size_t size) {
+	++gAllocations;
+	void *p = std::malloc(size ? size : 1);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](std::size_t size) {
+	++gAllocations;
+	void *p = std::malloc(size ? size : 1);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) throw() {
+	++gAllocations;
+	return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) throw() {
+	++gAllocations;
+	return std::malloc(size ? size : 1);
+}
+
+void operator delete(void *p) throw() {
+	std::free(p);
+}
+
+void operator delete[](void *p) throw() {
+	std::free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t&) throw() {
+	std::free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t&) throw() {
+	std::free(p);
+}
+
+#endif
@@ -0,0 +1,469 @@
+/*
+	Philip Romano
+	10/16/2026
+	bench.cpp
+
+	Benchmarks for GestureStateGraph
+	Times construction (createNodeType(), addNode(), addConnection()),
+	compile(), update(), the lookups (getNode(), getSlot()) and clear() on
+	generated graphs of 10 to 100k nodes, with decision chains of several
+	depths between the states; and the hand's raw velocity, frame by frame
+	(HandMotion::getRawVelocity()) and by block (HandBlock). Each operation
+	is reported in nanoseconds and allocations per call (per frame, for the
+	velocities), so that changes to the graph's representation can be
+	compared before and after:
+
+	  bench.x [--max-nodes n] [--csv] > before.txt
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include "handframe.h"
+#include "handmotion.h"
+#include "handblock.h"
+#include "handsynthesizer.h"
+#include "gesturestategraph.h"
+#include "gesturenode.h"
+#include "gestureprofile.h"
+
+#include "allocationcount.h"
+
+namespace {
+	const int SIZES[] = { 10, 100, 1000, 10000, 100000 };
+	const int DEPTHS[] = { 0, 4, 16 };
+
+	// Roughly how many nodes to build, and lookups and frames to run, for
+	// each graph, whatever its size
+	const int BUILD_NODES = 200000;
+	const int LOOKUPS = 200000;
+	const int FRAMES = 200000;
+
+	const int TYPES = 1000;
+
+	// Where lookup results go, so that they are not optimized away
+	volatile int64_t gSink;
+}
+
+/*
+   Nodes
+*/
+
+struct HoldState {
+	int64_t entered;
+};
+
+class Node_Hold : public StatefulGestureNode<HoldState> {
+	public:
+		virtual const std::string& getName() {
+			static std::string name("Hold");
+			return name;
+		}
+
+		/**
+		  StateNode
+
+		  Returns
+		  0 on the frame the node was entered [stay in state]
+		  1 on every later frame
+		*/
+		virtual int evaluate(const HandFrame& frame,
+				const std::string& nodeid, HoldState& state) {
+			return (frame.id == state.entered) ? 0 : 1;
+		}
+
+		virtual void onEnter(const HandFrame& frame,
+				const std::string& nodeid, HoldState& state) {
+			state.entered = frame.id;
+		}
+};
+
+class Node_Branch : public GestureNode {
+	public:
+		virtual const std::string& getName() {
+			static std::string name("Branch");
+			return name;
+		}
+
+		/**
+		  DecisionNode
+
+		  Returns
+		  1 on even frames
+		  2 on odd frames
+		*/
+		virtual int evaluate(const HandFrame& frame,
+				const std::string& nodeid, void *state) {
+			return 1 + (int)(frame.id & 1);
+		}
+};
+
+// A type that exists only to be registered, under any name
+class Node_Named : public GestureNode {
+	public:
+		Node_Named(const std::string& name)
+				: mName(name)
+			{ }
+
+		virtual const std::string& getName() {
+			return mName;
+		}
+
+		virtual int evaluate(const HandFrame& frame,
+				const std::string& nodeid, void *state) {
+			return 0;
+		}
+
+	private:
+		std::string mName;
+};
+
+/*
+   Generated graphs
+*/
+
+/**
+	The layout of a generated graph: a ring of hold states, where leaving
+	each state walks a chain of depth decision nodes to the next state. On
+	every frame, update() leaves one state, evaluates the whole chain and
+	enters the next state.
+*/
+struct Layout {
+	int states;
+	int depth;
+
+	// Node IDs; the nodes of state s are ids[s * (depth + 1)] (the state)
+	// followed by its chain
+	std::vector<std::string> ids;
+
+	// Every connection, as (start, slot, end) indices into ids
+	std::vector<int> starts, slots, ends;
+
+	Layout(int nodes, int d)
+			: depth(d) {
+		states = nodes / (depth + 1);
+		if (states < 1)
+			states = 1;
+
+		for (int s = 0; s < states; ++s) {
+			std::ostringstream id;
+			id << "s" << s;
+			ids.push_back(id.str());
+			for (int k = 0; k < depth; ++k) {
+				std::ostringstream chain;
+				chain << "d" << s << "_" << k;
+				ids.push_back(chain.str());
+			}
+		}
+
+		for (int s = 0; s < states; ++s) {
+			int state = s * (depth + 1);
+			int next = ((s + 1) % states) * (depth + 1);
+			connect(state, 0, state);
+			connect(state, 1, depth > 0 ? state + 1 : next);
+			for (int k = 0; k < depth; ++k) {
+				int node = state + 1 + k;
+				int to = (k + 1 < depth) ? node + 1 : next;
+				connect(node, 1, to);
+				connect(node, 2, to);
+			}
+		}
+	}
+
+	int getNodeCount() const {
+		return ids.size();
+	}
+
+	bool isState(int node) const {
+		return node % (depth + 1) == 0;
+	}
+
+	void connect(int start, int slot, int end) {
+		starts.push_back(start);
+		slots.push_back(slot);
+		ends.push_back(end);
+	}
+};
+
+static void addTypes(GestureStateGraph& graph) {
+	graph.createNodeType(boost::shared_ptr<GestureNode>(new Node_Hold()));
+	graph.createNodeType(boost::shared_ptr<GestureNode>(new Node_Branch()));
+}
+
+/*
+   Measurements
+*/
+
+/**
+	Time and allocations spent on some number of calls to one operation.
+*/
+class Measurement {
+	public:
+		Measurement()
+				: mOps(0), mNs(0), mAllocations(0), mStart(0),
+				  mStartAllocations(0)
+			{ }
+
+		void start() {
+			mStartAllocations = gAllocations;
+			mStart = GestureProfile::now();
+		}
+
+		void stop(int64_t ops) {
+			mNs += GestureProfile::now() - mStart;
+			mAllocations += gAllocations - mStartAllocations;
+			mOps += ops;
+		}
+
+		int64_t getOps() const {
+			return mOps;
+		}
+
+		double getNsPerOp() const {
+			return mOps ? (double)mNs / mOps : 0.0;
+		}
+
+		double getAllocationsPerOp() const {
+			return mOps ? (double)mAllocations / mOps : 0.0;
+		}
+
+	private:
+		int64_t mOps;
+		int64_t mNs;
+		long mAllocations;
+
+		int64_t mStart;
+		long mStartAllocations;
+};
+
+static bool gCsv = false;
+
+static void printHeader() {
+	if (gCsv) {
+		std::cout << "nodes,depth,operation,ops,ns_per_op,allocs_per_op"
+			<< std::endl;
+	} else {
+		std::cout << std::setw(7) << "nodes" << std::setw(7) << "depth"
+			<< "  " << std::left << std::setw(20) << "operation"
+			<< std::right << std::setw(10) << "ops" << std::setw(12)
+			<< "ns/op" << std::setw(12) << "allocs/op" << std::endl;
+	}
+}
+
+static void print(int nodes, int depth, const std::string& operation,
+		const Measurement& m) {
+	if (gCsv) {
+		std::cout << nodes << "," << depth << "," << operation << ","
+			<< m.getOps() << "," << m.getNsPerOp() << ","
+			<< m.getAllocationsPerOp() << std::endl;
+	} else {
+		std::cout << std::setw(7) << nodes << std::setw(7) << depth << "  "
+			<< std::left << std::setw(20) << operation << std::right
+			<< std::setw(10) << m.getOps() << std::fixed
+			<< std::setprecision(1) << std::setw(12) << m.getNsPerOp()
+			<< std::setprecision(2) << std::setw(12)
+			<< m.getAllocationsPerOp() << std::endl;
+		std::cout.unsetf(std::ios::fixed);
+	}
+}
+
+/**
+  Register TYPES node types with a fresh graph, over and over.
+*/
+static void benchTypes() {
+	std::vector< boost::shared_ptr<GestureNode> > types;
+	for (int t = 0; t < TYPES; ++t) {
+		std::ostringstream name;
+		name << "Type" << t;
+		types.push_back(boost::shared_ptr<GestureNode>(
+				new Node_Named(name.str())));
+	}
+
+	Measurement m;
+	for (int r = 0; r < 20; ++r) {
+		GestureStateGraph graph;
+		m.start();
+		for (int t = 0; t < TYPES; ++t)
+			graph.createNodeType(types[t]);
+		m.stop(TYPES);
+	}
+	print(TYPES, 0, "createNodeType", m);
+}
+
+/**
+  Reduce the raw velocity of FRAMES synthesized frames, one frame at a
+  time, and a block at a time.
+*/
+static void benchVelocities() {
+	HandSynthesizer synth;
+	synth.setNoise(20.0f);
+	synth.addRandomSteps(20);
+	HandBlock block;
+	std::vector<HandFrame> frames(block.getCapacity());
+	int count = 0;
+	while (count < block.getCapacity() && synth.next(frames[count]))
+		count += (frames[count].handCount > 0) ? 1 : 0;
+	frames.resize(count);
+
+	int rounds = FRAMES / count + 1;
+	Measurement perFrame, load, reduce;
+	float sink = 0.0f;
+	for (int r = 0; r < rounds; ++r) {
+		perFrame.start();
+		for (int i = 0; i < count; ++i)
+			sink += HandMotion::getRawVelocity(frames[i].hands[0]).x;
+		perFrame.stop(count);
+
+		load.start();
+		block.load(&frames[0], count);
+		load.stop(count);
+
+		reduce.start();
+		block.reduce();
+		reduce.stop(count);
+		sink += block.getVelocity(r % count).x;
+	}
+	print(0, 0, "getRawVelocity", perFrame);
+	print(0, 0, "HandBlock::load", load);
+	print(0, 0, "HandBlock::reduce", reduce);
+	gSink = (int64_t)sink;
+}
+
+/**
+  Build, compile, run, query and clear the graph of the given layout.
+*/
+static void bench(const Layout& layout) {
+	int nodes = layout.getNodeCount();
+	int connections = layout.starts.size();
+	Measurement addNode, addConnection, compile, clear;
+
+	// Construction, repeated until about BUILD_NODES nodes have been added
+	int reps = BUILD_NODES / nodes;
+	if (reps < 1)
+		reps = 1;
+	for (int r = 0; r < reps; ++r) {
+		GestureStateGraph graph;
+		addTypes(graph);
+
+		addNode.start();
+		for (int n = 0; n < nodes; ++n)
+			graph.addNode(layout.isState(n) ? "Hold" : "Branch",
+					layout.ids[n]);
+		addNode.stop(nodes);
+
+		addConnection.start();
+		for (int c = 0; c < connections; ++c) {
+			graph.addConnection(layout.ids[layout.starts[c]],
+					layout.slots[c], layout.ids[layout.ends[c]]);
+		}
+		addConnection.stop(connections);
+
+		compile.start();
+		graph.compile();
+		compile.stop(1);
+
+		clear.start();
+		graph.clear();
+		clear.stop(1);
+	}
+
+	print(nodes, layout.depth, "addNode", addNode);
+	print(nodes, layout.depth, "addConnection", addConnection);
+	print(nodes, layout.depth, "compile", compile);
+	print(nodes, layout.depth, "clear", clear);
+
+	// One graph for the rest
+	GestureStateGraph graph;
+	addTypes(graph);
+	for (int n = 0; n < nodes; ++n)
+		graph.addNode(layout.isState(n) ? "Hold" : "Branch", layout.ids[n]);
+	for (int c = 0; c < connections; ++c) {
+		graph.addConnection(layout.ids[layout.starts[c]], layout.slots[c],
+				layout.ids[layout.ends[c]]);
+	}
+	graph.compile();
+
+	// Lookups, of nodes picked pseudo-randomly ahead of time
+	std::vector<int> picks(LOOKUPS);
+	std::vector<GestureStateGraph::NodeHandle> handles(LOOKUPS);
+	uint32_t x = 12345;
+	for (int i = 0; i < LOOKUPS; ++i) {
+		x = x * 1664525 + 1013904223;
+		picks[i] = (x >> 8) % nodes;
+		handles[i] = graph.getNode(layout.ids[picks[i]]);
+	}
+
+	Measurement getNode, getSlotById, getSlotByHandle;
+	int64_t sink = 0;
+
+	getNode.start();
+	for (int i = 0; i < LOOKUPS; ++i)
+		sink += graph.getNode(layout.ids[picks[i]]);
+	getNode.stop(LOOKUPS);
+
+	getSlotById.start();
+	for (int i = 0; i < LOOKUPS; ++i)
+		sink += graph.getSlot(layout.ids[picks[i]], 1).size();
+	getSlotById.stop(LOOKUPS);
+
+	getSlotByHandle.start();
+	for (int i = 0; i < LOOKUPS; ++i)
+		sink += graph.getSlot(handles[i], 1);
+	getSlotByHandle.stop(LOOKUPS);
+
+	print(nodes, layout.depth, "getNode(id)", getNode);
+	print(nodes, layout.depth, "getSlot(id)", getSlotById);
+	print(nodes, layout.depth, "getSlot(handle)", getSlotByHandle);
+
+	// update(), once warmed up; every frame walks one chain
+	HandFrame frame;
+	frame.clear();
+	for (int f = 0; f < layout.states + 1; ++f) {
+		frame.id = f;
+		graph.update(frame);
+	}
+
+	Measurement update;
+	update.start();
+	for (int f = 0; f < FRAMES; ++f) {
+		frame.id = layout.states + 1 + f;
+		graph.update(frame);
+	}
+	update.stop(FRAMES);
+	print(nodes, layout.depth, "update", update);
+	gSink = sink;
+}
+
+int main(int argc, char **argv) {
+	int maxNodes = SIZES[sizeof(SIZES) / sizeof(SIZES[0]) - 1];
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--csv") == 0) {
+			gCsv = true;
+		} else if (std::strcmp(argv[i], "--max-nodes") == 0 && i + 1 < argc) {
+			maxNodes = std::atoi(argv[++i]);
+		} else {
+			std::cerr << "Usage: " << argv[0]
+				<< " [--max-nodes n] [--csv]" << std::endl;
+			return 1;
+		}
+	}
+
+	printHeader();
+	benchTypes();
+	benchVelocities();
+	for (int s = 0; s < (int)(sizeof(SIZES) / sizeof(SIZES[0])); ++s) {
+		if (SIZES[s] > maxNodes)
+			break;
+		for (int d = 0; d < (int)(sizeof(DEPTHS) / sizeof(DEPTHS[0])); ++d)
+			bench(Layout(SIZES[s], DEPTHS[d]));
+	}
+	return 0;
+}
@@ -0,0 +1,146 @@
+/*
+	Philip Romano
+	10/16/2026
+	block.cpp
+
+	Test for HandBlock
+	Checks that the raw velocities reduced over blocks of synthesized
+	frames, with every finger count, dropouts and several hands, are equal
+	to the bit to HandMotion::getRawVelocity()'s, signed zeros included,
+	and that HandMotion fed them follows the hand as it does on its own.
+*/
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
+
+#include "handblock.h"
+#include "handmotion.h"
+#include "handsynthesizer.h"
+#include "handframe.h"
+
+static bool same(const Vector3& a, const Vector3& b) {
+	return std::memcmp(&a, &b, sizeof(Vector3)) == 0;
+}
+
+/**
+  Returns frames of three hands moving at random, with dropouts, and each
+  hand's fingers coming and going.
+*/
+static std::vector<HandFrame> synthesize() {
+	HandSynthesizer synth(100.0, 7);
+	synth.setHands(3);
+	synth.setNoise(25.0f);
+	synth.setDropout(0.05);
+	synth.addRandomSteps(40);
+
+	std::vector<HandFrame> frames;
+	HandFrame frame;
+	while (synth.next(frame)) {
+		for (int h = 0; h < frame.handCount; ++h) {
+			frame.hands[h].fingerCount =
+				(int32_t)((frame.id + h) % (HandData::MAX_FINGERS + 1));
+		}
+		frames.push_back(frame);
+	}
+	return frames;
+}
+
+static bool reduction(const std::vector<HandFrame>& frames) {
+	// A capacity that does not divide the frame count, so that the last
+	// block is partly full
+	HandBlock block(1000);
+	bool success = true;
+	int64_t checked = 0;
+	for (int hand = 0; hand < 3; ++hand) {
+		for (size_t first = 0; first < frames.size();
+				first += block.getCapacity()) {
+			int count = block.load(&frames[first],
+					(int)(frames.size() - first), hand);
+			block.reduce();
+			success &= count == std::min(block.getCapacity(),
+					(int)(frames.size() - first)) && block.size() == count;
+
+			for (int i = 0; i < count; ++i) {
+				const HandFrame& frame = frames[first + i];
+				bool present = hand < frame.handCount;
+				success &= block.hasHand(i) == present;
+				if (!present)
+					continue;
+				success &= same(block.getVelocity(i),
+						HandMotion::getRawVelocity(frame.hands[hand]));
+				++checked;
+			}
+		}
+	}
+	return success && checked > (int64_t)frames.size();
+}
+
+static bool signedZeros() {
+	// Without fingers, the palm velocity is added to zero: -0 becomes +0
+	HandFrame frame;
+	std::memset(&frame, 0, sizeof(frame));
+	frame.id = 0;
+	frame.handCount = 1;
+	Vector3 palm = { -0.0f, 3.0f, -0.0f };
+	frame.hands[0].palmVelocity = palm;
+
+	HandBlock block(4);
+	bool success = true;
+	for (int fingers = 0; fingers <= HandData::MAX_FINGERS; ++fingers) {
+		frame.hands[0].fingerCount = fingers;
+		for (int f = 0; f < fingers; ++f) {
+			Vector3 tip = { -0.0f, -1.0f * f, 0.5f };
+			frame.hands[0].fingers[f].tipVelocity = tip;
+		}
+		block.load(&frame, 1);
+		block.reduce();
+		success &= same(block.getVelocity(0),
+				HandMotion::getRawVelocity(frame.hands[0]));
+	}
+	return success;
+}
+
+static bool motion(const std::vector<HandFrame>& frames) {
+	HandMotion direct(3, 2), blocked(3, 2);
+	HandBlock block(512);
+	bool success = true;
+	for (size_t first = 0; first < frames.size();
+			first += block.getCapacity()) {
+		int count = block.load(&frames[first],
+				(int)(frames.size() - first));
+		block.reduce();
+		for (int i = 0; i < count; ++i) {
+			direct.update(frames[first + i]);
+			blocked.update(frames[first + i], block.getVelocity(i));
+			success &= direct.hasHand() == blocked.hasHand()
+				&& same(direct.getVelocity(), blocked.getVelocity());
+		}
+	}
+	return success;
+}
+
+int main(int argc, char **argv) {
+	std::vector<HandFrame> frames = synthesize();
+	bool success = true;
+
+	bool result = reduction(frames);
+	std::cout << "Block reduction: " << (result ? "ok" : "FAILED")
+		<< std::endl;
+	success &= result;
+
+	result = signedZeros();
+	std::cout << "Signed zeros: " << (result ? "ok" : "FAILED")
+		<< std::endl;
+	success &= result;
+
+	result = motion(frames);
+	std::cout << "HandMotion on block velocities: "
+		<< (result ? "ok" : "FAILED") << std::endl;
+	success &= result;
+
+	std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+	return success ? 0 : 1;
+}
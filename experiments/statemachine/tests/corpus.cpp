@@ -0,0 +1,170 @@
+/*
+	Philip Romano
+	10/16/2026
+	corpus.cpp
+
+	Replay a corpus of frame logs through one of the demo graphs, spread
+	across every core (see WorkPool). Each log gets a graph of its own, so
+	the results are the same as replaying the logs one by one with
+	replay.x: the transitions are printed to stdout log by log, in the
+	order the logs were given, whatever order they finished in. The
+	timings are summed up on stderr.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+#include <boost/bind/bind.hpp>
+
+#include "gesturetrace.h"
+#include "gestureprofile.h"
+#include "framelog.h"
+#include "workpool.h"
+
+#include "replay.h"
+
+/**
+	One log of the corpus, and what replaying it produced.
+*/
+struct Job {
+	std::string filename;
+	int64_t bytes;
+
+	bool ok;
+	std::string error;
+	ReplayResult result;
+};
+
+static void run(const std::string& graph, Job *job) {
+	FrameLogReader log;
+	if (!log.open(job->filename)) {
+		job->error = "not a valid frame log";
+		return;
+	}
+
+	try {
+		replay::run(graph, log, job->result);
+		job->ok = true;
+	} catch (std::exception& e) {
+		job->error = e.what();
+	}
+}
+
+static int64_t getFileSize(const std::string& filename) {
+	std::ifstream in(filename.c_str(), std::ios::binary | std::ios::ate);
+	return in ? (int64_t)in.tellg() : 0;
+}
+
+static bool isLarger(const Job *a, const Job *b) {
+	return a->bytes > b->bytes;
+}
+
+static void usage(const char *program) {
+	std::cerr << "Usage: " << program
+		<< " [homescreen|train|swipe|visual] [frame log...] [--threads n]"
+		<< " [--quiet]" << std::endl;
+}
+
+int main(int argc, char **argv) {
+	bool quiet = false;
+	int threads = 0;
+	std::vector<std::string> args;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--quiet") == 0) {
+			quiet = true;
+		} else if (std::strcmp(argv[i], "--threads") == 0) {
+			if (i + 1 >= argc) {
+				usage(argv[0]);
+				return 1;
+			}
+			threads = std::atoi(argv[++i]);
+		} else {
+			args.push_back(argv[i]);
+		}
+	}
+
+	if (args.size() < 2) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	const std::string graph = args[0];
+	if (!replay::isGraph(graph)) {
+		std::cerr << "Unknown graph " << graph << std::endl;
+		return 1;
+	}
+
+	std::vector<Job> jobs(args.size() - 1);
+	std::vector<Job*> order;
+	for (int i = 0; i < (int)jobs.size(); ++i) {
+		jobs[i].filename = args[i + 1];
+		jobs[i].bytes = getFileSize(jobs[i].filename);
+		jobs[i].ok = false;
+		order.push_back(&jobs[i]);
+	}
+
+	// Longest logs first, so that no core is left with a long one at the
+	// end; stealing evens out the rest
+	std::stable_sort(order.begin(), order.end(), isLarger);
+
+	// Some graphs' actions print to std::cout as they run; from several
+	// threads at once that would be interleaved with no telling which log
+	// it came from, so only the merged transitions are printed
+	std::cout.setstate(std::ios::failbit);
+
+	int64_t start = GestureProfile::now();
+	int workers;
+	uint64_t stolen;
+	{
+		WorkPool pool(threads);
+		for (int i = 0; i < (int)order.size(); ++i)
+			pool.submit(boost::bind(&run, graph, order[i]));
+		pool.wait();
+		workers = pool.getThreadCount();
+		stolen = pool.getStolen();
+	}
+	double wall = (GestureProfile::now() - start) / 1e9;
+	std::cout.clear();
+
+	// Merge in the order given
+	bool success = true;
+	int64_t frames = 0, transitions = 0, busy = 0;
+	for (int i = 0; i < (int)jobs.size(); ++i) {
+		const Job& job = jobs[i];
+		if (!job.ok) {
+			std::cerr << job.filename << ": " << job.error << std::endl;
+			success = false;
+			continue;
+		}
+
+		frames += job.result.frames;
+		transitions += job.result.transitions.size();
+		busy += job.result.replayTime;
+		if (!quiet) {
+			std::cout << "== " << job.filename << ": " << job.result.frames
+				<< " frames, " << job.result.transitions.size()
+				<< " transitions" << std::endl;
+			GestureTrace::print(std::cout, job.result.nodeIds,
+					job.result.transitions);
+		}
+	}
+	std::cout.flush();
+
+	std::cerr << jobs.size() << " logs, " << frames << " frames, "
+		<< transitions << " transitions on " << workers << " threads ("
+		<< stolen << " stolen)" << std::endl
+		<< "  " << wall * 1000.0 << " ms wall, " << busy / 1e6
+		<< " ms replaying";
+	if (wall > 0.0) {
+		std::cerr << " (" << (int64_t)(frames / wall) << " frames/sec, "
+			<< busy / 1e9 / wall << "x parallel)";
+	}
+	std::cerr << std::endl;
+	return success ? 0 : 1;
+}
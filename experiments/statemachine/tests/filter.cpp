@@ -0,0 +1,345 @@
+/*
+	Philip Romano
+	10/16/2026
+	filter.cpp
+
+	Test for BoxFilter, VelocityFilter and VelocityFilterBank
+	Checks the running-sum box filters, of a fixed window and of a window
+	set at run time, against the mean recomputed over the window every
+	frame (as HandMotion used to), the EMA against its closed
+	form, and that the 1-euro filter smooths a hand held still harder than
+	the EMA with the same cutoff while following a swipe more closely.
+	Checks that the Kalman filter, no noisier than the 3-frame box on a
+	hand held still, sees a swipe get fast a frame sooner and follows a
+	steady acceleration without lag, and that it tracks the palm position
+	closer than it is measured. Then checks that a bank keeps each hand's
+	filter by ID as hands come and go.
+*/
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <stdint.h>
+
+#include "velocityfilter.h"
+#include "handmotion.h"
+#include "handframe.h"
+
+namespace {
+	const int WINDOW = 5;
+
+	// A window VelocityFilter has no fixed-size path for
+	const int WIDE = 7;
+	const int SAMPLES = 200000;
+	const float PI = 3.14159265f;
+
+	// Speed at which a swipe is taken to be fast, in mm/s
+	const float FAST_SWIPE = 800.0f;
+}
+
+/**
+  Returns a pseudo-random number from -1 to 1.
+*/
+static float noise(uint32_t& x) {
+	x = x * 1664525 + 1013904223;
+	return (x >> 8) / 8388608.0f - 1.0f;
+}
+
+static Vector3 makeVector(float x, float y, float z) {
+	Vector3 v;
+	v.x = x;
+	v.y = y;
+	v.z = z;
+	return v;
+}
+
+/**
+  Mean of the given window of vectors, summed in float.
+*/
+static Vector3 windowMean(const std::vector<Vector3>& window) {
+	int size = window.size();
+	Vector3 mean = makeVector(0.0f, 0.0f, 0.0f);
+	for (int w = 0; w < size; ++w) {
+		mean.x += window[w].x / size;
+		mean.y += window[w].y / size;
+		mean.z += window[w].z / size;
+	}
+	return mean;
+}
+
+static float offBy(const Vector3& a, const Vector3& b) {
+	return std::max(std::fabs(a.x - b.x),
+			std::max(std::fabs(a.y - b.y), std::fabs(a.z - b.z)));
+}
+
+static bool box() {
+	BoxFilter<WINDOW> fixed;
+	VelocityFilter running(WINDOW), wide(WIDE);
+	std::vector<Vector3> history(WINDOW, makeVector(0.0f, 0.0f, 0.0f));
+	std::vector<Vector3> wideHistory(WIDE, makeVector(0.0f, 0.0f, 0.0f));
+
+	// Large values, so that a running sum in float would drift
+	uint32_t x = 1;
+	float worst = 0.0f;
+	for (int i = 0; i < SAMPLES; ++i) {
+		Vector3 v = makeVector(2000.0f * noise(x), 2000.0f * noise(x),
+				2000.0f * noise(x));
+		history[i % WINDOW] = v;
+		wideHistory[i % WIDE] = v;
+
+		const Vector3& a = fixed.update(v);
+		const Vector3& b = running.update(v, i * 10000);
+		const Vector3& c = wide.update(v, i * 10000);
+		worst = std::max(worst, offBy(a, windowMean(history)));
+		worst = std::max(worst, offBy(b, a));
+		worst = std::max(worst, offBy(c, windowMean(wideHistory)));
+	}
+
+	// Reset starts from rest again
+	running.reset();
+	const Vector3& first = running.update(makeVector(5.0f, 0.0f, 0.0f), 0);
+	bool success = worst < 0.01f && first.x == 1.0f;
+	if (!success)
+		std::cout << "Box filter off by " << worst << std::endl;
+	return success;
+}
+
+static bool ema() {
+	VelocityFilter filter;
+	filter.setEma(0.25f);
+
+	// A step from rest: 1 - 0.75^k of the way there after k frames
+	bool success = filter.getKind() == VelocityFilter::EMA;
+	for (int k = 1; k <= 20; ++k) {
+		const Vector3& v = filter.update(makeVector(100.0f, -100.0f, 0.0f),
+				k * 10000);
+		float expected = 100.0f * (1.0f - std::pow(0.75f, (float)k));
+		success &= std::fabs(v.x - expected) < 0.01f
+			&& std::fabs(v.y + expected) < 0.01f;
+	}
+	return success;
+}
+
+/**
+  Root mean square error of filter against a hand held still, with noise,
+  for 2 seconds; then the largest error while it follows a swipe (a half
+  sine to 1000 mm/s and back, over 0.3 s), at 100 Hz. If crossed is not
+  null, it is set to when the smoothed swipe first reached FAST_SWIPE,
+  in frames from the start of the swipe, interpolated between frames.
+*/
+static void score(VelocityFilter& filter, float& still, float& swipe,
+		float *crossed = NULL) {
+	filter.reset();
+	uint32_t x = 7;
+	int64_t time = 0;
+	double squares = 0.0;
+	for (int i = 0; i < 200; ++i, time += 10000) {
+		const Vector3& v = filter.update(makeVector(20.0f * noise(x),
+					20.0f * noise(x), 20.0f * noise(x)), time);
+		squares += v.x * v.x + v.y * v.y + v.z * v.z;
+	}
+	still = (float)std::sqrt(squares / 200.0);
+
+	swipe = 0.0f;
+	float last = filter.get().x;
+	if (crossed)
+		*crossed = -1.0f;
+	for (int i = 0; i <= 30; ++i, time += 10000) {
+		float speed = 1000.0f * std::sin(PI * i / 30.0f);
+		const Vector3& v = filter.update(makeVector(speed, 0.0f, 0.0f),
+				time);
+		swipe = std::max(swipe, std::fabs(v.x - speed));
+		if (crossed && *crossed < 0.0f && v.x >= FAST_SWIPE)
+			*crossed = i - 1 + (FAST_SWIPE - last) / (v.x - last);
+		last = v.x;
+	}
+}
+
+static bool oneEuro() {
+	// Same cutoff at rest
+	VelocityFilter euro, ema;
+	euro.setOneEuro(1.0f, 0.002f);
+	ema.setEma(1.0f / (1.0f + 1.0f / (2.0f * PI * 1.0f * 0.01f)));
+
+	float euroStill, euroSwipe, emaStill, emaSwipe;
+	score(euro, euroStill, euroSwipe);
+	score(ema, emaStill, emaSwipe);
+
+	// A higher cutoff at rest follows the swipe, but lets the noise through
+	VelocityFilter quick;
+	quick.setEma(0.5f);
+	float quickStill, quickSwipe;
+	score(quick, quickStill, quickSwipe);
+
+	bool success = euroStill <= emaStill * 1.5f && euroSwipe < emaSwipe / 2
+		&& euroStill < quickStill / 2;
+	std::cout << "Still rms / swipe error (mm/s): 1-euro " << euroStill
+		<< " / " << euroSwipe << ", slow EMA " << emaStill << " / "
+		<< emaSwipe << ", fast EMA " << quickStill << " / " << quickSwipe
+		<< std::endl;
+	return success;
+}
+
+static bool kalman() {
+	// No noisier than the box on a hand held still, and a frame sooner
+	// to see a swipe is fast
+	VelocityFilter filter(VelocityFilter::KALMAN), box(3);
+	float kalmanStill, kalmanSwipe, kalmanCrossed;
+	float boxStill, boxSwipe, boxCrossed;
+	score(filter, kalmanStill, kalmanSwipe, &kalmanCrossed);
+	score(box, boxStill, boxSwipe, &boxCrossed);
+	float lead = boxCrossed - kalmanCrossed;
+	bool success = filter.getKind() == VelocityFilter::KALMAN
+		&& kalmanStill <= boxStill && kalmanCrossed >= 0.0f
+		&& boxCrossed >= 0.0f && lead >= 1.0f;
+	std::cout << "Still rms / swipe error (mm/s): Kalman " << kalmanStill
+		<< " / " << kalmanSwipe << ", 3-frame box " << boxStill << " / "
+		<< boxSwipe << "; Kalman reaches " << FAST_SWIPE << " mm/s "
+		<< lead << " frames sooner" << std::endl;
+
+	// Speeding up at 5000 mm/s^2 for a second: the box lags a frame's
+	// worth, 50 mm/s, behind
+	filter.reset();
+	box.reset();
+	float speed = 0.0f;
+	for (int i = 0; i <= 100; ++i) {
+		speed = 50.0f * i;
+		filter.update(makeVector(speed, 0.0f, 0.0f), i * 10000);
+		box.update(makeVector(speed, 0.0f, 0.0f), i * 10000);
+	}
+	success &= std::fabs(filter.get().x - speed) < 1.0f
+		&& std::fabs(box.get().x - speed) > 45.0f;
+
+	// A palm moving at 200 mm/s, its position measured to within 5 mm:
+	// estimated closer than that, at the time of each frame
+	filter.reset();
+	uint32_t x = 3;
+	double squares = 0.0;
+	for (int i = 0; i < 200; ++i) {
+		float at = 2.0f * i;
+		filter.update(makeVector(200.0f, 0.0f, 0.0f),
+				makeVector(at + 5.0f * noise(x), 100.0f, 0.0f), i * 10000);
+		float error = filter.getPosition().x - at;
+		if (i >= 100)
+			squares += error * error;
+	}
+	success &= std::sqrt(squares / 100.0) < 1.5
+		&& std::fabs(filter.getPosition().y - 100.0f) < 0.5f;
+
+	// Without it, the distance moved: 100 mm over the last half second,
+	// once the filter has caught up with the hand starting from rest
+	filter.reset();
+	float halfway = 0.0f;
+	for (int i = 0; i <= 100; ++i) {
+		filter.update(makeVector(200.0f, 0.0f, 0.0f), i * 10000);
+		if (i == 50)
+			halfway = filter.getPosition().x;
+	}
+	success &= std::fabs(filter.getPosition().x - halfway - 100.0f) < 1.0f
+		&& filter.getPosition().x > 190.0f;
+
+	// The other filters keep the position given
+	box.update(makeVector(0.0f, 0.0f, 0.0f), makeVector(1.0f, 2.0f, 3.0f),
+			0);
+	success &= box.getPosition().z == 3.0f;
+	return success;
+}
+
+static bool parsing() {
+	VelocityFilter filter;
+	bool success = VelocityFilter::parse("ema:0.3", filter)
+		&& filter.getKind() == VelocityFilter::EMA
+		&& VelocityFilter::parse("euro:1,0.01", filter)
+		&& filter.getKind() == VelocityFilter::ONE_EURO
+		&& VelocityFilter::parse("kalman:10000,30", filter)
+		&& filter.getKind() == VelocityFilter::KALMAN
+		&& !VelocityFilter::parse("kalman:10000,0", filter)
+		&& VelocityFilter::parse("box", filter)
+		&& filter.getKind() == VelocityFilter::BOX
+		&& !VelocityFilter::parse("ema:2", filter)
+		&& !VelocityFilter::parse("box:3,4", filter)
+		&& !VelocityFilter::parse("median:3", filter)
+		&& filter.getKind() == VelocityFilter::BOX;
+	return success;
+}
+
+static void makeFrame(int64_t i, const int32_t *ids, int count,
+		HandFrame& frame) {
+	frame.clear();
+	frame.id = i;
+	frame.timestamp = i * 10000;
+	frame.handCount = count;
+	for (int h = 0; h < count; ++h) {
+		HandData& hand = frame.hands[h];
+		hand.id = ids[h];
+		hand.palmVelocity = makeVector((float)ids[h], 0.0f, 0.0f);
+		hand.fingerCount = 0;
+	}
+}
+
+static bool bank() {
+	VelocityFilterBank bank(VelocityFilter(2));
+	HandFrame frame;
+
+	// Hands 7 and 9, then 9 and 7 (reordered), then 9 alone, then 7 again
+	const int32_t both[] = { 7, 9 }, swapped[] = { 9, 7 }, nine[] = { 9 },
+		seven[] = { 7 };
+	makeFrame(0, both, 2, frame);
+	bank.update(frame);
+	bool success = bank.getHandCount() == 2 && bank.getHandId(1) == 9
+		&& bank.getVelocity(0).x == 3.5f && bank.getVelocity(1).x == 4.5f;
+
+	makeFrame(1, swapped, 2, frame);
+	bank.update(frame);
+	success &= bank.findVelocity(9)->x == 9.0f
+		&& bank.findVelocity(7)->x == 7.0f;
+
+	makeFrame(2, nine, 1, frame);
+	bank.update(frame);
+	success &= bank.getHandCount() == 1 && bank.findVelocity(7) == NULL;
+
+	// Hand 7 comes back from rest
+	makeFrame(3, seven, 1, frame);
+	bank.update(frame);
+	success &= bank.findVelocity(7)->x == 3.5f;
+
+	// The same velocity HandMotion follows
+	HandData hand;
+	hand.palmVelocity = makeVector(10.0f, 0.0f, 0.0f);
+	hand.fingerCount = 2;
+	hand.fingers[0].tipVelocity = makeVector(20.0f, 0.0f, 0.0f);
+	hand.fingers[1].tipVelocity = makeVector(40.0f, 0.0f, 0.0f);
+	success &= HandMotion::getRawVelocity(hand).x == 20.0f;
+	return success;
+}
+
+int main(int argc, char **argv) {
+	bool success = true;
+
+	bool result = box();
+	std::cout << "Box filter: " << (result ? "ok" : "FAILED") << std::endl;
+	success &= result;
+
+	result = ema();
+	std::cout << "EMA: " << (result ? "ok" : "FAILED") << std::endl;
+	success &= result;
+
+	result = oneEuro();
+	std::cout << "1-euro: " << (result ? "ok" : "FAILED") << std::endl;
+	success &= result;
+
+	result = kalman();
+	std::cout << "Kalman: " << (result ? "ok" : "FAILED") << std::endl;
+	success &= result;
+
+	result = parsing();
+	std::cout << "Parsing: " << (result ? "ok" : "FAILED") << std::endl;
+	success &= result;
+
+	result = bank();
+	std::cout << "Filter bank: " << (result ? "ok" : "FAILED") << std::endl;
+	success &= result;
+
+	std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+	return success ? 0 : 1;
+}
@@ -0,0 +1,214 @@
+/*
+	Philip Romano
+	10/16/2026
+	hands.cpp
+
+	Test for HandTrackSet
+	Plays every gesture with two hands at once through the graph of
+	train.cpp, and checks that each hand's session recognizes each one.
+	Then checks that tracks keep their hands by ID as hands come, go and
+	reorder, that each track smooths its hand's velocity as a
+	VelocityFilterBank does, and that hands beyond the capacity are
+	counted and not followed.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/bind/bind.hpp>
+
+#include "handtrackset.h"
+#include "featureframe.h"
+#include "velocityfilter.h"
+#include "handsynthesizer.h"
+#include "handframe.h"
+#include "gesturestategraph.h"
+#include "gesturesession.h"
+
+#include "traingraph.h"
+
+namespace {
+	const int NODES = 6;
+	const char *NODE_IDS[NODES] = {
+		"swL", "swR", "swU", "swD", "push", "pull"
+	};
+}
+
+/**
+  Counts, by hand ID, the frames each node was entered on.
+*/
+class Entered {
+	public:
+		void enter(int node, const HandFrame& frame) {
+			const FeatureFrame& features =
+				static_cast<const FeatureFrame&>(frame);
+			hands[node].push_back(features.handId);
+		}
+
+		std::vector<int32_t> hands[NODES];
+};
+
+static bool gestures() {
+	TrainGraph train;
+	GestureStateGraph& graph = train.getGraph();
+	Entered entered;
+	for (int i = 0; i < NODES; ++i) {
+		graph.setEnterAction(NODE_IDS[i], boost::bind(&Entered::enter,
+					&entered, i, boost::placeholders::_1));
+	}
+	HandTrackSet tracks(graph.compile(), train.getExtractor());
+
+	// The second hand follows the first 150 ms behind; the rests are
+	// long enough that each hand's swipes stay apart
+	HandSynthesizer synth;
+	synth.setHands(2);
+	synth.setNoise(20.0f);
+	synth.addStep(HandSynthesizer::IDLE, 500000);
+	for (int m = HandSynthesizer::SWIPE_LEFT; m <= HandSynthesizer::PULL;
+			++m) {
+		synth.addStep((HandSynthesizer::Motion)m, 400000);
+		synth.addStep(HandSynthesizer::IDLE, 500000);
+	}
+
+	// The train graph reports unexpected swipes on std::cout; keep them out
+	// of the test's output
+	std::cout.setstate(std::ios::failbit);
+	HandFrame frame;
+	int most = 0;
+	while (synth.next(frame)) {
+		tracks.update(frame);
+		most = std::max(most, tracks.getTrackCount());
+	}
+	std::cout.clear();
+
+	// Both hands stay in view throughout, in tracks 0 and 1
+	bool success = most == 2 && tracks.getHandId(0) != tracks.getHandId(1)
+		&& tracks.findTrack(tracks.getHandId(1)) == 1;
+	for (int i = 0; i < NODES; ++i) {
+		const std::vector<int32_t>& hands = entered.hands[i];
+		bool both = hands.size() == 2 && hands[0] == tracks.getHandId(0)
+			&& hands[1] == tracks.getHandId(1);
+		if (!both) {
+			std::cout << NODE_IDS[i] << " entered " << hands.size()
+				<< " times, expected once by each hand" << std::endl;
+			success = false;
+		}
+	}
+	return success;
+}
+
+static bool tracking() {
+	TrainGraph train;
+	FeatureExtractor extractor(4, 0);
+	extractor.require(FeatureFrame::VELOCITY);
+	HandTrackSet tracks(train.getGraph().compile(), extractor);
+	VelocityFilterBank bank(VelocityFilter(4));
+
+	// Three hands, with dropouts: hands leave and come back, and the
+	// frame's order of hands changes as they do
+	HandSynthesizer synth(100.0, 11);
+	synth.setHands(3);
+	synth.setNoise(30.0f);
+	synth.setDropout(0.05);
+	synth.addRandomSteps(30);
+
+	std::cout.setstate(std::ios::failbit);
+	HandFrame frame;
+	bool success = true;
+	int64_t frames = 0, moved = 0;
+	std::vector<int32_t> last(tracks.getCapacity(), -1);
+	while (synth.next(frame)) {
+		tracks.update(frame);
+		bank.update(frame);
+		++frames;
+
+		success &= tracks.getTrackCount() == frame.handCount;
+		for (int h = 0; h < frame.handCount; ++h) {
+			int i = tracks.findTrack(frame.hands[h].id);
+			if (i < 0) {
+				success = false;
+				continue;
+			}
+
+			// A track keeps its hand for as long as the hand stays
+			const FeatureFrame& features = tracks.getFeatures(i);
+			moved += (last[i] != frame.hands[h].id) ? 1 : 0;
+			last[i] = frame.hands[h].id;
+
+			const Vector3& velocity =
+				*bank.findVelocity(frame.hands[h].id);
+			success &= features.id == frame.id && features.hasHand
+				&& features.handId == frame.hands[h].id
+				&& features.velocity.x == velocity.x
+				&& features.velocity.y == velocity.y
+				&& features.velocity.z == velocity.z;
+		}
+	}
+	std::cout.clear();
+
+	// Hands come back under new IDs after each NONE step, so tracks are
+	// reused, but far less often than once per frame
+	success &= moved > 3 && moved < frames / 10 && tracks.getDropped() == 0;
+	if (!success) {
+		std::cout << "Tracks lost their hands (" << moved
+			<< " hands taken over " << frames << " frames)" << std::endl;
+	}
+	return success;
+}
+
+static bool capacity() {
+	TrainGraph train;
+	HandTrackSet tracks(train.getGraph().compile(), train.getExtractor(),
+			2);
+
+	HandSynthesizer synth;
+	synth.setHands(3);
+	synth.addStep(HandSynthesizer::IDLE, 1000000);
+	synth.addStep(HandSynthesizer::NONE, 500000);
+
+	// The third hand comes into view 300 ms after the first
+	HandFrame frame;
+	bool success = true;
+	int64_t full = 0;
+	while (synth.next(frame)) {
+		tracks.update(frame);
+		success &= tracks.getTrackCount()
+			== std::min((int)frame.handCount, 2);
+		full += (frame.handCount == 3) ? 1 : 0;
+	}
+
+	// Every hand has left; the tracks are free again
+	success &= full > 0 && tracks.getDropped() == full
+		&& tracks.getTrackCount() == 0
+		&& !tracks.getFeatures(0).hasHand;
+
+	tracks.reset();
+	success &= tracks.getSession(1).getCurrentNode()
+		== tracks.getSessions().getGraph().getStart();
+	return success;
+}
+
+int main(int argc, char **argv) {
+	bool success = true;
+
+	bool result = gestures();
+	std::cout << "Two-handed gestures: " << (result ? "ok" : "FAILED")
+		<< std::endl;
+	success &= result;
+
+	result = tracking();
+	std::cout << "Tracking by ID: " << (result ? "ok" : "FAILED")
+		<< std::endl;
+	success &= result;
+
+	result = capacity();
+	std::cout << "Capacity: " << (result ? "ok" : "FAILED") << std::endl;
+	success &= result;
+
+	std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+	return success ? 0 : 1;
+}
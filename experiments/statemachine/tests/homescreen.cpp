@@ -9,6 +9,7 @@
 */
 
 #include <iostream>
+#include <fstream>
 #include <string>
 #include <math.h>
 
@@ -21,10 +22,17 @@
 #include <GL/gl.h>
 #include <GL/glu.h>
 #include <boost/shared_ptr.hpp>
-#include <boost/lexical_cast.hpp>
+#include <boost/bind/bind.hpp>
 
 #include "gesturestategraph.h"
 #include "gesturenode.h"
+#include "leapframe.h"
+#include "frameresampler.h"
+#include "handframe.h"
+#include "homescreengraph.h"
+#include "gesturetrace.h"
+#include "gesturelatency.h"
+#include "gestureprofile.h"
 
 #ifdef _WIN32
 #undef main // Windows doesn't like the SDL_main thing
@@ -55,530 +63,31 @@ class EngineException : public std::exception {
 
 class Engine : public Leap::Listener {
 	public:
-		class Node_Motion : public GestureNode {
-			private:
-				Engine *e;
-				double mThreshold;
-
-			public:
-				Node_Motion(Engine *creator, double threshold = 300.0) {
-					e = creator;
-					mThreshold = threshold;
-				}
-
-				virtual const std::string& getName() {
-					static std::string name("Motion");
-					return name;
-				}
-
-				/**
-				  Determines if there is one hand, and its speed is greater
-				  than a threshold value.
-
-				  Slots:
-					1 if one hand is present, and the magnitude of velocity is
-					    >= threshold
-					0 otherwise
-				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					if (e->mMainHand.isValid()
-							&& e->mHandVelocity.magnitude() >= mThreshold)
-						return 1;
-					else {
-						e->mListNudge = e->mHandVelocity.x;
-						e->mStackNudge = -e->mHandVelocity.y;
-						return 0;
-					}
-				}
-		};
-
-		class Node_CoarseDirection : public GestureNode {
-			private:
-				Engine *e;
-
-			public:
-				Node_CoarseDirection(Engine *creator) {
-					e = creator;
-				}
-
-				virtual const std::string& getName() {
-					static std::string name("CoarseDirection");
-					return name;
-				}
-
-				/**
-				  Determines the direction of motion; vertical, horizontal, or
-				  depth-wise. The regions are split by the planes y = x,
-				  y = -x, y = z, and y = -z.
-
-				  Slots:
-					0 if vertical motion   [ |vy| > |vx| && |vy| > |vz| ]
-					1 if horizontal motion [ |vx| > |vy| && |vx| > |vz| ]
-					2 if depthwise motion  [ otherwise ]
-					                       // [ |vz| > |vx| && |vz| > |vy| ]
-
-					3 if error! ...no hands :(
-				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					// TODO Try getting rid of this check... it shouldn't be
-					// necessary with the right flow of states
-					if (e->mMainHand.isValid()) {
-						if (abs(e->mHandVelocity.y) > abs(e->mHandVelocity.x)
-						 && abs(e->mHandVelocity.y) > abs(e->mHandVelocity.z))
-							return 0;
-						else if (
-							abs(e->mHandVelocity.x) > abs(e->mHandVelocity.y)
-						 && abs(e->mHandVelocity.x) > abs(e->mHandVelocity.z))
-							return 1;
-						else
-							return 2;
-					} else {
-						std::cout << "BAD!!" << std::endl;
-						return 3;
-					}
-				}
-		};
-
-		class Node_LeftRight : public GestureNode {
-			private:
-				Engine *e;
-				std::string mName;
-				double mThreshold;
-
-			public:
-				/**
-				  getName() returns "LeftRight" + integer truncation of
-				  threshold
-				*/
-				Node_LeftRight(Engine *creator, double threshold = 0.0f) {
-					e = creator;
-					mThreshold = threshold;
-					mName = "LeftRight";
-					mName.append(
-						boost::lexical_cast<std::string>((int)mThreshold));
-				}
-
-				virtual const std::string& getName() {
-					return mName;
-				}
-
-				/**
-				  Determines whether the motion is leftwards or rightwards.
-
-				  Slots:
-					0 if leftward motion  [ vx <= -threshold ]
-					1 if rightward motion [ vx >=  threshold ]
-					2 if within threshold [ -threshold < vx < threshold ]
-
-					2 if error! ...no hands :(
-				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					if (e->mMainHand.isValid()) {
-						if (e->mHandVelocity.x <= -mThreshold) {
-							if (nodeid.compare("swL") == 0)
-								e->mListNudge = 2.0 * e->mHandVelocity.x;
-							return 0;
-						} else if (e->mHandVelocity.x >= mThreshold) {
-							if (nodeid.compare("swR") == 0)
-								e->mListNudge = 2.0 * e->mHandVelocity.x;
-							return 1;
-						} else {
-							return 2;
-						}
-					} else {
-						std::cout << "BAD!!" << std::endl;
-						return 3;
-					}
-				}
-
-				virtual void onEnter(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					if (nodeid.compare("swL") == 0) {
-						e->mSelection++;
-						if (e->mSelection >= e->mNumSelections) {
-							e->mListPosition -= e->mNumSelections;
-							e->mSelection = 0;
-						}
-					} else if (nodeid.compare("swR") == 0) {
-						e->mSelection--;
-						if (e->mSelection < 0) {
-							e->mListPosition += e->mNumSelections;
-							e->mSelection = e->mNumSelections - 1;
-						}
-					}
-				}
-		};
-
-		class Node_UpDown : public GestureNode {
-			private:
-				Engine *e;
-				std::string mName;
-				double mThreshold;
-
-			public:
-				/**
-				  getName() returns "UpDown" + integer truncation of
-				  threshold
-				*/
-				Node_UpDown(Engine *creator, double threshold = 0.0) {
-					e = creator;
-					mThreshold = threshold;
-					mName = "UpDown";
-					mName.append(
-						boost::lexical_cast<std::string>((int)mThreshold));
-				}
-
-				virtual const std::string& getName() {
-					return mName;
-				}
-
-				/**
-				  Determines whether the motion is upwards or downwards.
-
-				  Slots:
-					0 if upward motion    [ vy <= -threshold ]
-					1 if downward motion  [ vy >=  threshold ]
-					2 if within threshold [ -threshold < vy < threshold ]
-
-					3 if error! ...no hands :(
-				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					if (e->mMainHand.isValid()) {
-						if (e->mHandVelocity.y <= -mThreshold)
-							return 0;
-						else if (e->mHandVelocity.y >= mThreshold)
-							return 1;
-						else
-							return 2;
-					} else {
-						std::cout << "BAD!!" << std::endl;
-						return 3;
-					}
-				}
-
-				virtual void onEnter(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					if (nodeid.compare("swU") == 0) {
-						if (e->mCurrentStack < e->mNumStacks - 1)
-							e->mCurrentStack++;
-					} else if (nodeid.compare("swD") == 0) {
-						if (e->mCurrentStack > 0)
-							e->mCurrentStack--;
-					}
-				}
-		};
-
-		class Node_ForeBack : public GestureNode {
-			private:
-				Engine *e;
-				std::string mName;
-				double mThreshold;
-
-			public:
-				/**
-				  getName() returns "ForeBack" + integer truncation of
-				  threshold
-				*/
-				Node_ForeBack(Engine *creator, double threshold = 0.0f) {
-					e = creator;
-					mThreshold = threshold;
-					mName = "ForeBack";
-					mName.append(
-						boost::lexical_cast<std::string>((int)mThreshold));
-				}
-
-				virtual const std::string& getName() {
-					return mName;
-				}
-
-				/**
-				  Determines whether the motion is forwards or backwards.
-
-				  Slots:
-					0 if foreward motion  [ vz < -threshold ]
-					1 if backward motion  [ vz >  threshold ]
-					2 if within threshold [ -threshold < vz < threshold ]
-
-					3 if error! ...no hands :(
-				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					if (e->mMainHand.isValid()) {
-						if (e->mHandVelocity.z < -mThreshold) {
-							e->mTargetZoom += 0.0002 * e->mHandVelocity.z;
-							return 0;
-						} else if (e->mHandVelocity.z > mThreshold) {
-							e->mTargetZoom += 0.0002 * e->mHandVelocity.z;
-							return 1;
-						} else
-							return 2;
-					} else {
-						std::cout << "BAD!!" << std::endl;
-						return 3;
-					}
-				}
-
-				virtual void onLeave(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					e->mTargetZoom = 0.0;
-				}
-		};
-
-		class Node_LeftRightLimbo : public GestureNode {
-			private:
-				Engine *e;
-				uint64_t mTimeStart;
-				uint64_t mTimelimit;
-				double   mThreshold;
-
-			public:
-				/**
-				  timer : number of microseconds before timing out (slot 0)
-				  threshold : minimum threshold of hand speed to leave state
-				      Should be positive (it is absolute-valued anyway)
-				*/
-				Node_LeftRightLimbo(Engine *creator,
-						uint64_t timer = 100000,
-						double threshold = 50.0) {
-					e = creator;
-					mTimeStart = 0;
-					mThreshold = abs(threshold);
-					mTimelimit = timer;
-				}
-
-				virtual const std::string& getName() {
-					static std::string name("LRLimbo");
-					return name;
-				}
-
-				/**
-				  Waits in this state until either a timer runs out, or the
-				  speed in the x direction becomes greater than a threshold.
-
-				  Slots:
-				    3 if moving rightwards  [ vx >= threshold ]
-					2 if moving leftwards   [ vx <= -theshold ]
-					1 if negligible movemtn [ -threshold < vx < threshold ]
-					0 if the timer runs out, or no hand is present
-				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					if (e->mMainHand.isValid()
-							&& frame.timestamp() - mTimeStart < mTimelimit) {
-						if (e->mHandVelocity.x >= mThreshold)
-							return 3;
-						else if (e->mHandVelocity.x <= -mThreshold)
-							return 2;
-						else
-							return 1;
-					} else
-						return 0;
-				}
-
-				virtual void onEnter(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					mTimeStart = frame.timestamp();
-				}
-		};
-
-		class Node_UpDownLimbo : public GestureNode {
-			private:
-				Engine *e;
-				uint64_t mTimeStart;
-				uint64_t mTimelimit;
-				double   mThreshold;
-
-			public:
-				/**
-				  timer : number of microseconds before timing out (slot 0)
-				  threshold : minimum threshold of hand speed to leave state
-				      Should be positive (it is absolute-valued anyway)
-				*/
-				Node_UpDownLimbo(Engine *creator,
-						uint64_t timer = 100000,
-						double threshold = 50.0) {
-					e = creator;
-					mTimeStart = 0;
-					mThreshold = abs(threshold);
-					mTimelimit = timer;
-				}
-
-				virtual const std::string& getName() {
-					static std::string name("UDLimbo");
-					return name;
-				}
-
-				/**
-				  Waits in this state until either a timer runs out, or the
-				  speed in the y direction becomes greater than a threshold.
-
-				  Slots:
-				    3 if moving upwards     [ vy >= threshold ]
-					2 if moving downwards   [ vy <= -theshold ]
-					1 if negligible movemnt [ -threshold < vy < threshold ]
-					0 if the timer runs out, or no hand is present
-				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					if (e->mMainHand.isValid()
-							&& frame.timestamp() - mTimeStart < mTimelimit) {
-						if (e->mHandVelocity.y >= mThreshold)
-							return 3;
-						else if (e->mHandVelocity.y <= -mThreshold)
-							return 2;
-						else
-							return 1;
-					} else
-						return 0;
-				}
-
-				virtual void onEnter(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					mTimeStart = frame.timestamp();
-				}
-		};
-
 		Engine() {
-			mMainHand = Leap::Hand::invalid();
-
-			bool success = true;
-
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_Motion(this, 50.0)));
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_CoarseDirection(this)));
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_LeftRight(this, 200.0)));
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_LeftRight(this, 0.0)));
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_UpDown(this, 200.0)));
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_UpDown(this, 0.0)));
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_ForeBack(this, 5.0)));
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_ForeBack(this, 10.0)));
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_LeftRightLimbo(this, 100000, 100.0)));
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_UpDownLimbo(this, 100000, 100.0)));
-
-			if (!success)
-				throw EngineException("Node type creation failed");
-
-			/* Nodes */
-
-			mGraph.addNode("Motion",          "noMotion");
-			mGraph.addNode("CoarseDirection", "coarse");
-			mGraph.addNode("LeftRight200",    "stHorizontal");
-			mGraph.addNode("UpDown200",       "stVertical");
-			mGraph.addNode("ForeBack5",       "stDepth");
-
-			mGraph.addNode("LeftRight0", "swL");
-			mGraph.addNode("LeftRight0", "swR");
-			mGraph.addNode("UpDown0",    "swU");
-			mGraph.addNode("UpDown0",    "swD");
-			mGraph.addNode("ForeBack10",  "pull");
-			mGraph.addNode("ForeBack10",  "push");
-
-			mGraph.addNode("LRLimbo",     "swLToBacktrack");
-			mGraph.addNode("LeftRight0",  "swLBacktrack");
-			mGraph.addNode("LRLimbo",     "swLFromBacktrack");
-			mGraph.addNode("LRLimbo",     "swRToBacktrack");
-			mGraph.addNode("LeftRight0",  "swRBacktrack");
-			mGraph.addNode("LRLimbo",     "swRFromBacktrack");
-
-			mGraph.addNode("UDLimbo",     "swUToBacktrack");
-			mGraph.addNode("UpDown0",     "swUBacktrack");
-			mGraph.addNode("UDLimbo",     "swUFromBacktrack");
-			mGraph.addNode("UDLimbo",     "swDToBacktrack");
-			mGraph.addNode("UpDown0",     "swDBacktrack");
-			mGraph.addNode("UDLimbo",     "swDFromBacktrack");
-
-			mGraph.setStart("noMotion");
-
-			/* Connections */
-
-			mGraph.addConnection("noMotion", 1, "coarse");
-			mGraph.addConnection("coarse",   0, "stVertical");
-			mGraph.addConnection("coarse",   1, "stHorizontal");
-			mGraph.addConnection("coarse",   2, "stDepth");
-
-			mGraph.addConnection("stHorizontal", 0, "swL");
-			mGraph.addConnection("stHorizontal", 1, "swR");
-			mGraph.addConnection("stVertical",   0, "swD");
-			mGraph.addConnection("stVertical",   1, "swU");
-			mGraph.addConnection("stDepth",      0, "push");
-			mGraph.addConnection("stDepth",      1, "pull");
-
-			// Swipe LEFT sub-cycle
-			mGraph.addConnection("swL",              0, "swL");
-			mGraph.addConnection("swL",              1, "swLToBacktrack");
-			mGraph.addConnection("swL",              2, "swLToBacktrack");
-			mGraph.addConnection("swLToBacktrack",   1, "swLToBacktrack");
-			mGraph.addConnection("swLToBacktrack",   2, "swLToBacktrack");
-			mGraph.addConnection("swLToBacktrack",   3, "swLBacktrack");
-			mGraph.addConnection("swLBacktrack",     0, "swLFromBacktrack");
-			mGraph.addConnection("swLBacktrack",     1, "swLBacktrack");
-			mGraph.addConnection("swLBacktrack",     2, "");
-			mGraph.addConnection("swLFromBacktrack", 1, "swLFromBacktrack");
-			mGraph.addConnection("swLFromBacktrack", 2, "swL");
-			mGraph.addConnection("swLFromBacktrack", 3, "swLFromBacktrack");
-
-			// Swipe RIGHT sub-cycle
-			mGraph.addConnection("swR",              0, "swRToBacktrack");
-			mGraph.addConnection("swR",              1, "swR");
-			mGraph.addConnection("swR",              2, "swRToBacktrack");
-			mGraph.addConnection("swRToBacktrack",   1, "swRToBacktrack");
-			mGraph.addConnection("swRToBacktrack",   2, "swRBacktrack");
-			mGraph.addConnection("swRToBacktrack",   3, "swRToBacktrack");
-			mGraph.addConnection("swRBacktrack",     0, "swRBacktrack");
-			mGraph.addConnection("swRBacktrack",     1, "swRFromBacktrack");
-			mGraph.addConnection("swRBacktrack",     2, "");
-			mGraph.addConnection("swRFromBacktrack", 1, "swRFromBacktrack");
-			mGraph.addConnection("swRFromBacktrack", 2, "swRFromBacktrack");
-			mGraph.addConnection("swRFromBacktrack", 3, "swR");
-
-			// Swipe UP sub-cycle
-			mGraph.addConnection("swU",              0, "swUToBacktrack");
-			mGraph.addConnection("swU",              1, "swU");
-			mGraph.addConnection("swU",              2, "swUToBacktrack");
-			mGraph.addConnection("swUToBacktrack",   1, "swUToBacktrack");
-			mGraph.addConnection("swUToBacktrack",   2, "swUBacktrack");
-			mGraph.addConnection("swUToBacktrack",   3, "swUToBacktrack");
-			mGraph.addConnection("swUBacktrack",     0, "swUBacktrack");
-			mGraph.addConnection("swUBacktrack",     1, "swUFromBacktrack");
-			mGraph.addConnection("swUBacktrack",     2, "");
-			mGraph.addConnection("swUFromBacktrack", 1, "swUFromBacktrack");
-			mGraph.addConnection("swUFromBacktrack", 2, "swUFromBacktrack");
-			mGraph.addConnection("swUFromBacktrack", 3, "swU");
-
-			// Swipe DOWN sub-cycle
-			mGraph.addConnection("swD",              0, "swD");
-			mGraph.addConnection("swD",              1, "swDToBacktrack");
-			mGraph.addConnection("swD",              2, "swDToBacktrack");
-			mGraph.addConnection("swDToBacktrack",   1, "swDToBacktrack");
-			mGraph.addConnection("swDToBacktrack",   2, "swDToBacktrack");
-			mGraph.addConnection("swDToBacktrack",   3, "swDBacktrack");
-			mGraph.addConnection("swDBacktrack",     0, "swDFromBacktrack");
-			mGraph.addConnection("swDBacktrack",     1, "swDBacktrack");
-			mGraph.addConnection("swDBacktrack",     2, "");
-			mGraph.addConnection("swDFromBacktrack", 1, "swDFromBacktrack");
-			mGraph.addConnection("swDFromBacktrack", 2, "swD");
-			mGraph.addConnection("swDFromBacktrack", 3, "swDFromBacktrack");
-
-			// PUSH
-			mGraph.addConnection("push", 0, "push");
-			mGraph.addConnection("push", 2, "push");
-
-			// PULL
-			mGraph.addConnection("pull", 1, "pull");
-			mGraph.addConnection("pull", 2, "pull");
+			GestureStateGraph& graph = mGestures.getGraph();
+
+			/* Actions */
+
+			graph.setEnterAction("swL",
+					boost::bind(&Engine::onSwipeLeft, this));
+			graph.setEnterAction("swR",
+					boost::bind(&Engine::onSwipeRight, this));
+			graph.setEnterAction("swU",
+					boost::bind(&Engine::onSwipeUp, this));
+			graph.setEnterAction("swD",
+					boost::bind(&Engine::onSwipeDown, this));
+
+			// Validate the graph before any frames arrive
+			graph.compile();
+
+			// Keep the most recent transitions; written out on exit
+			graph.setTrace(boost::shared_ptr<GestureTrace>(
+					new GestureTrace(4096)));
+
+			// Follow each gesture from the frame to the screen; reported
+			// on exit
+			mLatency.reset(new GestureLatency());
+			graph.setLatency(mLatency);
 		}
 
 		~Engine()
@@ -590,65 +99,34 @@ class Engine : public Leap::Listener {
 		}
 
 		virtual void onFrame(const Leap::Controller &c) {
-			Leap::Frame frame = c.frame(0);
-
-			bool swiping = false;
-			if (frame.hands().count() == 1) {
-				// Average of fingers + palm
-				mMainHand = (*frame.hands().begin());
-				
-				Leap::FingerList fingers = mMainHand.fingers();
-				mCurrentVelocity = Leap::Vector(0.0f, 0.0f, 0.0f);
-				if (fingers.count() > 0) {
-					for (Leap::FingerList::const_iterator it
-							= fingers.begin();
-							it != fingers.end(); ++it) {
-						mCurrentVelocity += (*it).tipVelocity();
-					}
-					mCurrentVelocity /= (float)fingers.count();
-				}
-				mCurrentVelocity += mMainHand.palmVelocity();
-				if (fingers.count() > 0)
-					mCurrentVelocity /= 2.0;
-				updateHandVelocity();
-
-				Leap::Vector xyvel = mHandVelocity;
-				xyvel.z = 0.0f;
-				mXYHandSpeed = xyvel.magnitude();
-
-				if (mMainHand.fingers().count() >= 3) {
-					swiping = true;
-					// Stupid temporary fun
-					// Maybe keep it?
-					mTargetRotate = 30.0 / PI * atan2(mMainHand.palmNormal().y,
-							mMainHand.palmNormal().z) + 20.0;
-					if (mTargetRotate > 50.0)
-						mTargetRotate = 50.0;
-					else if (mTargetRotate < -10.0)
-						mTargetRotate = -10.0;
-				} else {
-					if (mHandVelocity.magnitude() > 100.0) {
-						SDL_RestoreWindow(mWindow);
-						SDL_MaximizeWindow(mWindow);
-						SDL_RaiseWindow(mWindow);
-					}
-				}
+			toHandFrame(c.frame(0), mFrame);
+			mLatency->arrive(mFrame);
+			mResampler.push(mFrame);
+			while (mResampler.next(mResampled))
+				mGestures.update(mResampled);
+
+			if (mGestures.hasHand()) {
+				// Stupid temporary fun
+				// Maybe keep it?
+				const HandData& hand = mGestures.getMotion().getHand();
+				mTargetRotate = 30.0 / PI * atan2(hand.palmNormal.y,
+						hand.palmNormal.z) + 20.0;
+				if (mTargetRotate > 50.0)
+					mTargetRotate = 50.0;
+				else if (mTargetRotate < -10.0)
+					mTargetRotate = -10.0;
+			} else if (mFrame.handCount == 1
+					&& mFrame.hands[0].palmVelocity.magnitude() > 300.0) {
+				// A hand moving without enough fingers out to swipe
+				SDL_RestoreWindow(mWindow);
+				SDL_MaximizeWindow(mWindow);
+				SDL_RaiseWindow(mWindow);
 			}
-			
-			if (!swiping) {
-				initializeHandVelocity();
-				mMainHand = Leap::Hand::invalid();
-				mHandVelocity = Leap::Vector::zero();
-				mXYHandSpeed = 0.0f;
-			}
-
-			mGraph.updateWithPrint(frame);
 		}
 
 		void run() {
 			mRunning = true;
 			
-			initializeHandVelocity();
 			initializeGraphics();
 			initializeApplication();
 
@@ -657,30 +135,51 @@ class Engine : public Leap::Listener {
 			cleanUp();
 		}
 
+		/**
+		  Time every node evaluation; see writeProfile()
+		*/
+		void enableProfile() {
+			mGestures.getGraph().setProfile(
+					boost::shared_ptr<GestureProfile>(new GestureProfile()));
+		}
+
+		/**
+		  Write the node profile as CSV, if profiling was enabled. Frames
+		  must have stopped arriving.
+		*/
+		void writeProfile(const std::string& filename) {
+			GestureStateGraph& graph = mGestures.getGraph();
+			if (!graph.getProfile().get())
+				return;
+
+			std::ofstream out(filename.c_str());
+			graph.getProfile()->writeCsv(out, *graph.compile());
+		}
+
 	private:
-		GestureStateGraph mGraph;
+		HomescreenGraph mGestures;
+
+		// The latest Leap frame
+		HandFrame mFrame;
+
+		// Graph input: the Leap frames resampled to a steady 100 Hz, so
+		// that the graph's thresholds and smoothing do not depend on the
+		// rate the device manages
+		FrameResampler mResampler;
+		HandFrame mResampled;
+
+		boost::shared_ptr<GestureLatency> mLatency;
 
-		Leap::Hand   mMainHand;
-		Leap::Vector mHandVelocity;
-		double       mXYHandSpeed;
 		int          mSelection,
 		             mNumSelections,
 					 mCurrentStack,
 					 mNumStacks;
 		double       mListPosition,
-		             mListNudge,
 					 mStackPosition,
-		             mStackNudge,
 		             mZoom,
-		             mTargetZoom,
 		             mTargetRotate,
 					 mRotate;
 
-		Leap::Vector mCurrentVelocity;
-		int mNumSmoothing, mAverageVelocityCurrentIndex;
-		std::vector<Leap::Vector> mAverageVelocityBuffer;
-		Leap::Vector mAverageVelocity;
-
 		SDL_Window    *mWindow;
 		SDL_GLContext mGLContext;
 		int           mScreenWidth,
@@ -688,6 +187,32 @@ class Engine : public Leap::Listener {
 
 		bool mRunning;
 
+		void onSwipeLeft() {
+			mSelection++;
+			if (mSelection >= mNumSelections) {
+				mListPosition -= mNumSelections;
+				mSelection = 0;
+			}
+		}
+
+		void onSwipeRight() {
+			mSelection--;
+			if (mSelection < 0) {
+				mListPosition += mNumSelections;
+				mSelection = mNumSelections - 1;
+			}
+		}
+
+		void onSwipeUp() {
+			if (mCurrentStack < mNumStacks - 1)
+				mCurrentStack++;
+		}
+
+		void onSwipeDown() {
+			if (mCurrentStack > 0)
+				mCurrentStack--;
+		}
+
 		void initializeGraphics() {
 			if (SDL_Init(SDL_INIT_VIDEO) != 0)
 				throw EngineException("SDL_Init failed");
@@ -736,29 +261,19 @@ class Engine : public Leap::Listener {
 			glPushMatrix();
 		}
 
-		void initializeHandVelocity() {
-			mNumSmoothing = 3;
-			mAverageVelocityCurrentIndex = 0;
-			mAverageVelocityBuffer.clear();
-			for (int i = 0; i < mNumSmoothing; ++i) {
-				mAverageVelocityBuffer.push_back(
-						Leap::Vector(0.0f, 0.0f, 0.0f));
-			}
-		}
-
 		void initializeApplication() {
 			mCurrentStack = 0;
 			mNumStacks = 20;
-			mStackNudge = 0.0;
+			mGestures.mStackNudge = 0.0;
 			mStackPosition = 0.0;
 
 			mSelection = 0;
 			mNumSelections = 20;
-			mListNudge = 0.0;
+			mGestures.mListNudge = 0.0;
 			mListPosition = 0.0;
 
 			mZoom = 0.0;
-			mTargetZoom = 0.0;
+			mGestures.mTargetZoom = 0.0;
 
 			mRotate = 0.0;
 			mTargetRotate = 0.0;
@@ -768,25 +283,13 @@ class Engine : public Leap::Listener {
 			SDL_GL_DeleteContext(mGLContext);
 			SDL_DestroyWindow(mWindow);
 			SDL_Quit();
-		}
 
-		void updateHandVelocity() {
-			mAverageVelocityBuffer.at(mAverageVelocityCurrentIndex)
-				= mCurrentVelocity;
-			++mAverageVelocityCurrentIndex;
-			if (mAverageVelocityCurrentIndex >= mNumSmoothing)
-				mAverageVelocityCurrentIndex = 0;
-
-			std::vector<Leap::Vector>::iterator it
-				= mAverageVelocityBuffer.begin();
-			mAverageVelocity = (*it);
-			++it;
-			while (it != mAverageVelocityBuffer.end()) {
-				mAverageVelocity += (*it);
-				++it;
-			}
-			mAverageVelocity /= (float)mNumSmoothing;
-			mHandVelocity = mAverageVelocity;
+			std::ofstream trace("homescreen.trace", std::ios::binary);
+			mGestures.getGraph().writeTrace(trace);
+
+			std::ofstream latency("homescreen_latency.csv");
+			mLatency->writeCsv(latency, *mGestures.getGraph().compile());
+			mLatency->report(std::cout);
 		}
 
 		void runLoop() {
@@ -817,10 +320,14 @@ class Engine : public Leap::Listener {
 					}
 				}
 
+				// Whatever the gestures changed is picked up here...
+				mLatency->consume();
 				updatePosition();
 				renderFrame();
 
+				// ...and on screen here
 				SDL_GL_SwapWindow(mWindow);
+				mLatency->present();
 
 				while (SDL_GetTicks() - framestart < 1000 / 60)
 					SDL_Delay(1000 / 60 - (SDL_GetTicks() - framestart));
@@ -831,15 +338,15 @@ class Engine : public Leap::Listener {
 			// Horizontal position
 			double targetposition = (double)mSelection;
 			mListPosition += (targetposition - mListPosition) / 20.0f
-				- mListNudge * 0.00005f;
+				- mGestures.mListNudge * 0.00005f;
 
 			// Stack (vertical position)
 			targetposition = (double)mCurrentStack;
 			mStackPosition += (targetposition - mStackPosition) / 10.0f;
-				//- mStackNudge * 0.00005f;
+				//- mGestures.mStackNudge * 0.00005f;
 
 			// Zooming
-			mZoom += (mTargetZoom - mZoom) / 5.0f;
+			mZoom += (mGestures.mTargetZoom - mZoom) / 5.0f;
 			if (mZoom > 1.0)
 				mZoom = 1.0;
 			else if (mZoom < -1.0)
@@ -973,8 +480,16 @@ class Engine : public Leap::Listener {
 int main(int argc, char **argv) {
 	try {
 		Engine e;
-		Leap::Controller controller(e);
-		e.run();
+		if (argc > 1 && std::string(argv[1]) == "--profile")
+			e.enableProfile();
+
+		{
+			Leap::Controller controller(e);
+			e.run();
+		}
+
+		// The controller is gone, so no more frames will arrive
+		e.writeProfile("homescreen_profile.csv");
 		return 0;
 	} catch (EngineException& e) {
 		std::cout << "Exception: " << e.getMessage() << std::endl;
@@ -9,6 +9,7 @@
 */
 
 #include <iostream>
+#include <fstream>
 #include <string>
 #include <math.h>
 
@@ -21,10 +22,15 @@
 #include <GL/gl.h>
 #include <GL/glu.h>
 #include <boost/shared_ptr.hpp>
+#include <boost/bind/bind.hpp>
 #include <boost/lexical_cast.hpp>
 
 #include "gesturestategraph.h"
 #include "gesturenode.h"
+#include "leapframe.h"
+#include "handmotion.h"
+#include "velocityfilter.h"
+#include "gesturetrace.h"
 
 #ifdef _WIN32
 #undef main // Windows doesn't like the SDL_main thing
@@ -80,8 +86,8 @@ class Engine : public Leap::Listener {
 					    >= 200 mm/s
 					0 otherwise
 				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
+				virtual int evaluate(const HandFrame& frame,
+						const std::string& nodeid, void *state) {
 					if (e->mMainHand.isValid()
 							&& e->mXYHandSpeed >= mThreshold)
 						return 1;
@@ -119,8 +125,8 @@ class Engine : public Leap::Listener {
 
 					3 if error! ...no hands :(
 				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
+				virtual int evaluate(const HandFrame& frame,
+						const std::string& nodeid, void *state) {
 					// TODO Try getting rid of this check... it shouldn't be
 					// necessary with the right flow of states
 					if (e->mMainHand.isValid()) {
@@ -173,8 +179,8 @@ class Engine : public Leap::Listener {
 
 					2 if error! ...no hands :(
 				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
+				virtual int evaluate(const HandFrame& frame,
+						const std::string& nodeid, void *state) {
 					if (e->mMainHand.isValid()) {
 						if (e->mHandVelocity.x <= -mThreshold) {
 							if (nodeid.compare("swL") == 0)
@@ -192,25 +198,6 @@ class Engine : public Leap::Listener {
 						return 3;
 					}
 				}
-
-				virtual void onEnter(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					if (nodeid.compare("swL") == 0) {
-						e->mSelection++;
-						if (e->mSelection >= e->mNumSelections) {
-							e->mListPosition[e->mCurrentStack]
-								-= e->mNumSelections;
-							e->mSelection = 0;
-						}
-					} else if (nodeid.compare("swR") == 0) {
-						e->mSelection--;
-						if (e->mSelection < 0) {
-							e->mListPosition[e->mCurrentStack]
-								+= e->mNumSelections;
-							e->mSelection = e->mNumSelections - 1;
-						}
-					}
-				}
 		};
 
 		class Node_UpDown : public GestureNode {
@@ -246,8 +233,8 @@ class Engine : public Leap::Listener {
 
 					3 if error! ...no hands :(
 				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
+				virtual int evaluate(const HandFrame& frame,
+						const std::string& nodeid, void *state) {
 					if (e->mMainHand.isValid()) {
 						if (e->mHandVelocity.y <= -mThreshold)
 							return 0;
@@ -260,17 +247,6 @@ class Engine : public Leap::Listener {
 						return 3;
 					}
 				}
-
-				virtual void onEnter(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					if (nodeid.compare("swU") == 0) {
-						if (e->mCurrentStack < e->mNumStacks - 1)
-							e->mCurrentStack++;
-					} else if (nodeid.compare("swD") == 0) {
-						if (e->mCurrentStack > 0)
-							e->mCurrentStack--;
-					}
-				}
 		};
 
 		class Node_ForeBack : public GestureNode {
@@ -306,8 +282,8 @@ class Engine : public Leap::Listener {
 
 					3 if error! ...no hands :(
 				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
+				virtual int evaluate(const HandFrame& frame,
+						const std::string& nodeid, void *state) {
 					if (e->mMainHand.isValid()) {
 						if (e->mHandVelocity.z < -mThreshold) {
 							e->mTargetZoom += 0.0002 * e->mHandVelocity.z;
@@ -323,16 +299,23 @@ class Engine : public Leap::Listener {
 					}
 				}
 
-				virtual void onLeave(const Leap::Frame& frame,
-						const std::string& nodeid) {
+				virtual void onLeave(const HandFrame& frame,
+						const std::string& nodeid, void *state) {
 					e->mTargetZoom = 0.0;
 				}
 		};
 
-		class Node_LeftRightLimbo : public GestureNode {
+		/**
+		  Per-node state of the Limbo node types: the time at which the
+		  node was entered.
+		*/
+		struct LimboState {
+			uint64_t timeStart;
+		};
+
+		class Node_LeftRightLimbo : public StatefulGestureNode<LimboState> {
 			private:
 				Engine *e;
-				uint64_t mTimeStart;
 				uint64_t mTimelimit;
 				double   mThreshold;
 
@@ -346,7 +329,6 @@ class Engine : public Leap::Listener {
 						uint64_t timer = 100000,
 						double threshold = 50.0) {
 					e = creator;
-					mTimeStart = 0;
 					mThreshold = abs(threshold);
 					mTimelimit = timer;
 				}
@@ -366,10 +348,10 @@ class Engine : public Leap::Listener {
 					1 if negligible movemtn [ -threshold < vx < threshold ]
 					0 if the timer runs out, or no hand is present
 				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
+				virtual int evaluate(const HandFrame& frame,
+						const std::string& nodeid, LimboState& state) {
 					if (e->mMainHand.isValid()
-							&& frame.timestamp() - mTimeStart < mTimelimit) {
+							&& frame.timestamp - state.timeStart < mTimelimit) {
 						if (e->mHandVelocity.x >= mThreshold)
 							return 3;
 						else if (e->mHandVelocity.x <= -mThreshold)
@@ -380,16 +362,15 @@ class Engine : public Leap::Listener {
 						return 0;
 				}
 
-				virtual void onEnter(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					mTimeStart = frame.timestamp();
+				virtual void onEnter(const HandFrame& frame,
+						const std::string& nodeid, LimboState& state) {
+					state.timeStart = frame.timestamp;
 				}
 		};
 
-		class Node_UpDownLimbo : public GestureNode {
+		class Node_UpDownLimbo : public StatefulGestureNode<LimboState> {
 			private:
 				Engine *e;
-				uint64_t mTimeStart;
 				uint64_t mTimelimit;
 				double   mThreshold;
 
@@ -403,7 +384,6 @@ class Engine : public Leap::Listener {
 						uint64_t timer = 100000,
 						double threshold = 50.0) {
 					e = creator;
-					mTimeStart = 0;
 					mThreshold = abs(threshold);
 					mTimelimit = timer;
 				}
@@ -423,10 +403,10 @@ class Engine : public Leap::Listener {
 					1 if negligible movemnt [ -threshold < vy < threshold ]
 					0 if the timer runs out, or no hand is present
 				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
+				virtual int evaluate(const HandFrame& frame,
+						const std::string& nodeid, LimboState& state) {
 					if (e->mMainHand.isValid()
-							&& frame.timestamp() - mTimeStart < mTimelimit) {
+							&& frame.timestamp - state.timeStart < mTimelimit) {
 						if (e->mHandVelocity.y >= mThreshold)
 							return 3;
 						else if (e->mHandVelocity.y <= -mThreshold)
@@ -437,9 +417,9 @@ class Engine : public Leap::Listener {
 						return 0;
 				}
 
-				virtual void onEnter(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					mTimeStart = frame.timestamp();
+				virtual void onEnter(const HandFrame& frame,
+						const std::string& nodeid, LimboState& state) {
+					state.timeStart = frame.timestamp;
 				}
 		};
 
@@ -449,25 +429,35 @@ class Engine : public Leap::Listener {
 			bool success = true;
 
 			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_Motion(this, 30.0)));
+						new Node_Motion(this, 30.0)))
+					!= GestureStateGraph::INVALID_TYPE;
 			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_CoarseDirection(this)));
+						new Node_CoarseDirection(this)))
+					!= GestureStateGraph::INVALID_TYPE;
 			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_LeftRight(this, 200.0)));
+						new Node_LeftRight(this, 200.0)))
+					!= GestureStateGraph::INVALID_TYPE;
 			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_LeftRight(this, 0.0)));
+						new Node_LeftRight(this, 0.0)))
+					!= GestureStateGraph::INVALID_TYPE;
 			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_UpDown(this, 200.0)));
+						new Node_UpDown(this, 200.0)))
+					!= GestureStateGraph::INVALID_TYPE;
 			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_UpDown(this, 0.0)));
+						new Node_UpDown(this, 0.0)))
+					!= GestureStateGraph::INVALID_TYPE;
 			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_ForeBack(this, 5.0)));
+						new Node_ForeBack(this, 5.0)))
+					!= GestureStateGraph::INVALID_TYPE;
 			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_ForeBack(this, 10.0)));
+						new Node_ForeBack(this, 10.0)))
+					!= GestureStateGraph::INVALID_TYPE;
 			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_LeftRightLimbo(this, 100000, 100.0)));
+						new Node_LeftRightLimbo(this, 100000, 100.0)))
+					!= GestureStateGraph::INVALID_TYPE;
 			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-						new Node_UpDownLimbo(this, 100000, 100.0)));
+						new Node_UpDownLimbo(this, 100000, 100.0)))
+					!= GestureStateGraph::INVALID_TYPE;
 
 			if (!success)
 				throw EngineException("Node type creation failed");
@@ -580,6 +570,24 @@ class Engine : public Leap::Listener {
 			// PULL
 			mGraph.addConnection("pull", 1, "pull");
 			mGraph.addConnection("pull", 2, "pull");
+
+			/* Actions */
+
+			mGraph.setEnterAction("swL",
+					boost::bind(&Engine::onSwipeLeft, this));
+			mGraph.setEnterAction("swR",
+					boost::bind(&Engine::onSwipeRight, this));
+			mGraph.setEnterAction("swU",
+					boost::bind(&Engine::onSwipeUp, this));
+			mGraph.setEnterAction("swD",
+					boost::bind(&Engine::onSwipeDown, this));
+
+			// Validate the graph before any frames arrive
+			mGraph.compile();
+
+			// Keep the most recent transitions; written out on exit
+			mGraph.setTrace(boost::shared_ptr<GestureTrace>(
+					new GestureTrace(4096)));
 		}
 
 		~Engine()
@@ -591,27 +599,18 @@ class Engine : public Leap::Listener {
 
 		virtual void onFrame(const Leap::Controller &c) {
 			Leap::Frame frame = c.frame(0);
+			toHandFrame(frame, mFrame);
 
 			bool swiping = false;
 			if (frame.hands().count() == 1) {
-				// Average of fingers + palm
 				mMainHand = (*frame.hands().begin());
 				if (mMainHand.fingers().count() >= 3) {
 					swiping = true;
-					Leap::FingerList fingers = mMainHand.fingers();
-					mCurrentVelocity = Leap::Vector(0.0f, 0.0f, 0.0f);
-					if (fingers.count() > 0) {
-						for (Leap::FingerList::const_iterator it
-								= fingers.begin();
-								it != fingers.end(); ++it) {
-							mCurrentVelocity += (*it).tipVelocity();
-						}
-						mCurrentVelocity /= (float)fingers.count();
-					}
-					mCurrentVelocity += mMainHand.palmVelocity();
-					if (fingers.count() > 0)
-						mCurrentVelocity /= 2.0;
-					updateHandVelocity();
+					const Vector3& velocity = mVelocityFilter.update(
+							HandMotion::getRawVelocity(mFrame.hands[0]),
+							mFrame.timestamp);
+					mHandVelocity = Leap::Vector(velocity.x, velocity.y,
+							velocity.z);
 
 					Leap::Vector xyvel = mHandVelocity;
 					xyvel.z = 0.0f;
@@ -625,19 +624,18 @@ class Engine : public Leap::Listener {
 			}
 			
 			if (!swiping) {
-				initializeHandVelocity();
+				mVelocityFilter.reset();
 				mMainHand = Leap::Hand::invalid();
 				mHandVelocity = Leap::Vector::zero();
 				mXYHandSpeed = 0.0f;
 			}
 
-			mGraph.updateWithPrint(frame);
+			mGraph.update(mFrame);
 		}
 
 		void run() {
 			mRunning = true;
 			
-			initializeHandVelocity();
 			initializeGraphics();
 			initializeApplication();
 
@@ -649,6 +647,9 @@ class Engine : public Leap::Listener {
 	private:
 		GestureStateGraph mGraph;
 
+		// Graph input, converted from the latest Leap frame
+		HandFrame mFrame;
+
 		Leap::Hand   mMainHand;
 		Leap::Vector mHandVelocity;
 		double       mXYHandSpeed;
@@ -665,10 +666,8 @@ class Engine : public Leap::Listener {
 
 		std::vector<double> mListPosition;
 
-		Leap::Vector mCurrentVelocity;
-		int mNumSmoothing, mAverageVelocityCurrentIndex;
-		std::vector<Leap::Vector> mAverageVelocityBuffer;
-		Leap::Vector mAverageVelocity;
+		// Smooths the main hand's velocity over the last 3 frames
+		VelocityFilter mVelocityFilter;
 
 		SDL_Window    *mWindow;
 		SDL_GLContext mGLContext;
@@ -677,6 +676,34 @@ class Engine : public Leap::Listener {
 
 		bool mRunning;
 
+		void onSwipeLeft() {
+			mSelection++;
+			if (mSelection >= mNumSelections) {
+				mListPosition[mCurrentStack]
+					-= mNumSelections;
+				mSelection = 0;
+			}
+		}
+
+		void onSwipeRight() {
+			mSelection--;
+			if (mSelection < 0) {
+				mListPosition[mCurrentStack]
+					+= mNumSelections;
+				mSelection = mNumSelections - 1;
+			}
+		}
+
+		void onSwipeUp() {
+			if (mCurrentStack < mNumStacks - 1)
+				mCurrentStack++;
+		}
+
+		void onSwipeDown() {
+			if (mCurrentStack > 0)
+				mCurrentStack--;
+		}
+
 		void initializeGraphics() {
 			if (SDL_Init(SDL_INIT_VIDEO) != 0)
 				throw EngineException("SDL_Init failed");
@@ -723,16 +750,6 @@ class Engine : public Leap::Listener {
 			glPushMatrix();
 		}
 
-		void initializeHandVelocity() {
-			mNumSmoothing = 3;
-			mAverageVelocityCurrentIndex = 0;
-			mAverageVelocityBuffer.clear();
-			for (int i = 0; i < mNumSmoothing; ++i) {
-				mAverageVelocityBuffer.push_back(
-						Leap::Vector(0.0f, 0.0f, 0.0f));
-			}
-		}
-
 		void initializeApplication() {
 			mCurrentStack = 0;
 			mNumStacks = 5;
@@ -753,25 +770,9 @@ class Engine : public Leap::Listener {
 			SDL_GL_DeleteContext(mGLContext);
 			SDL_DestroyWindow(mWindow);
 			SDL_Quit();
-		}
 
-		void updateHandVelocity() {
-			mAverageVelocityBuffer.at(mAverageVelocityCurrentIndex)
-				= mCurrentVelocity;
-			++mAverageVelocityCurrentIndex;
-			if (mAverageVelocityCurrentIndex >= mNumSmoothing)
-				mAverageVelocityCurrentIndex = 0;
-
-			std::vector<Leap::Vector>::iterator it
-				= mAverageVelocityBuffer.begin();
-			mAverageVelocity = (*it);
-			++it;
-			while (it != mAverageVelocityBuffer.end()) {
-				mAverageVelocity += (*it);
-				++it;
-			}
-			mAverageVelocity /= (float)mNumSmoothing;
-			mHandVelocity = mAverageVelocity;
+			std::ofstream trace("homescreen_stacks.trace", std::ios::binary);
+			mGraph.writeTrace(trace);
 		}
 
 		void runLoop() {
@@ -0,0 +1,223 @@
+/*
+	Philip Romano
+	10/16/2026
+	ingest.cpp
+
+	Test for FrameIngest
+	Checks what each policy hands the graph when it falls behind: the
+	bounded queue drops the oldest frames, LATEST only the newest frame,
+	and COALESCE the newest frame with velocities averaged by hand and
+	finger ID. Then pushes frames from one thread faster than a slow
+	consumer takes them, and checks that every frame is accounted for in
+	the counts.
+*/
+
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <stdint.h>
+
+#include "frameingest.h"
+#include "handframe.h"
+
+namespace {
+	const int CAPACITY = 4;
+	const int FRAMES = 20000;
+}
+
+/**
+  Frame i has hand 7, with palm and finger 3 moving at i in x, and from
+  frame 2 on, hand 9 moving at 10 * i.
+*/
+static void makeFrame(int64_t i, HandFrame& frame) {
+	frame.clear();
+	frame.id = i;
+	frame.timestamp = i * 10000;
+	frame.handCount = (i >= 2) ? 2 : 1;
+	for (int h = 0; h < frame.handCount; ++h) {
+		HandData& hand = frame.hands[h];
+		hand.id = h ? 9 : 7;
+		hand.palmPosition.x = hand.palmPosition.y = hand.palmPosition.z =
+			(float)i;
+		hand.palmVelocity.x = (float)(h ? 10 * i : i);
+		hand.palmVelocity.y = hand.palmVelocity.z = 0.0f;
+		hand.palmNormal = hand.palmVelocity;
+
+		hand.fingerCount = 1;
+		hand.fingers[0].id = 3;
+		hand.fingers[0].tipPosition = hand.palmPosition;
+		hand.fingers[0].tipVelocity = hand.palmVelocity;
+	}
+}
+
+static bool isAccounted(const FrameIngest& ingest) {
+	IngestStats stats = ingest.getStats();
+	return stats.received == stats.delivered + stats.coalesced
+		+ stats.dropped + ingest.getPending();
+}
+
+static bool queue() {
+	FrameIngest ingest(FrameIngest::QUEUE, CAPACITY);
+	HandFrame frame;
+	for (int i = 0; i < 10; ++i) {
+		makeFrame(i, frame);
+		ingest.push(frame);
+	}
+
+	// The newest CAPACITY frames, in order
+	bool success = true;
+	for (int i = 10 - CAPACITY; i < 10; ++i)
+		success &= ingest.pop(frame) && frame.id == i;
+	success &= !ingest.pop(frame);
+
+	IngestStats stats = ingest.getStats();
+	success &= stats.received == 10 && stats.delivered == CAPACITY
+		&& stats.dropped == 10 - CAPACITY && stats.coalesced == 0
+		&& stats.maxPending == CAPACITY && isAccounted(ingest);
+	return success;
+}
+
+static bool latest() {
+	FrameIngest ingest(FrameIngest::LATEST, CAPACITY);
+	HandFrame frame;
+	for (int i = 0; i < 3; ++i) {
+		makeFrame(i, frame);
+		ingest.push(frame);
+	}
+
+	bool success = ingest.pop(frame) && frame.id == 2 && !ingest.pop(frame);
+	makeFrame(3, frame);
+	ingest.push(frame);
+	success &= ingest.pop(frame) && frame.id == 3;
+
+	IngestStats stats = ingest.getStats();
+	success &= stats.delivered == 2 && stats.dropped == 2
+		&& isAccounted(ingest);
+	return success;
+}
+
+static bool coalesce() {
+	FrameIngest ingest(FrameIngest::COALESCE, CAPACITY);
+	HandFrame frame;
+	for (int i = 0; i < 4; ++i) {
+		makeFrame(i, frame);
+		ingest.push(frame);
+	}
+
+	bool success = ingest.pop(frame) && !ingest.pop(frame);
+
+	// The newest frame's positions, with velocities averaged over 0 to 3
+	// for hand 7, and over 2 and 3 for hand 9
+	const HandData *seven = frame.findHand(7);
+	const HandData *nine = frame.findHand(9);
+	success &= frame.id == 3 && frame.timestamp == 30000 && seven && nine
+		&& seven->palmPosition.x == 3.0f && nine->palmPosition.x == 3.0f
+		&& std::fabs(seven->palmVelocity.x - 1.5f) < 1e-5f
+		&& std::fabs(seven->fingers[0].tipVelocity.x - 1.5f) < 1e-5f
+		&& std::fabs(nine->palmVelocity.x - 25.0f) < 1e-5f
+		&& std::fabs(nine->fingers[0].tipVelocity.x - 25.0f) < 1e-5f;
+
+	IngestStats stats = ingest.getStats();
+	success &= stats.delivered == 1 && stats.coalesced == 3
+		&& stats.dropped == 0 && isAccounted(ingest);
+	return success;
+}
+
+/**
+  Push FRAMES frames from another thread while popping them slowly, and
+  check that they arrive in order and are all counted.
+*/
+static bool behind(FrameIngest::Policy policy) {
+	FrameIngest ingest(policy, CAPACITY);
+
+	std::thread source([&ingest]() {
+		HandFrame frame;
+		for (int i = 0; i < FRAMES; ++i) {
+			makeFrame(i, frame);
+			ingest.push(frame);
+			if (i % 100 == 0)
+				std::this_thread::yield();
+		}
+		ingest.close();
+	});
+
+	bool ordered = true;
+	int64_t last = -1;
+	HandFrame frame;
+	while (ingest.wait()) {
+		while (ingest.pop(frame)) {
+			ordered &= frame.id > last;
+			last = frame.id;
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+		}
+	}
+	source.join();
+
+	IngestStats stats = ingest.getStats();
+	bool success = ordered && last == FRAMES - 1 && isAccounted(ingest)
+		&& ingest.getPending() == 0 && stats.received == FRAMES
+		&& stats.maxPending <= CAPACITY && stats.delivered > 0;
+	if (policy == FrameIngest::COALESCE)
+		success &= stats.dropped + stats.coalesced > 0;
+
+	std::cout << FrameIngest::getPolicyName(policy) << ": "
+		<< stats.delivered << " delivered, " << stats.coalesced
+		<< " coalesced, " << stats.dropped << " dropped, longest wait "
+		<< stats.maxDelay / 1000 << " us" << std::endl;
+	return success;
+}
+
+static bool waiting() {
+	FrameIngest ingest;
+
+	std::chrono::steady_clock::time_point start =
+		std::chrono::steady_clock::now();
+	bool success = !ingest.wait(50);
+	int64_t waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - start).count();
+	success &= waited >= 40;
+
+	// Frames pending at close() can still be popped; later ones are ignored
+	HandFrame frame;
+	makeFrame(0, frame);
+	ingest.push(frame);
+	ingest.close();
+	ingest.push(frame);
+	success &= ingest.wait() && ingest.pop(frame) && !ingest.wait()
+		&& ingest.isClosed() && ingest.getStats().received == 1;
+
+	FrameIngest::Policy policy;
+	success &= FrameIngest::parsePolicy("coalesce", policy)
+		&& policy == FrameIngest::COALESCE
+		&& !FrameIngest::parsePolicy("newest", policy);
+	return success;
+}
+
+int main(int argc, char **argv) {
+	bool success = true;
+
+	bool result = queue();
+	std::cout << "Bounded queue: " << (result ? "ok" : "FAILED") << std::endl;
+	success &= result;
+
+	result = latest();
+	std::cout << "Latest only: " << (result ? "ok" : "FAILED") << std::endl;
+	success &= result;
+
+	result = coalesce();
+	std::cout << "Coalesce: " << (result ? "ok" : "FAILED") << std::endl;
+	success &= result;
+
+	result = behind(FrameIngest::QUEUE) && behind(FrameIngest::LATEST)
+		&& behind(FrameIngest::COALESCE);
+	std::cout << "Slow consumer: " << (result ? "ok" : "FAILED") << std::endl;
+	success &= result;
+
+	result = waiting();
+	std::cout << "Waiting: " << (result ? "ok" : "FAILED") << std::endl;
+	success &= result;
+
+	std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+	return success ? 0 : 1;
+}
@@ -0,0 +1,220 @@
+/*
+	Philip Romano
+	10/16/2026
+	latency.cpp
+
+	Test for GestureLatency
+	Stamps events at known times and checks every stage, the estimate of
+	the capture time and the percentiles. Then plays scripted gestures
+	through the graph of train.cpp with a recorder set, and checks that
+	exactly the nodes with enter actions open events, tagged with the
+	frames that entered them.
+*/
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include <boost/bind/bind.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "gesturelatency.h"
+#include "gesturestategraph.h"
+#include "compiledgesturegraph.h"
+#include "handsynthesizer.h"
+#include "handframe.h"
+
+#include "traingraph.h"
+
+namespace {
+	const int64_t MS = 1000000;
+}
+
+static void makeFrame(int64_t i, HandFrame& frame) {
+	frame.clear();
+	frame.id = i;
+	frame.timestamp = i * 10000;
+}
+
+static bool percentiles() {
+	std::vector<int64_t> values;
+	bool success = GestureLatency::getPercentile(values, 50.0) == -1;
+
+	for (int v = 100; v >= 1; --v)
+		values.push_back(v);
+	success &= GestureLatency::getPercentile(values, 50.0) == 50
+		&& GestureLatency::getPercentile(values, 90.0) == 90
+		&& GestureLatency::getPercentile(values, 99.0) == 99
+		&& GestureLatency::getPercentile(values, 100.0) == 100
+		&& GestureLatency::getPercentile(values, 0.0) == 1;
+	return success;
+}
+
+static bool stages() {
+	GestureLatency latency;
+	HandFrame frame;
+
+	// Frames 10 ms apart, arriving 5 ms after capture, frame 2 late by 3 ms
+	for (int i = 0; i < 4; ++i) {
+		makeFrame(i, frame);
+		latency.arrive(frame, frame.timestamp * 1000 + 5 * MS
+				+ (i == 2 ? 3 * MS : 0));
+	}
+
+	// Frame 2 is committed 1 ms after it arrived; the commit from a frame
+	// between arrivals is enqueued with the arrival after it
+	makeFrame(2, frame);
+	latency.commit(7, frame, 1, 29 * MS);
+	frame.timestamp = 25000;
+	latency.commit(8, frame, 0, 40 * MS);
+	bool success = latency.getCount() == 0;
+
+	latency.consume(45 * MS);
+	latency.present(50 * MS);
+
+	// Committed after the consume, so still open
+	makeFrame(3, frame);
+	latency.commit(9, frame, 0, 46 * MS);
+	latency.present(52 * MS);
+	success &= latency.getCount() == 2;
+
+	LatencyEvent first = latency.getEvent(0);
+	success &= first.node == 7 && first.session == 1 && first.frameId == 2
+		&& first.frameTime == 20000
+		&& first.times[GestureLatency::CAPTURE] == 25 * MS
+		&& first.times[GestureLatency::ENQUEUE] == 28 * MS
+		&& first.times[GestureLatency::COMMIT] == 29 * MS
+		&& first.times[GestureLatency::CONSUME] == 45 * MS
+		&& first.times[GestureLatency::PRESENT] == 50 * MS
+		&& GestureLatency::getLatency(first, GestureLatency::CAPTURE,
+			GestureLatency::PRESENT) == 25 * MS;
+
+	LatencyEvent second = latency.getEvent(1);
+	success &= second.node == 8
+		&& second.times[GestureLatency::CAPTURE] == 30 * MS
+		&& second.times[GestureLatency::ENQUEUE] == 35 * MS;
+
+	latency.consume(60 * MS);
+	latency.present(61 * MS);
+	success &= latency.getCount() == 3 && latency.getEvent(2).node == 9;
+
+	// Nothing presented: the oldest open events are let go
+	latency.reset();
+	for (int i = 0; i < 70; ++i)
+		latency.commit(i, frame, 0, i);
+	latency.consume(100);
+	latency.present(100);
+	success &= latency.getCount() == 64 && latency.getAbandoned() == 6
+		&& latency.getEvent(0).node == 6
+		&& latency.getEvent(0).times[GestureLatency::CAPTURE] == -1;
+
+	// All of them at once, in the same order
+	std::vector<LatencyEvent> events = latency.getEvents();
+	success &= events.size() == 64 && events[0].node == 6
+		&& events[63].node == latency.getEvent(63).node;
+
+	if (!success)
+		std::cout << "Events were not stamped as expected" << std::endl;
+	return success;
+}
+
+/**
+  Counts entries to the nodes of the train graph that have enter actions.
+*/
+struct Entered {
+	std::vector<int64_t> frames;
+
+	void enter(const HandFrame& frame) {
+		frames.push_back(frame.id);
+	}
+};
+
+static bool graph() {
+	static const char *nodes[] = { "swL", "swR", "swU", "swD", "push", "pull" };
+
+	TrainGraph gestures;
+	GestureStateGraph& graph = gestures.getGraph();
+	Entered entered;
+	for (int i = 0; i < 6; ++i) {
+		graph.setEnterAction(nodes[i], boost::bind(&Entered::enter,
+					&entered, boost::placeholders::_1));
+	}
+	boost::shared_ptr<const CompiledGestureGraph> compiled = graph.compile();
+
+	boost::shared_ptr<GestureLatency> latency(new GestureLatency());
+	graph.setLatency(latency);
+
+	HandSynthesizer synth(100.0);
+	synth.addStep(HandSynthesizer::IDLE, 500000);
+	for (int m = HandSynthesizer::SWIPE_LEFT; m <= HandSynthesizer::PULL;
+			++m) {
+		synth.addStep((HandSynthesizer::Motion)m, 400000);
+		synth.addStep(HandSynthesizer::IDLE, 500000);
+	}
+
+	// Presented every fourth frame, as a slower render loop would
+	HandFrame frame;
+	int count = 0;
+	while (synth.next(frame)) {
+		latency->arrive(frame);
+		gestures.update(frame);
+		if (++count % 4 == 0) {
+			latency->consume();
+			latency->present();
+		}
+	}
+	latency->consume();
+	latency->present();
+
+	bool success = !entered.frames.empty()
+		&& latency->getCount() == (int)entered.frames.size();
+	for (int e = 0; success && e < latency->getCount(); ++e) {
+		LatencyEvent event = latency->getEvent(e);
+		const std::string& id = compiled->getNodeId(event.node);
+		bool named = false;
+		for (int i = 0; i < 6; ++i)
+			named |= (id == nodes[i]);
+
+		success = named && event.frameId == entered.frames[e];
+		for (int s = GestureLatency::CAPTURE; s < GestureLatency::PRESENT;
+				++s)
+			success &= event.times[s] >= 0
+				&& event.times[s] <= event.times[s + 1];
+	}
+
+	std::ostringstream csv;
+	latency->writeCsv(csv, *compiled);
+	int rows = 0;
+	std::istringstream lines(csv.str());
+	for (std::string line; std::getline(lines, line); )
+		++rows;
+	success &= rows == latency->getCount() + 1;
+
+	if (success)
+		latency->report(std::cout);
+	else
+		std::cout << entered.frames.size() << " entries, "
+			<< latency->getCount() << " events" << std::endl;
+	return success;
+}
+
+int main(int argc, char **argv) {
+	bool success = true;
+
+	bool result = percentiles();
+	std::cout << "Percentiles: " << (result ? "ok" : "FAILED") << std::endl;
+	success &= result;
+
+	result = stages();
+	std::cout << "Stages: " << (result ? "ok" : "FAILED") << std::endl;
+	success &= result;
+
+	result = graph();
+	std::cout << "Graph events: " << (result ? "ok" : "FAILED") << std::endl;
+	success &= result;
+
+	std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+	return success ? 0 : 1;
+}
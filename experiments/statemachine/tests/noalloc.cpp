@@ -0,0 +1,287 @@
+/*
+	Philip Romano
+	10/16/2026
+	noalloc.cpp
+
+	Test for GestureStateGraph
+	Checks that update() does not touch the heap in steady state. Every
+	global allocation is counted; after a warm-up pass over the recorded
+	motion, a second pass over the same motion must not allocate at all.
+	Tracing, profiling, memoization, per-node state and bound actions are
+	all used, so that their update paths are covered too. Then checks that
+	removing and adding nodes reuses their state blocks, instead of growing
+	the state arena.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <math.h>
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/bind/bind.hpp>
+
+#include "handframe.h"
+#include "gesturestategraph.h"
+#include "gesturenode.h"
+#include "gesturetrace.h"
+#include "gestureprofile.h"
+#include "gesturesession.h"
+#include "compiledgesturegraph.h"
+
+#include "allocationcount.h"
+
+/*
+   Recorded motion
+*/
+
+static float velocity(const HandFrame& frame) {
+	if (frame.handCount > 0)
+		return frame.hands[0].palmVelocity.x;
+	else
+		return 0.0f;
+}
+
+static void recordTrack(std::vector<HandFrame>& track, int frames) {
+	// One hand making alternating left and right swipes, with rests in
+	// between, at 100 frames per second
+	track.resize(frames);
+	for (int i = 0; i < frames; ++i) {
+		HandFrame& frame = track[i];
+		frame.clear();
+		frame.id = i;
+		frame.timestamp = (int64_t)i * 10000;
+		frame.handCount = 1;
+
+		HandData& hand = frame.hands[0];
+		hand.id = 1;
+		hand.palmPosition.x = hand.palmPosition.y = hand.palmPosition.z = 0;
+		hand.palmNormal.x = hand.palmNormal.z = 0;
+		hand.palmNormal.y = -1;
+		hand.fingerCount = 0;
+
+		float x = 0.0f;
+		int phase = i % 120;
+		if (phase >= 40)
+			x = 800.0f * (float)sin((phase - 40) * 3.14159 / 80.0);
+		if ((i / 120) % 2)
+			x = -x;
+		hand.palmVelocity.x = x;
+		hand.palmVelocity.y = hand.palmVelocity.z = 0;
+	}
+}
+
+/*
+   Nodes
+*/
+
+struct RestState {
+	int framesStill;
+};
+
+class Node_Rest : public StatefulGestureNode<RestState> {
+	public:
+		virtual const std::string& getName() {
+			static std::string name("Rest");
+			return name;
+		}
+
+		/**
+		  StateNode
+
+		  Returns
+		  1 once the hand has been still for 10 frames and moves again
+		  0 otherwise [stay in state]
+		*/
+		virtual int evaluate(const HandFrame& frame,
+				const std::string& nodeid, RestState& state) {
+			if (fabs(velocity(frame)) < 100.0f) {
+				++state.framesStill;
+				return 0;
+			} else
+				return (state.framesStill >= 10) ? 1 : 0;
+		}
+
+		virtual void onEnter(const HandFrame& frame,
+				const std::string& nodeid, RestState& state) {
+			state.framesStill = 0;
+		}
+};
+
+class Node_Direction : public GestureNode {
+	public:
+		virtual const std::string& getName() {
+			static std::string name("Direction");
+			return name;
+		}
+
+		virtual bool isPure() {
+			return true;
+		}
+
+		/**
+		  DecisionNode
+
+		  Returns
+		  1 if moving right
+		  2 if moving left
+		*/
+		virtual int evaluate(const HandFrame& frame,
+				const std::string& nodeid, void *state) {
+			return (velocity(frame) > 0.0f) ? 1 : 2;
+		}
+};
+
+class Node_Swipe : public GestureNode {
+	public:
+		virtual const std::string& getName() {
+			static std::string name("Swipe");
+			return name;
+		}
+
+		/**
+		  StateNode
+
+		  Returns
+		  0 while the hand keeps moving [stay in state]
+		  1 otherwise                   [unconnected: back to start]
+		*/
+		virtual int evaluate(const HandFrame& frame,
+				const std::string& nodeid, void *state) {
+			return (fabs(velocity(frame)) >= 100.0f) ? 0 : 1;
+		}
+};
+
+class Counter {
+	public:
+		Counter()
+				: mLeft(0), mRight(0)
+			{ }
+
+		void onLeft() {
+			++mLeft;
+		}
+
+		void onRight() {
+			++mRight;
+		}
+
+		int mLeft, mRight;
+};
+
+static void buildGraph(GestureStateGraph& graph, Counter& counter) {
+	graph.createNodeType(boost::shared_ptr<GestureNode>(new Node_Rest()));
+	graph.createNodeType(boost::shared_ptr<GestureNode>(
+			new Node_Direction()));
+	graph.createNodeType(boost::shared_ptr<GestureNode>(new Node_Swipe()));
+
+	graph.addNode("Rest", "rest");
+	graph.addNode("Direction", "direction");
+	graph.addNode("Swipe", "swipeRight");
+	graph.addNode("Swipe", "swipeLeft");
+
+	graph.addConnection("rest", 0, "rest");
+	graph.addConnection("rest", 1, "direction");
+	graph.addConnection("direction", 1, "swipeRight");
+	graph.addConnection("direction", 2, "swipeLeft");
+	graph.addConnection("swipeRight", 0, "swipeRight");
+	graph.addConnection("swipeLeft", 0, "swipeLeft");
+
+	graph.setEnterAction("swipeRight",
+			boost::bind(&Counter::onRight, &counter));
+	graph.setEnterAction("swipeLeft",
+			boost::bind(&Counter::onLeft, &counter));
+}
+
+/**
+  Feed the whole track to update() and return the number of allocations
+  made while doing so.
+*/
+static long replay(GestureStateGraph& graph,
+		const std::vector<HandFrame>& track) {
+	long before = gAllocations;
+	for (int i = 0; i < (int)track.size(); ++i)
+		graph.update(track[i]);
+	return gAllocations - before;
+}
+
+static long replay(GestureSessionSet& sessions,
+		const std::vector<HandFrame>& track) {
+	long before = gAllocations;
+	for (int i = 0; i < (int)track.size(); ++i)
+		sessions.update(track[i]);
+	return gAllocations - before;
+}
+
+/**
+  Remove and add nodes many times over, and return true if the state
+  arena never held more than two Rest nodes' blocks.
+*/
+static bool reuseStates() {
+	GestureStateGraph graph;
+	Counter counter;
+	buildGraph(graph, counter);
+	for (int i = 0; i < 100; ++i) {
+		// A stateless node on a stateful node's handle, then stateful
+		// again; and a second stateful node, added and removed
+		graph.removeNode("rest");
+		graph.addNode("Swipe", "rest");
+		graph.removeNode("rest");
+		graph.addNode("Rest", "rest");
+		graph.addNode("Rest", "extra");
+		graph.removeNode("extra");
+	}
+	int size = graph.compile()->getStateSize();
+	std::cout << "State arena after 100 removals: " << size << " bytes"
+		<< std::endl;
+	return size <= 2 * CompiledGestureGraph::alignState(sizeof(RestState));
+}
+
+int main(int argc, char **argv) {
+	bool success = true;
+
+	std::vector<HandFrame> track;
+	recordTrack(track, 2400);
+
+	GestureStateGraph graph;
+	Counter counter;
+	buildGraph(graph, counter);
+	graph.compile();
+	graph.setTrace(boost::shared_ptr<GestureTrace>(new GestureTrace(1024)));
+	graph.setProfile(boost::shared_ptr<GestureProfile>(
+			new GestureProfile()));
+
+	// The first pass may allocate (profile counters grow as nodes and
+	// slots are first seen); the second must not
+	long warmup = replay(graph, track);
+	long steady = replay(graph, track);
+	std::cout << "GestureStateGraph::update(): " << warmup
+		<< " allocations warming up, " << steady << " in steady state"
+		<< std::endl;
+	success &= (steady == 0);
+
+	GestureSessionSet sessions(graph.compile());
+	sessions.setTrace(graph.getTrace());
+	sessions.setProfile(graph.getProfile());
+	for (int i = 0; i < 8; ++i)
+		sessions.createSession();
+
+	warmup = replay(sessions, track);
+	steady = replay(sessions, track);
+	std::cout << "GestureSessionSet::update(): " << warmup
+		<< " allocations warming up, " << steady << " in steady state"
+		<< std::endl;
+	success &= (steady == 0);
+
+	// Make sure the graph actually moved
+	std::cout << counter.mRight << " right swipes, " << counter.mLeft
+		<< " left swipes" << std::endl;
+	success &= (counter.mRight > 0 && counter.mLeft > 0);
+
+	success &= reuseStates();
+
+	std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+	return success ? 0 : 1;
+}
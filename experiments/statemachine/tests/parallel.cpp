@@ -0,0 +1,184 @@
+/*
+	Philip Romano
+	10/16/2026
+	parallel.cpp
+
+	Test for WorkPool
+	Checks that every task runs exactly once (including tasks submitted by
+	tasks), that exceptions reach wait(), and that demo graphs replayed on
+	several threads at once take exactly the transitions they take one at
+	a time.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+#include <stdint.h>
+
+#include <boost/bind/bind.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "workpool.h"
+#include "handsynthesizer.h"
+#include "handframe.h"
+#include "gesturestategraph.h"
+#include "gesturetrace.h"
+
+#include "traingraph.h"
+
+namespace {
+	const int TASKS = 2000;
+	const int SCRIPTS = 16;
+}
+
+static void count(std::vector<std::atomic<int> > *counts, int i) {
+	// Uneven work, so that some workers run dry and steal
+	volatile int spin = 0;
+	for (int j = 0; j < (i % 7) * 1000; ++j)
+		spin = spin + 1;
+	++(*counts)[i];
+}
+
+static void fork(WorkPool *pool, std::vector<std::atomic<int> > *counts,
+		int first, int last) {
+	if (last - first <= 16) {
+		for (int i = first; i < last; ++i)
+			count(counts, i);
+		return;
+	}
+	int middle = (first + last) / 2;
+	pool->submit(boost::bind(&fork, pool, counts, first, middle));
+	pool->submit(boost::bind(&fork, pool, counts, middle, last));
+}
+
+static void fail() {
+	throw std::runtime_error("task failed");
+}
+
+static bool once() {
+	WorkPool pool(4);
+	std::vector<std::atomic<int> > counts(TASKS);
+	for (int i = 0; i < TASKS; ++i)
+		counts[i].store(0);
+
+	for (int i = 0; i < TASKS; ++i)
+		pool.submit(boost::bind(&count, &counts, i));
+	pool.wait();
+
+	// Again, with the tasks split up by tasks
+	pool.submit(boost::bind(&fork, &pool, &counts, 0, TASKS));
+	pool.wait();
+
+	bool success = true;
+	for (int i = 0; i < TASKS; ++i) {
+		if (counts[i].load() != 2) {
+			std::cout << "Task " << i << " ran " << counts[i].load()
+				<< " times" << std::endl;
+			success = false;
+		}
+	}
+	return success;
+}
+
+static bool exceptions() {
+	WorkPool pool(3);
+	std::vector<std::atomic<int> > counts(100);
+	for (int i = 0; i < 100; ++i) {
+		counts[i].store(0);
+		pool.submit(boost::bind(&count, &counts, i));
+	}
+	pool.submit(&fail);
+
+	bool thrown = false;
+	try {
+		pool.wait();
+	} catch (std::runtime_error&) {
+		thrown = true;
+	}
+
+	// The other tasks still ran, and the error is only reported once
+	bool ran = true;
+	for (int i = 0; i < 100; ++i)
+		ran &= (counts[i].load() == 1);
+	pool.wait();
+
+	if (!thrown)
+		std::cout << "wait() did not rethrow" << std::endl;
+	if (!ran)
+		std::cout << "Tasks were lost after an exception" << std::endl;
+	return thrown && ran;
+}
+
+static void replayScript(int script, std::vector<TraceRecord> *transitions) {
+	HandSynthesizer synth(100.0, script + 1);
+	synth.setNoise(20.0f);
+	synth.addRandomSteps(50);
+
+	TrainGraph gestures;
+	GestureStateGraph& graph = gestures.getGraph();
+	graph.compile();
+	boost::shared_ptr<GestureTrace> trace(new GestureTrace(1 << 16));
+	graph.setTrace(trace);
+
+	HandFrame frame;
+	while (synth.next(frame))
+		gestures.update(frame);
+	trace->snapshot(*transitions);
+}
+
+static bool graphs() {
+	std::vector<std::vector<TraceRecord> > serial(SCRIPTS), parallel(SCRIPTS);
+
+	// The train graph reports unexpected swipes on std::cout; keep them out
+	// of the test's output
+	std::cout.setstate(std::ios::failbit);
+	for (int s = 0; s < SCRIPTS; ++s)
+		replayScript(s, &serial[s]);
+
+	WorkPool pool(4);
+	for (int s = 0; s < SCRIPTS; ++s)
+		pool.submit(boost::bind(&replayScript, s, &parallel[s]));
+	pool.wait();
+	std::cout.clear();
+
+	bool success = true;
+	for (int s = 0; s < SCRIPTS; ++s) {
+		bool same = serial[s].size() == parallel[s].size()
+			&& !serial[s].empty();
+		for (int i = 0; same && i < (int)serial[s].size(); ++i) {
+			const TraceRecord& a = serial[s][i];
+			const TraceRecord& b = parallel[s][i];
+			same = a.timestamp == b.timestamp && a.from == b.from
+				&& a.to == b.to && a.slot == b.slot;
+		}
+		if (!same) {
+			std::cout << "Script " << s << " took different transitions"
+				<< " in parallel" << std::endl;
+			success = false;
+		}
+	}
+	return success;
+}
+
+int main(int argc, char **argv) {
+	bool success = true;
+
+	bool result = once();
+	std::cout << "Every task once: " << (result ? "ok" : "FAILED")
+		<< std::endl;
+	success &= result;
+
+	result = exceptions();
+	std::cout << "Exceptions: " << (result ? "ok" : "FAILED") << std::endl;
+	success &= result;
+
+	result = graphs();
+	std::cout << "Graphs in parallel: " << (result ? "ok" : "FAILED")
+		<< std::endl;
+	success &= result;
+
+	std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+	return success ? 0 : 1;
+}
@@ -0,0 +1,46 @@
+/*
+	Philip Romano
+	10/16/2026
+	record.cpp
+
+	Record Leap Motion input to a frame log (see framelog.h), for replaying
+	through gesture graphs later. Records until Enter is pressed.
+*/
+
+#include <iostream>
+#include <string>
+
+#include <Leap.h>
+
+#include "leaprecorder.h"
+
+int main(int argc, char **argv) {
+	std::string filename = (argc > 1) ? argv[1] : "record.handlog";
+
+	LeapRecorder recorder;
+	if (!recorder.open(filename)) {
+		std::cerr << "Could not create " << filename << std::endl;
+		return 1;
+	}
+
+	Leap::Controller controller;
+	controller.setPolicyFlags(
+			Leap::Controller::PolicyFlag::POLICY_BACKGROUND_FRAMES);
+	controller.addListener(recorder);
+
+	std::cout << "Recording to " << filename << "; press Enter to stop"
+		<< std::endl;
+	std::cin.get();
+
+	controller.removeListener(recorder);
+	bool written = recorder.close();
+
+	std::cout << recorder.getWritten() << " frames written, "
+		<< recorder.getDropped() << " dropped" << std::endl;
+	if (!written) {
+		std::cerr << "Could not write to " << filename << "; "
+			<< recorder.getLost() << " frames lost" << std::endl;
+		return 1;
+	}
+	return 0;
+}
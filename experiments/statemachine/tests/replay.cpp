@@ -0,0 +1,96 @@
+/*
+	Philip Romano
+	10/16/2026
+	replay.cpp
+
+	Replay a recorded frame log (see framelog.h and record.cpp) through one
+	of the demo graphs, as fast as the graph will run: no device, no window
+	and no waiting for frames. The transitions taken are printed to stdout,
+	one per line, so that the output of two builds can be diffed; the
+	throughput is printed to stderr. With --resample, the frames are first
+	resampled to a fixed rate, as the demos do (see FrameResampler). With
+	--filter, the hand's velocity is smoothed by the given filter instead
+	of the graph's own, such as "ema:0.3" or "euro:1,0.002" (see
+	VelocityFilter::parse()), or "kalman" for one that estimates ahead of
+	the average, to compare filters on the same recording.
+	With --hands, every hand is followed through its own session of the
+	graph (see HandTrackSet), and the transitions are tagged with the
+	hand's track.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+#include "gesturetrace.h"
+#include "framelog.h"
+#include "velocityfilter.h"
+
+#include "replay.h"
+
+int main(int argc, char **argv) {
+	bool quiet = false;
+	double rate = 0.0;
+	VelocityFilter filter;
+	bool filtered = false, hands = false, usage = false;
+	std::vector<std::string> args;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--quiet") == 0)
+			quiet = true;
+		else if (std::strcmp(argv[i], "--hands") == 0)
+			hands = true;
+		else if (std::strcmp(argv[i], "--resample") == 0 && i + 1 < argc)
+			rate = std::atof(argv[++i]);
+		else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+			filtered = true;
+			usage |= !VelocityFilter::parse(argv[++i], filter);
+		} else
+			args.push_back(argv[i]);
+	}
+
+	if (args.size() != 2 || usage) {
+		std::cerr << "Usage: " << argv[0]
+			<< " [homescreen|train|swipe|visual] [frame log] [--quiet]"
+			<< " [--resample frames/sec]"
+			<< " [--filter box|ema|euro|kalman[:settings]]"
+			<< " [--hands]" << std::endl;
+		return 1;
+	}
+
+	FrameLogReader log;
+	if (!log.open(args[1])) {
+		std::cerr << args[1] << " is not a valid frame log" << std::endl;
+		return 1;
+	}
+
+	if (!replay::isGraph(args[0])) {
+		std::cerr << "Unknown graph " << args[0] << std::endl;
+		return 1;
+	}
+
+	ReplayResult result;
+	try {
+		replay::run(args[0], log, result, rate,
+				filtered ? &filter : NULL, hands);
+	} catch (std::exception& e) {
+		std::cerr << "Exception: " << e.what() << std::endl;
+		return 1;
+	}
+
+	if (!quiet) {
+		GestureTrace::print(std::cout, result.nodeIds, result.transitions);
+		std::cout.flush();
+	}
+
+	double seconds = result.replayTime / 1e9;
+	std::cerr << result.frames << " frames, " << result.transitions.size()
+		<< " transitions in " << seconds * 1000.0 << " ms";
+	if (seconds > 0.0)
+		std::cerr << " (" << (int64_t)(result.frames / seconds)
+			<< " frames/sec)";
+	std::cerr << std::endl;
+	return 0;
+}
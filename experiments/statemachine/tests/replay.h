@@ -0,0 +1,201 @@
+/*
+	Philip Romano
+	10/16/2026
+	replay.h
+
+	Replaying a frame log through one of the demo graphs, shared by
+	replay.cpp and corpus.cpp.
+*/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include "gesturestategraph.h"
+#include "compiledgesturegraph.h"
+#include "gesturetrace.h"
+#include "gestureprofile.h"
+#include "framelog.h"
+#include "frameresampler.h"
+#include "velocityfilter.h"
+#include "handtrackset.h"
+#include "handblock.h"
+
+#include "homescreengraph.h"
+#include "traingraph.h"
+#include "swipegraph.h"
+#include "visualgraph.h"
+
+/**
+	What replaying one log produced.
+*/
+struct ReplayResult {
+	// Every transition taken, in order
+	std::vector<TraceRecord> transitions;
+
+	// Node IDs, indexed by the handles in transitions
+	std::vector<std::string> nodeIds;
+
+	// Frames fed to the graph
+	int64_t frames;
+
+	// Time spent replaying, in nanoseconds: feeding the frames to the
+	// graph, with resampling, velocity reduction and trace collection
+	int64_t replayTime;
+};
+
+namespace replay {
+	// Transitions are copied out of the trace well before it wraps
+	const int TRACE_CAPACITY = 1 << 16;
+
+	/**
+	  Append the records added to trace since the first taken were
+	  collected.
+	*/
+	inline void collect(const GestureTrace& trace, uint64_t& taken,
+			std::vector<TraceRecord>& transitions,
+			std::vector<TraceRecord>& snapshot) {
+		uint64_t count = trace.getCount();
+		if (count == taken)
+			return;
+
+		trace.snapshot(snapshot);
+		uint64_t fresh = count - taken;
+		transitions.insert(transitions.end(), snapshot.end() - fresh,
+				snapshot.end());
+		taken = count;
+	}
+
+	/**
+	  Feed count frames to gestures, or to tracks if it is not null,
+	  collecting the transitions into result as the trace fills. For a
+	  lone hand, the raw velocities of all the frames are reduced at once
+	  in block first (see HandBlock).
+	*/
+	template <class Graph>
+	void feed(Graph& gestures, HandTrackSet *tracks, HandBlock& block,
+			const HandFrame *frames, int count, const GestureTrace& trace,
+			uint64_t& taken, std::vector<TraceRecord>& snapshot,
+			ReplayResult& result) {
+		if (!tracks) {
+			block.load(frames, count);
+			block.reduce();
+		}
+		for (int i = 0; i < count; ++i) {
+			if (tracks)
+				tracks->update(frames[i]);
+			else
+				gestures.update(frames[i], block.getVelocity(i));
+			if (trace.getCount() - taken >= TRACE_CAPACITY / 2)
+				collect(trace, taken, result.transitions, snapshot);
+		}
+		result.frames += count;
+	}
+
+	/**
+	  Replay every frame of log through a new Graph, as fast as it will
+	  run, resampled to rate frames per second first (see FrameResampler)
+	  unless rate is 0, and with the hand's velocity smoothed by filter
+	  unless it is null. If hands is true, every hand is followed through
+	  its own session of the graph (see HandTrackSet), instead of only a
+	  lone hand through the graph itself.
+	*/
+	template <class Graph>
+	void run(const FrameLogReader& log, ReplayResult& result,
+			double rate = 0.0, const VelocityFilter *filter = NULL,
+			bool hands = false) {
+		Graph gestures;
+		if (filter)
+			gestures.setFilter(*filter);
+		GestureStateGraph& graph = gestures.getGraph();
+		boost::shared_ptr<const CompiledGestureGraph> compiled =
+			graph.compile();
+
+		boost::shared_ptr<GestureTrace> trace(
+				new GestureTrace(TRACE_CAPACITY));
+		boost::shared_ptr<HandTrackSet> tracks;
+		if (hands) {
+			tracks.reset(new HandTrackSet(compiled,
+						gestures.getExtractor()));
+			tracks->getSessions().setTrace(trace);
+		} else
+			graph.setTrace(trace);
+
+		std::vector<TraceRecord> snapshot;
+		uint64_t taken = 0;
+		result.transitions.clear();
+		result.frames = 0;
+
+		FrameResampler resampler(rate > 0.0 ? rate : 100.0);
+		HandBlock block;
+		std::vector<HandFrame> resampled(block.getCapacity());
+		int pending = 0;
+
+		int64_t start = GestureProfile::now();
+		if (rate > 0.0) {
+			for (FrameLogReader::const_iterator it = log.begin();
+					it != log.end(); ++it) {
+				resampler.push(*it);
+				while (resampler.next(resampled[pending])) {
+					if (++pending < block.getCapacity())
+						continue;
+					feed(gestures, tracks.get(), block, &resampled[0],
+							pending, *trace, taken, snapshot, result);
+					pending = 0;
+				}
+			}
+			feed(gestures, tracks.get(), block, &resampled[0], pending,
+					*trace, taken, snapshot, result);
+		} else {
+			// The log's frames are contiguous: feed them in place
+			for (int64_t first = 0; first < log.size();
+					first += block.getCapacity()) {
+				int count = (int)std::min<int64_t>(block.getCapacity(),
+						log.size() - first);
+				feed(gestures, tracks.get(), block, &log[first], count,
+						*trace, taken, snapshot, result);
+			}
+		}
+		result.replayTime = GestureProfile::now() - start;
+		collect(*trace, taken, result.transitions, snapshot);
+
+		result.nodeIds.clear();
+		for (int n = 0; n < compiled->getNodeCount(); ++n)
+			result.nodeIds.push_back(compiled->getNodeId(n));
+	}
+
+	/**
+	  Replay log through the demo graph with the given name (homescreen,
+	  train, swipe or visual).
+
+	  Returns true if graph names a demo graph; false otherwise
+	*/
+	inline bool run(const std::string& graph, const FrameLogReader& log,
+			ReplayResult& result, double rate = 0.0,
+			const VelocityFilter *filter = NULL, bool hands = false) {
+		if (graph == "homescreen")
+			run<HomescreenGraph>(log, result, rate, filter, hands);
+		else if (graph == "train")
+			run<TrainGraph>(log, result, rate, filter, hands);
+		else if (graph == "swipe")
+			run<SwipeGraph>(log, result, rate, filter, hands);
+		else if (graph == "visual")
+			run<VisualGraph>(log, result, rate, filter, hands);
+		else
+			return false;
+		return true;
+	}
+
+	inline bool isGraph(const std::string& graph) {
+		return graph == "homescreen" || graph == "train" || graph == "swipe"
+			|| graph == "visual";
+	}
+}
+
+#endif
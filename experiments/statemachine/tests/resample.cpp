@@ -0,0 +1,235 @@
+/*
+	Philip Romano
+	10/16/2026
+	resample.cpp
+
+	Test for FrameResampler
+	Feeds frames with jittery spacing and a gap, and checks that the output
+	sits exactly on the grid, that hands and fingers are interpolated by
+	ID, and that the gap is skipped. Then plays the same gestures at 60,
+	100 and 200 Hz through the graph of train.cpp, resampled to 100 Hz, and
+	checks that each rate costs the same number of updates and is
+	recognized the same, at the same times.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <stdint.h>
+
+#include <boost/bind/bind.hpp>
+
+#include "frameresampler.h"
+#include "handsynthesizer.h"
+#include "handframe.h"
+#include "gesturestategraph.h"
+
+#include "traingraph.h"
+
+namespace {
+	const int64_t GAP_START = 1000000;
+	const int64_t GAP_END = 1500000;
+}
+
+/**
+  The input motion: palm velocity x grows linearly with time, so that
+  interpolating between any two frames gives it exactly.
+*/
+static float getSpeed(int64_t time) {
+	return time / 1000.0f;
+}
+
+static void makeFrame(int64_t time, HandFrame& frame) {
+	frame.clear();
+	frame.id = time;
+	frame.timestamp = time;
+
+	// Hand 7 is always there; hand 9 joins at 0.5 s, ahead of it
+	frame.handCount = (time >= 500000) ? 2 : 1;
+	int h = 0;
+	if (time >= 500000) {
+		HandData& hand = frame.hands[h++];
+		hand.id = 9;
+		hand.palmVelocity.x = hand.palmVelocity.y = hand.palmVelocity.z = 0;
+		hand.palmNormal = hand.palmVelocity;
+		hand.palmPosition = hand.palmVelocity;
+		hand.fingerCount = 0;
+	}
+
+	HandData& hand = frame.hands[h];
+	hand.id = 7;
+	hand.palmPosition.x = hand.palmPosition.y = hand.palmPosition.z = 0;
+	hand.palmVelocity = hand.palmPosition;
+	hand.palmVelocity.x = getSpeed(time);
+	hand.palmNormal = hand.palmPosition;
+	hand.palmNormal.y = -1.0f;
+
+	// Finger 3 is listed first on odd frames and second on even ones
+	hand.fingerCount = 2;
+	bool odd = (time / 1000) % 2;
+	hand.fingers[odd ? 0 : 1].id = 3;
+	hand.fingers[odd ? 0 : 1].tipVelocity = hand.palmVelocity;
+	hand.fingers[odd ? 1 : 0].id = 4;
+	hand.fingers[odd ? 1 : 0].tipVelocity = hand.palmPosition;
+	hand.fingers[0].tipPosition = hand.fingers[1].tipPosition =
+		hand.palmPosition;
+}
+
+static bool grid() {
+	FrameResampler resampler(100.0);
+	HandFrame in, out;
+	bool success = true;
+	int64_t outputs = 0, lastTime = -1, inGap = 0;
+
+	// Spacing from 3 to 20 ms, with a gap of half a second
+	uint32_t x = 1;
+	for (int64_t time = 0; time < 3000000; ) {
+		makeFrame(time, in);
+		resampler.push(in);
+		while (resampler.next(out)) {
+			success &= (out.id == outputs++);
+			success &= out.timestamp > lastTime;
+			lastTime = out.timestamp;
+			if (out.timestamp > GAP_START && out.timestamp < GAP_END)
+				++inGap;
+
+			// On the grid of 10 ms from the start, or from the end of the gap
+			int64_t origin = (out.timestamp >= GAP_END) ? GAP_END : 0;
+			success &= (out.timestamp - origin) % 10000 == 0;
+
+			const HandData *hand = out.findHand(7);
+			success &= hand != NULL
+				&& std::fabs(hand->palmVelocity.x
+					- getSpeed(out.timestamp)) < 0.01f
+				&& hand->fingerCount == 2;
+			for (int f = 0; hand && f < hand->fingerCount; ++f) {
+				float expected = (hand->fingers[f].id == 3)
+					? getSpeed(out.timestamp) : 0.0f;
+				success &= std::fabs(hand->fingers[f].tipVelocity.x
+					- expected) < 0.01f;
+			}
+		}
+
+		x = x * 1664525 + 1013904223;
+		time += 3000 + (x >> 8) % 17000;
+		if (time > GAP_START && time < GAP_END)
+			time = GAP_END;
+	}
+
+	// About 100 frames a second, less the gap
+	success &= inGap == 0 && outputs > 240 && outputs < 260;
+
+	// Stale input is ignored
+	makeFrame(0, in);
+	success &= !resampler.push(in);
+
+	if (!success)
+		std::cout << outputs << " frames, " << inGap << " in the gap"
+			<< std::endl;
+	return success;
+}
+
+/**
+	Which nodes were entered, and when.
+*/
+struct Recognized {
+	std::vector<int> nodes;
+	std::vector<int64_t> times;
+	int64_t updates;
+	int64_t duration;
+
+	void enter(int node, const HandFrame& frame) {
+		nodes.push_back(node);
+		times.push_back(frame.timestamp);
+	}
+};
+
+/**
+  Play the scripted gestures at the given rate through the train graph,
+  resampled to 100 Hz.
+*/
+static Recognized recognize(double rate) {
+	static const char *nodes[] = {
+		"swL", "swR", "swU", "swD", "push", "pull",
+		"swLBacktrack", "swRBacktrack", "swUBacktrack", "swDBacktrack"
+	};
+	static const int NODES = sizeof(nodes) / sizeof(nodes[0]);
+
+	TrainGraph gestures;
+	Recognized recognized;
+	recognized.updates = 0;
+	for (int i = 0; i < NODES; ++i) {
+		gestures.getGraph().setEnterAction(nodes[i],
+				boost::bind(&Recognized::enter, &recognized, i,
+					boost::placeholders::_1));
+	}
+	gestures.getGraph().compile();
+
+	HandSynthesizer synth(rate);
+	synth.setNoise(20.0f);
+	synth.addStep(HandSynthesizer::IDLE, 500000);
+	for (int m = HandSynthesizer::SWIPE_LEFT; m < HandSynthesizer::MOTIONS;
+			++m) {
+		bool backtrack = (m >= HandSynthesizer::BACKTRACK_LEFT);
+		synth.addStep((HandSynthesizer::Motion)m,
+				backtrack ? 700000 : 400000);
+		synth.addStep(HandSynthesizer::IDLE, 500000);
+	}
+
+	FrameResampler resampler(100.0);
+	HandFrame frame, resampled;
+	while (synth.next(frame)) {
+		resampler.push(frame);
+		while (resampler.next(resampled)) {
+			gestures.update(resampled);
+			++recognized.updates;
+		}
+	}
+	recognized.duration = synth.getDuration();
+	return recognized;
+}
+
+static bool rates() {
+	static const double RATES[] = { 60.0, 100.0, 200.0 };
+	Recognized expected = recognize(100.0);
+	bool success = !expected.nodes.empty();
+
+	for (int r = 0; r < 3; ++r) {
+		Recognized result = recognize(RATES[r]);
+
+		// 100 updates a second, whatever the input rate
+		double perSecond = result.updates * 1e6 / result.duration;
+		bool same = std::fabs(perSecond - 100.0) < 1.0
+			&& result.nodes == expected.nodes;
+
+		// Within a frame at 60 Hz and a grid step of each other
+		for (int i = 0; same && i < (int)result.times.size(); ++i)
+			same = std::llabs(result.times[i] - expected.times[i]) <= 30000;
+
+		if (!same) {
+			std::cout << RATES[r] << " Hz: " << perSecond
+				<< " updates/sec, " << result.nodes.size() << " gestures"
+				<< std::endl;
+			success = false;
+		}
+	}
+	return success;
+}
+
+int main(int argc, char **argv) {
+	bool success = true;
+
+	bool result = grid();
+	std::cout << "Fixed grid: " << (result ? "ok" : "FAILED") << std::endl;
+	success &= result;
+
+	result = rates();
+	std::cout << "Rate independence: " << (result ? "ok" : "FAILED")
+		<< std::endl;
+	success &= result;
+
+	std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+	return success ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+/*
+	Philip Romano
+	10/16/2026
+	ringclient.cpp
+
+	The gesture engine's side of a frame ring (see framering.h): reads the
+	frames that tracker.x (or a real tracker) publishes and runs them
+	through one of the demo graphs as they arrive, straight out of shared
+	memory. Transitions are printed to stdout as they are taken; frames
+	read and missed are printed to stderr once the tracker closes the
+	ring.
+
+	With --policy, frames are instead copied out of the ring by a thread
+	of their own into a FrameIngest with that policy (queue, latest or
+	coalesce; see frameingest.h), and the graph runs on the main thread,
+	taking frames as it keeps up. --cost adds the given number of
+	microseconds of busy work to each update, to see what each policy does
+	with a graph that cannot keep up with the tracker; frames delivered,
+	coalesced and dropped are printed at the end.
+
+	  ringclient.x graph ringname [--policy name] [--capacity n]
+	      [--cost us]
+*/
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include "framering.h"
+#include "frameingest.h"
+#include "gestureprofile.h"
+#include "gesturestategraph.h"
+#include "compiledgesturegraph.h"
+#include "gesturetrace.h"
+
+#include "replay.h"
+
+namespace {
+	const int TRACE_CAPACITY = 1 << 12;
+
+	// How long to wait for the tracker to create the ring
+	const int OPEN_TIMEOUT_MS = 10000;
+}
+
+/**
+  Spin for cost microseconds, standing in for a slow graph.
+*/
+static void work(int64_t cost) {
+	int64_t until = GestureProfile::now() + cost * 1000;
+	while (GestureProfile::now() < until)
+		;
+}
+
+/**
+  Copy every frame from ring into ingest until the tracker closes the
+  ring.
+*/
+static void forward(FrameRingReader *ring, FrameIngest *ingest) {
+	HandFrame frame;
+	while (ring->wait()) {
+		while (ring->read(frame))
+			ingest->push(frame);
+	}
+	ingest->close();
+}
+
+template <class Graph>
+static int run(FrameRingReader& ring, FrameIngest *ingest, int64_t cost) {
+	Graph gestures;
+	GestureStateGraph& graph = gestures.getGraph();
+	boost::shared_ptr<const CompiledGestureGraph> compiled = graph.compile();
+
+	boost::shared_ptr<GestureTrace> trace(new GestureTrace(TRACE_CAPACITY));
+	graph.setTrace(trace);
+
+	std::vector<std::string> nodeIds;
+	for (int n = 0; n < compiled->getNodeCount(); ++n)
+		nodeIds.push_back(compiled->getNodeId(n));
+
+	std::vector<TraceRecord> transitions, snapshot;
+	uint64_t taken = 0;
+	int64_t torn = 0;
+
+	if (ingest) {
+		std::thread reader(forward, &ring, ingest);
+		HandFrame frame;
+		while (ingest->wait()) {
+			while (ingest->pop(frame)) {
+				gestures.update(frame);
+				work(cost);
+			}
+
+			transitions.clear();
+			replay::collect(*trace, taken, transitions, snapshot);
+			GestureTrace::print(std::cout, nodeIds, transitions);
+			std::cout.flush();
+		}
+		reader.join();
+	} else {
+		while (ring.wait()) {
+			const HandFrame *frame;
+			while ((frame = ring.acquire()) != NULL) {
+				// Read in place. The ring holds seconds of frames, so the
+				// tracker only overwrites one in use if this process
+				// stalls for that long in the middle of a frame.
+				gestures.update(*frame);
+				work(cost);
+				if (!ring.release())
+					++torn;
+			}
+
+			transitions.clear();
+			replay::collect(*trace, taken, transitions, snapshot);
+			GestureTrace::print(std::cout, nodeIds, transitions);
+			std::cout.flush();
+		}
+	}
+
+	std::cerr << ring.getRead() << " frames read, " << ring.getMissed()
+		<< " missed (" << torn << " overwritten while in use)" << std::endl;
+	if (ingest) {
+		IngestStats stats = ingest->getStats();
+		std::cerr << FrameIngest::getPolicyName(ingest->getPolicy()) << ": "
+			<< stats.delivered << " delivered, " << stats.coalesced
+			<< " coalesced, " << stats.dropped << " dropped, at most "
+			<< stats.maxPending << " pending, longest wait "
+			<< stats.maxDelay / 1000 << " us" << std::endl;
+	}
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	bool usage = argc < 3 || !replay::isGraph(argv[1]);
+	bool ingested = false;
+	FrameIngest::Policy policy = FrameIngest::QUEUE;
+	int capacity = 16;
+	int64_t cost = 0;
+	for (int a = 3; !usage && a < argc; ++a) {
+		std::string arg = argv[a];
+		if (arg == "--policy" && a + 1 < argc)
+			usage = !FrameIngest::parsePolicy(argv[++a], policy);
+		else if (arg == "--capacity" && a + 1 < argc)
+			capacity = std::atoi(argv[++a]);
+		else if (arg == "--cost" && a + 1 < argc)
+			cost = std::atoi(argv[++a]);
+		else
+			usage = true;
+		ingested |= (arg == "--policy" || arg == "--capacity");
+	}
+	if (usage || capacity < 1) {
+		std::cerr << "Usage: " << argv[0]
+			<< " [homescreen|train|swipe|visual] [ring name]"
+			<< " [--policy queue|latest|coalesce] [--capacity frames]"
+			<< " [--cost microseconds]" << std::endl;
+		return 1;
+	}
+
+	const std::string graph = argv[1], name = argv[2];
+
+	// The reader may be started before the tracker
+	FrameRingReader ring;
+	for (int waited = 0; !ring.open(name); waited += 100) {
+		if (waited >= OPEN_TIMEOUT_MS) {
+			std::cerr << "No ring named " << name << std::endl;
+			return 1;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+
+	FrameIngest buffer(policy, capacity);
+	FrameIngest *ingest = ingested ? &buffer : NULL;
+
+	try {
+		if (graph == "homescreen")
+			return run<HomescreenGraph>(ring, ingest, cost);
+		else if (graph == "train")
+			return run<TrainGraph>(ring, ingest, cost);
+		else if (graph == "swipe")
+			return run<SwipeGraph>(ring, ingest, cost);
+		else
+			return run<VisualGraph>(ring, ingest, cost);
+	} catch (std::exception& e) {
+		std::cerr << "Exception: " << e.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,171 @@
+/*
+	Philip Romano
+	10/16/2026
+	roundtrip.cpp
+
+	Test for FrameLogWriter and FrameLogReader
+	Writes a track of frames to a frame log through a ring much smaller
+	than the track, appending whenever the ring has room, maps it back in
+	and checks that every frame comes back byte for byte and that nothing
+	was dropped. Then checks that a truncated or foreign file is handled,
+	and that frames that do not fit on the disk are counted as lost rather
+	than written.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <chrono>
+#include <stdint.h>
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/resource.h>
+#endif
+
+#include "handframe.h"
+#include "framelog.h"
+
+static void recordTrack(std::vector<HandFrame>& track, int frames) {
+	track.resize(frames);
+	for (int i = 0; i < frames; ++i) {
+		HandFrame& frame = track[i];
+		std::memset(&frame, 0, sizeof(frame));
+		frame.id = i;
+		frame.timestamp = (int64_t)i * 10000;
+		frame.handCount = 1 + i % HandFrame::MAX_HANDS;
+		for (int h = 0; h < frame.handCount; ++h) {
+			HandData& hand = frame.hands[h];
+			hand.id = h + 1;
+			hand.palmPosition.x = (float)i;
+			hand.palmVelocity.y = (float)-i;
+			hand.palmNormal.z = (float)h;
+			hand.fingerCount = i % (HandData::MAX_FINGERS + 1);
+			for (int f = 0; f < hand.fingerCount; ++f) {
+				hand.fingers[f].id = h * 10 + f;
+				hand.fingers[f].tipPosition.x = (float)(i + f);
+			}
+		}
+	}
+}
+
+/**
+  Append the frames of track to writer, waiting for the writer thread
+  whenever the ring of the given capacity is full, so that none is dropped.
+*/
+static void appendAll(FrameLogWriter& writer, int capacity,
+		const std::vector<HandFrame>& track, uint64_t& waits) {
+	for (int i = 0; i < (int)track.size(); ++i) {
+		while ((uint64_t)i - writer.getWritten() - writer.getLost()
+				>= (uint64_t)capacity) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			++waits;
+		}
+		writer.append(track[i]);
+	}
+}
+
+#ifndef _WIN32
+/**
+  Write track to a file that may grow to only a few frames, as if the disk
+  filled up.
+*/
+static bool diskFull(const std::string& filename,
+		const std::vector<HandFrame>& track) {
+	const int FIT = 100;
+	struct rlimit limit, previous;
+	getrlimit(RLIMIT_FSIZE, &previous);
+	limit = previous;
+	limit.rlim_cur = sizeof(FrameLogHeader) + FIT * sizeof(HandFrame);
+	std::signal(SIGXFSZ, SIG_IGN);
+	setrlimit(RLIMIT_FSIZE, &limit);
+
+	FrameLogWriter writer(64);
+	bool success = writer.open(filename);
+	uint64_t waits = 0;
+	appendAll(writer, 64, track, waits);
+	success &= !writer.close();
+	setrlimit(RLIMIT_FSIZE, &previous);
+
+	success &= writer.getWritten() == FIT
+		&& writer.getLost() == track.size() - FIT
+		&& writer.getDropped() == 0;
+	std::cout << writer.getWritten() << " frames written to a full disk, "
+		<< writer.getLost() << " lost" << std::endl;
+
+	// The log holds exactly the frames counted as written
+	FrameLogReader reader;
+	success &= reader.open(filename) && reader.size() == FIT
+		&& std::memcmp(&reader[FIT - 1], &track[FIT - 1],
+				sizeof(HandFrame)) == 0;
+	return success;
+}
+#endif
+
+int main(int argc, char **argv) {
+	bool success = true;
+	const std::string filename = "roundtrip.handlog";
+
+	std::vector<HandFrame> track;
+	recordTrack(track, 10000);
+
+	// A ring much smaller than the track, so the writer thread has to keep
+	// up; appends wait for room rather than being dropped
+	FrameLogWriter writer(64);
+	success &= writer.open(filename);
+	uint64_t waits = 0;
+	appendAll(writer, 64, track, waits);
+	success &= writer.close();
+	std::cout << writer.getWritten() << " frames written, waited for the "
+		<< "writer " << waits << " times" << std::endl;
+	success &= (writer.getWritten() == track.size());
+	success &= (writer.getDropped() == 0 && writer.getLost() == 0);
+
+	FrameLogReader reader;
+	success &= reader.open(filename);
+	success &= (reader.size() == (int64_t)track.size());
+	int mismatched = 0;
+	int64_t i = 0;
+	for (FrameLogReader::const_iterator it = reader.begin();
+			it != reader.end() && i < (int64_t)track.size(); ++it, ++i) {
+		if (std::memcmp(&*it, &track[i], sizeof(HandFrame)) != 0)
+			++mismatched;
+	}
+	std::cout << reader.size() << " frames read, " << mismatched
+		<< " mismatched" << std::endl;
+	success &= (mismatched == 0);
+	reader.close();
+
+	// A recording cut short mid-frame loses only the partial frame
+	{
+		std::ofstream out(filename.c_str(),
+				std::ios::binary | std::ios::app);
+		out.write(reinterpret_cast<const char*>(&track[0]),
+				sizeof(HandFrame) / 2);
+	}
+	success &= reader.open(filename);
+	success &= (reader.size() == (int64_t)track.size());
+	reader.close();
+
+	// Anything else is rejected
+	{
+		std::ofstream out(filename.c_str(), std::ios::binary);
+		out << "This is not a frame log, although it is long enough to "
+			"hold a header if anybody were to try reading it as one.";
+	}
+	success &= !reader.open(filename);
+	success &= !reader.isOpen();
+
+#ifndef _WIN32
+	success &= diskFull(filename, track);
+#endif
+
+	std::remove(filename.c_str());
+
+	std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+	return success ? 0 : 1;
+}
@@ -0,0 +1,242 @@
+/*
+	Philip Romano
+	10/16/2026
+	sharedring.cpp
+
+	Test for FrameRingWriter and FrameRingReader
+	Publishes frames into a shared-memory ring from one thread while two
+	readers, each with a mapping of its own, read them back in place; every
+	frame must either arrive intact and in order or be counted as missed.
+	Then checks that a reader lapped by the writer skips exactly the frames
+	overwritten, and that wait() times out and sees the ring closed.
+*/
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <stdint.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "framering.h"
+#include "handframe.h"
+
+namespace {
+	const int FRAMES = 200000;
+	const int CAPACITY = 64;
+}
+
+/**
+  Returns a ring name that no other run of the test is using.
+*/
+static std::string getRingName(const std::string& test) {
+	std::ostringstream name;
+	name << "sharedring-" << test << "-";
+#ifdef _WIN32
+	name << GetCurrentProcessId();
+#else
+	name << getpid();
+#endif
+	return name.str();
+}
+
+/**
+  Fill in frame i so that each frame can be checked on its own: every
+  field is derived from the frame's ID.
+*/
+static void makeFrame(int64_t i, HandFrame& frame) {
+	frame.clear();
+	frame.id = i;
+	frame.timestamp = i * 10000;
+	frame.handCount = 1 + (int)(i % HandFrame::MAX_HANDS);
+	for (int h = 0; h < frame.handCount; ++h) {
+		HandData& hand = frame.hands[h];
+		hand.id = (int32_t)(i + h);
+		hand.palmVelocity.x = (float)(i % 1000);
+		hand.fingerCount = 0;
+	}
+}
+
+static bool isIntact(const HandFrame& frame) {
+	int64_t i = frame.id;
+	if (frame.timestamp != i * 10000
+			|| frame.handCount != 1 + (int)(i % HandFrame::MAX_HANDS))
+		return false;
+	for (int h = 0; h < frame.handCount; ++h) {
+		if (frame.hands[h].id != (int32_t)(i + h)
+				|| frame.hands[h].palmVelocity.x != (float)(i % 1000))
+			return false;
+	}
+	return true;
+}
+
+struct ReaderResult {
+	bool opened;
+	bool ordered;
+	int64_t read;
+	int64_t missed;
+};
+
+static void readAll(const std::string& name, ReaderResult *result) {
+	FrameRingReader reader;
+	result->opened = reader.open(name);
+	result->ordered = true;
+
+	int64_t last = -1;
+	while (reader.wait(5000)) {
+		const HandFrame *frame;
+		while ((frame = reader.acquire()) != NULL) {
+			int64_t id = frame->id;
+			bool intact = isIntact(*frame);
+			if (reader.release()) {
+				// Only what was read from an unbroken frame counts
+				result->ordered &= intact && id > last;
+				last = id;
+			}
+		}
+	}
+
+	result->read = reader.getRead();
+	result->missed = reader.getMissed();
+}
+
+static bool concurrent() {
+	std::string name = getRingName("concurrent");
+	FrameRingWriter writer;
+	if (!writer.create(name, CAPACITY)) {
+		std::cout << "Could not create ring " << name << std::endl;
+		return false;
+	}
+
+	ReaderResult results[2];
+	std::vector<std::thread> readers;
+	for (int r = 0; r < 2; ++r)
+		readers.push_back(std::thread(readAll, name, &results[r]));
+
+	// Give the readers time to open the ring before anything is published
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	for (int i = 0; i < FRAMES; ++i) {
+		makeFrame(i, *writer.beginAppend());
+		writer.commitAppend();
+		if (i % 1000 == 0)
+			std::this_thread::yield();
+	}
+	writer.close();
+
+	bool success = true;
+	for (int r = 0; r < 2; ++r) {
+		readers[r].join();
+		const ReaderResult& result = results[r];
+		std::cout << "Reader " << r << ": " << result.read << " read, "
+			<< result.missed << " missed" << std::endl;
+		success &= result.opened && result.ordered
+			&& result.read + result.missed == FRAMES && result.read > 0;
+	}
+	return success;
+}
+
+static bool lapped() {
+	std::string name = getRingName("lapped");
+	FrameRingWriter writer;
+	FrameRingReader reader;
+	if (!writer.create(name, CAPACITY) || !reader.open(name))
+		return false;
+
+	HandFrame frame;
+	for (int i = 0; i < 3 * CAPACITY + 5; ++i) {
+		makeFrame(i, frame);
+		writer.append(frame);
+	}
+
+	// The first 2 * CAPACITY + 5 frames are gone
+	bool success = true;
+	int64_t expected = 2 * CAPACITY + 5;
+	while (reader.read(frame)) {
+		success &= (frame.id == expected++) && isIntact(frame);
+	}
+	success &= (expected == 3 * CAPACITY + 5)
+		&& reader.getRead() == CAPACITY
+		&& reader.getMissed() == 2 * CAPACITY + 5;
+
+	// A frame overwritten while held is reported on release()
+	makeFrame(expected, frame);
+	writer.append(frame);
+	const HandFrame *held = reader.acquire();
+	for (int i = 0; i < CAPACITY; ++i) {
+		makeFrame(++expected, frame);
+		writer.append(frame);
+	}
+	success &= held != NULL && !reader.release();
+
+	// skipToLatest() leaves only the newest frame
+	reader.skipToLatest();
+	success &= reader.read(frame) && frame.id == expected
+		&& reader.getAvailable() == 0;
+
+	if (!success)
+		std::cout << "Lapped reader did not skip as expected" << std::endl;
+	return success;
+}
+
+static bool waiting() {
+	std::string name = getRingName("waiting");
+	FrameRingWriter writer;
+	FrameRingReader reader, missing;
+	if (!writer.create(name, CAPACITY) || !reader.open(name))
+		return false;
+
+	bool success = !missing.open(getRingName("missing"));
+
+	// Nothing published: times out
+	std::chrono::steady_clock::time_point start =
+		std::chrono::steady_clock::now();
+	success &= !reader.wait(50);
+	int64_t waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - start).count();
+	success &= waited >= 40;
+
+	// Woken by a frame published from another thread, then by the close
+	std::thread publisher([&writer]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		HandFrame frame;
+		makeFrame(0, frame);
+		writer.append(frame);
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		writer.close();
+	});
+	HandFrame frame;
+	success &= reader.wait(5000) && reader.read(frame) && frame.id == 0;
+	success &= !reader.wait(5000) && reader.isWriterClosed();
+	publisher.join();
+
+	if (!success)
+		std::cout << "wait() did not wake or time out as expected"
+			<< std::endl;
+	return success;
+}
+
+int main(int argc, char **argv) {
+	bool success = true;
+
+	bool result = concurrent();
+	std::cout << "Concurrent readers: " << (result ? "ok" : "FAILED")
+		<< std::endl;
+	success &= result;
+
+	result = lapped();
+	std::cout << "Lapped reader: " << (result ? "ok" : "FAILED")
+		<< std::endl;
+	success &= result;
+
+	result = waiting();
+	std::cout << "Waiting: " << (result ? "ok" : "FAILED") << std::endl;
+	success &= result;
+
+	std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+	return success ? 0 : 1;
+}
@@ -20,6 +20,7 @@
 
 #include "gesturestategraph.h"
 #include "gesturenode.h"
+#include "leapframe.h"
 
 #ifdef _WIN32
 #undef main // Windows doesn't like the SDL_main thing
@@ -43,12 +44,10 @@ class Node_Motion : public GestureNode {
 			    200mm/s
 		    0 otherwise
 		*/
-		virtual int evaluate(const Leap::Frame& frame,
-				const std::string& nodeid) {
-			Leap::HandList hands = frame.hands();
-			if (hands.count() == 1) {
-				Leap::Hand h = (*hands.begin());
-				Leap::Vector vel = h.palmVelocity();
+		virtual int evaluate(const HandFrame& frame,
+				const std::string& nodeid, void *state) {
+			if (frame.handCount == 1) {
+				Vector3 vel = frame.hands[0].palmVelocity;
 				vel.z = 0.0; // Only check motion in x-y plane
 				if (vel.magnitude() >= 200.0) {
 					return 1;
@@ -80,12 +79,10 @@ class Node_Direction : public GestureNode {
 
 		    2 if error! ...No hands
 		*/
-		virtual int evaluate(const Leap::Frame& frame,
-				const std::string& nodeid) {
-			Leap::HandList hands = frame.hands();
-			if (hands.count() > 0) {
-				Leap::Hand h = (*hands.begin());
-				Leap::Vector vel = h.palmVelocity();
+		virtual int evaluate(const HandFrame& frame,
+				const std::string& nodeid, void *state) {
+			if (frame.handCount > 0) {
+				Vector3 vel = frame.hands[0].palmVelocity;
 				if (abs(vel.y) <= abs(vel.x)) {
 					std::cout << "HORZ" << std::endl;
 					return 1;
@@ -118,6 +115,9 @@ class Engine : public Leap::Listener {
 
 			mGraph.addConnection("horizontal", 1, "horizontal");
 			mGraph.addConnection("vertical", 0, "vertical");
+
+			// Validate the graph before any frames arrive
+			mGraph.compile();
 		}
 
 		~Engine()
@@ -128,7 +128,8 @@ class Engine : public Leap::Listener {
 		}
 
 		virtual void onFrame(const Leap::Controller &c) {
-			mGraph.update(c.frame(0));
+			toHandFrame(c.frame(0), mFrame);
+			mGraph.update(mFrame);
 		}
 
 		void run() {
@@ -138,6 +139,9 @@ class Engine : public Leap::Listener {
 
 	private:
 		GestureStateGraph mGraph;
+
+		// Graph input, converted from the latest Leap frame
+		HandFrame mFrame;
 };
 
 int main(int argc, char **argv) {
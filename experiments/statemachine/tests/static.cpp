@@ -26,11 +26,11 @@ class Node_Horizontal : public GestureNode {
 		  1 if abs(yvel) <= 1/2 abs(xvel)
 		  0 otherwise
 		*/
-		virtual int evaluate(const Leap::Frame &frame,
-				const std::string& nodeid) {
-			Leap::Hand h = frame.hand(0);
-			if (h.isValid()) {
-				Leap::Vector vel = h.palmVelocity();
+		virtual int evaluate(const HandFrame& frame,
+				const std::string& nodeid, void *state) {
+			const HandData *h = frame.findHand(0);
+			if (h) {
+				Vector3 vel = h->palmVelocity;
 				return (abs(vel.y) <= 0.5 * abs(vel.x))
 						? 1 : 0;
 			} else
@@ -50,11 +50,11 @@ class Node_Vertical : public GestureNode {
 		  1 if abs(xvel) <= 1/2 abs(yvel)
 		  0 otherwise
 		*/
-		virtual int evaluate(const Leap::Frame &frame,
-				const std::string& nodeid) {
-			Leap::Hand h = frame.hand(0);
-			if (h.isValid()) {
-				Leap::Vector vel = h.palmVelocity();
+		virtual int evaluate(const HandFrame& frame,
+				const std::string& nodeid, void *state) {
+			const HandData *h = frame.findHand(0);
+			if (h) {
+				Vector3 vel = h->palmVelocity;
 				return (abs(vel.x) <= 0.5 * abs(vel.y))
 						? 1 : 0;
 			} else
@@ -0,0 +1,473 @@
+/*
+	Philip Romano
+	10/16/2026
+	swipegraph.h
+
+	The gesture graph of swipe.cpp, apart from its window and device, so
+	that replay.cpp can drive the same graph from recorded frames.
+*/
+
+#ifndef SWIPEGRAPH_H
+#define SWIPEGRAPH_H
+
+#include <iostream>
+#include <string>
+#include <math.h>
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "gesturestategraph.h"
+#include "featurenode.h"
+#include "featureframe.h"
+#include "handframe.h"
+#include "handmotion.h"
+#include "velocityfilter.h"
+
+/**
+	Swipes left, right, up and down, with backtracking. The nodes read the
+	main hand's smoothed velocity.
+*/
+class SwipeGraph {
+	public:
+		class Node_Motion : public FeatureNode {
+			public:
+				Node_Motion()
+						: FeatureNode(FeatureFrame::XY_SPEED) {
+				}
+
+				virtual std::string& getName() {
+					static std::string name("Motion");
+					return name;
+				}
+
+				/**
+				  Determines if there is one hand, and its speed is greater
+				  than a threshold value.
+
+				  Slots:
+					1 if one hand is present, and the magnitude of velocity is
+					    >= 200 mm/s
+					0 otherwise
+				*/
+				virtual int evaluate(const FeatureFrame& frame,
+						const std::string& nodeid) {
+					if (frame.hasHand && frame.xySpeed >= 300.0)
+						return 1;
+					else
+						return 0;
+				}
+		};
+
+		class Node_CoarseDirection : public FeatureNode {
+			public:
+				Node_CoarseDirection()
+						: FeatureNode(FeatureFrame::VELOCITY) {
+				}
+
+				virtual std::string& getName() {
+					static std::string name("CoarseDirection");
+					return name;
+				}
+
+				/**
+				  Determines the direction of motion in the xy-plane; either
+				  horizontal or vertical, split by the lines y = x and y = -x
+
+				  Slots:
+					0 if vertical motion   [ |vx| < |vy| ]
+					1 if horizontal motion [ otherwise ]
+
+					2 if error! ...no hands :(
+				*/
+				virtual int evaluate(const FeatureFrame& frame,
+						const std::string& nodeid) {
+					// TODO Try getting rid of this check... it shouldn't be
+					// necessary with the right flow of states
+					if (frame.hasHand) {
+						if (abs(frame.velocity.x) < abs(frame.velocity.y))
+							return 0;
+						else
+							return 1;
+					} else {
+						std::cout << "BAD!!" << std::endl;
+						return 2;
+					}
+				}
+		};
+
+		class Node_LeftRight : public FeatureNode {
+			public:
+				Node_LeftRight()
+						: FeatureNode(FeatureFrame::VELOCITY) {
+				}
+
+				virtual std::string& getName() {
+					static std::string name("LeftRight");
+					return name;
+				}
+
+				/**
+				  Determines whether the motion is leftwards or rightwards.
+
+				  Slots:
+					0 if leftward motion  [ vx <= 0 ]
+					1 if rightward motion [ vx >  0 ]
+
+					2 if error! ...no hands :(
+				*/
+				virtual int evaluate(const FeatureFrame& frame,
+						const std::string& nodeid) {
+					// TODO Try getting rid of this check... it shouldn't be
+					// necessary with the right flow of states
+					if (frame.hasHand) {
+						if (frame.velocity.x <= 0) {
+							return 0;
+						} else
+							return 1;
+					} else {
+						std::cout << "BAD!!" << std::endl;
+						return 2;
+					}
+				}
+		};
+
+		class Node_UpDown : public FeatureNode {
+			public:
+				Node_UpDown()
+						: FeatureNode(FeatureFrame::VELOCITY) {
+				}
+
+				virtual std::string& getName() {
+					static std::string name("UpDown");
+					return name;
+				}
+
+				/**
+				  Determines whether the motion is upwards or downwards.
+
+				  Slots:
+					0 if downward motion [ vy <= 0 ]
+					1 if upward motion   [ vy >  0 ]
+
+					2 if error! ...no hands :(
+				*/
+				virtual int evaluate(const FeatureFrame& frame,
+						const std::string& nodeid) {
+					// TODO Try getting rid of this check... it shouldn't be
+					// necessary with the right flow of states
+					if (frame.hasHand) {
+						if (frame.velocity.y <= 0)
+							return 0;
+						else
+							return 1;
+					} else {
+						std::cout << "BAD!!" << std::endl;
+						return 2;
+					}
+				}
+		};
+
+		/**
+		  Per-node state of the Limbo node types: the time at which the
+		  node was entered.
+		*/
+		struct LimboState {
+			uint64_t timeStart;
+		};
+
+		class Node_LeftRightLimbo : public StatefulFeatureNode<LimboState> {
+			private:
+				uint64_t mTimelimit;
+				float    mThreshold;
+
+			public:
+				/**
+				  timer : number of microseconds before timing out (slot 0)
+				  threshold : minimum threshold of hand speed to leave state
+				      Should be positive (it is absolute-valued anyway)
+				*/
+				Node_LeftRightLimbo(uint64_t timer = 100000,
+						float threshold = 50.0f)
+						: StatefulFeatureNode<LimboState>(
+							FeatureFrame::VELOCITY) {
+					mThreshold = abs(threshold);
+					mTimelimit = timer;
+				}
+
+				virtual std::string& getName() {
+					static std::string name("LRLimbo");
+					return name;
+				}
+
+				/**
+				  Waits in this state until either a timer runs out, or the
+				  speed in the x direction becomes greater than a threshold.
+
+				  Slots:
+				    3 if moving rightwards  [ vx >= threshold ]
+					2 if moving leftwards   [ vx <= -theshold ]
+					1 if negligible movemtn [ -threshold < vx < threshold ]
+					0 if the timer runs out, or no hand is present
+				*/
+				virtual int evaluate(const FeatureFrame& frame,
+						const std::string& nodeid, LimboState& state) {
+					if (frame.hasHand
+							&& frame.timestamp - state.timeStart < mTimelimit) {
+						if (frame.velocity.x >= mThreshold)
+							return 3;
+						else if (frame.velocity.x <= -mThreshold)
+							return 2;
+						else
+							return 1;
+					} else
+						return 0;
+				}
+
+				virtual void onEnter(const FeatureFrame& frame,
+						const std::string& nodeid, LimboState& state) {
+					state.timeStart = frame.timestamp;
+				}
+		};
+
+		class Node_UpDownLimbo : public StatefulFeatureNode<LimboState> {
+			private:
+				uint64_t mTimelimit;
+				float    mThreshold;
+
+			public:
+				/**
+				  timer : number of microseconds before timing out (slot 0)
+				  threshold : minimum threshold of hand speed to leave state
+				      Should be positive (it is absolute-valued anyway)
+				*/
+				Node_UpDownLimbo(uint64_t timer = 100000,
+						float threshold = 50.0f)
+						: StatefulFeatureNode<LimboState>(
+							FeatureFrame::VELOCITY) {
+					mThreshold = abs(threshold);
+					mTimelimit = timer;
+				}
+
+				virtual std::string& getName() {
+					static std::string name("UDLimbo");
+					return name;
+				}
+
+				/**
+				  Waits in this state until either a timer runs out, or the
+				  speed in the y direction becomes greater than a threshold.
+
+				  Slots:
+				    3 if moving upwards     [ vy >= threshold ]
+					2 if moving downwards   [ vy <= -theshold ]
+					1 if negligible movemnt [ -threshold < vy < threshold ]
+					0 if the timer runs out, or no hand is present
+				*/
+				virtual int evaluate(const FeatureFrame& frame,
+						const std::string& nodeid, LimboState& state) {
+					if (frame.hasHand
+							&& frame.timestamp - state.timeStart < mTimelimit) {
+						if (frame.velocity.y >= mThreshold)
+							return 3;
+						else if (frame.velocity.y <= -mThreshold)
+							return 2;
+						else
+							return 1;
+					} else
+						return 0;
+				}
+
+				virtual void onEnter(const FeatureFrame& frame,
+						const std::string& nodeid, LimboState& state) {
+					state.timeStart = frame.timestamp;
+				}
+		};
+
+		/**
+		  Build the graph. The owner sets any actions, then compiles it.
+		*/
+		SwipeGraph()
+				: mExtractor(5, 0) {
+			mFeatures.clear();
+
+			addType(new Node_Motion());
+			addType(new Node_CoarseDirection());
+			addType(new Node_LeftRight());
+			addType(new Node_UpDown());
+			addType(new Node_LeftRightLimbo(100000, 50.0f));
+			addType(new Node_UpDownLimbo(100000, 50.0f));
+
+			/* Nodes */
+
+			mGraph.addNode("Motion",          "noMotion");
+			mGraph.addNode("CoarseDirection", "coarse");
+			mGraph.addNode("LeftRight",       "stHorizontal");
+			mGraph.addNode("UpDown",          "stVertical");
+
+			mGraph.addNode("LeftRight", "swL");
+			mGraph.addNode("LeftRight", "swR");
+			mGraph.addNode("UpDown",    "swU");
+			mGraph.addNode("UpDown",    "swD");
+
+			mGraph.addNode("LRLimbo",   "swLToBacktrack");
+			mGraph.addNode("LeftRight", "swLBacktrack");
+			mGraph.addNode("LRLimbo",   "swLFromBacktrack");
+			mGraph.addNode("LRLimbo",   "swRToBacktrack");
+			mGraph.addNode("LeftRight", "swRBacktrack");
+			mGraph.addNode("LRLimbo",   "swRFromBacktrack");
+
+			mGraph.addNode("UDLimbo",   "swUToBacktrack");
+			mGraph.addNode("UpDown",    "swUBacktrack");
+			mGraph.addNode("UDLimbo",   "swUFromBacktrack");
+			mGraph.addNode("UDLimbo",   "swDToBacktrack");
+			mGraph.addNode("UpDown",    "swDBacktrack");
+			mGraph.addNode("UDLimbo",   "swDFromBacktrack");
+
+			mGraph.setStart("noMotion");
+
+			/* Connections */
+
+			mGraph.addConnection("noMotion", 1, "coarse");
+			mGraph.addConnection("coarse", 0, "stVertical");
+			mGraph.addConnection("coarse", 1, "stHorizontal");
+
+			mGraph.addConnection("stHorizontal", 0, "swL");
+			mGraph.addConnection("stHorizontal", 1, "swR");
+			mGraph.addConnection("stVertical",   0, "swD");
+			mGraph.addConnection("stVertical",   1, "swU");
+
+			// Swipe LEFT sub-cycle
+			mGraph.addConnection("swL",              0, "swL");
+			mGraph.addConnection("swL",              1, "swLToBacktrack");
+			mGraph.addConnection("swLToBacktrack",   1, "swLToBacktrack");
+			mGraph.addConnection("swLToBacktrack",   2, "swLToBacktrack");
+			mGraph.addConnection("swLToBacktrack",   3, "swLBacktrack");
+			mGraph.addConnection("swLBacktrack",     0, "swLFromBacktrack");
+			mGraph.addConnection("swLBacktrack",     1, "swLBacktrack");
+			mGraph.addConnection("swLFromBacktrack", 1, "swLFromBacktrack");
+			mGraph.addConnection("swLFromBacktrack", 2, "swL");
+			mGraph.addConnection("swLFromBacktrack", 3, "swLFromBacktrack");
+
+			// Swipe RIGHT sub-cycle
+			mGraph.addConnection("swR",              0, "swRToBacktrack");
+			mGraph.addConnection("swR",              1, "swR");
+			mGraph.addConnection("swRToBacktrack",   1, "swRToBacktrack");
+			mGraph.addConnection("swRToBacktrack",   2, "swRBacktrack");
+			mGraph.addConnection("swRToBacktrack",   3, "swRToBacktrack");
+			mGraph.addConnection("swRBacktrack",     0, "swRBacktrack");
+			mGraph.addConnection("swRBacktrack",     1, "swRFromBacktrack");
+			mGraph.addConnection("swRFromBacktrack", 1, "swRFromBacktrack");
+			mGraph.addConnection("swRFromBacktrack", 2, "swRFromBacktrack");
+			mGraph.addConnection("swRFromBacktrack", 3, "swR");
+
+			// Swipe UP sub-cycle
+			mGraph.addConnection("swU",              0, "swUToBacktrack");
+			mGraph.addConnection("swU",              1, "swU");
+			mGraph.addConnection("swUToBacktrack",   1, "swUToBacktrack");
+			mGraph.addConnection("swUToBacktrack",   2, "swUBacktrack");
+			mGraph.addConnection("swUToBacktrack",   3, "swUToBacktrack");
+			mGraph.addConnection("swUBacktrack",     0, "swUBacktrack");
+			mGraph.addConnection("swUBacktrack",     1, "swUFromBacktrack");
+			mGraph.addConnection("swUFromBacktrack", 1, "swUFromBacktrack");
+			mGraph.addConnection("swUFromBacktrack", 2, "swUFromBacktrack");
+			mGraph.addConnection("swUFromBacktrack", 3, "swU");
+
+			// Swipe DOWN sub-cycle
+			mGraph.addConnection("swD",              0, "swD");
+			mGraph.addConnection("swD",              1, "swDToBacktrack");
+			mGraph.addConnection("swDToBacktrack",   1, "swDToBacktrack");
+			mGraph.addConnection("swDToBacktrack",   2, "swDToBacktrack");
+			mGraph.addConnection("swDToBacktrack",   3, "swDBacktrack");
+			mGraph.addConnection("swDBacktrack",     0, "swDFromBacktrack");
+			mGraph.addConnection("swDBacktrack",     1, "swDBacktrack");
+			mGraph.addConnection("swDFromBacktrack", 1, "swDFromBacktrack");
+			mGraph.addConnection("swDFromBacktrack", 2, "swD");
+			mGraph.addConnection("swDFromBacktrack", 3, "swDFromBacktrack");
+		}
+
+		/**
+		  Extract the features the nodes read from frame, then advance the
+		  graph on them.
+		*/
+		void update(const HandFrame& frame) {
+			mExtractor.extract(frame, mFeatures);
+			mGraph.update(mFeatures);
+		}
+
+		/**
+		  As update(), with the raw velocity of the frame's hand already
+		  computed (see HandBlock).
+		*/
+		void update(const HandFrame& frame, const Vector3& rawVelocity) {
+			mExtractor.extract(frame, rawVelocity, mFeatures);
+			mGraph.update(mFeatures);
+		}
+
+		GestureStateGraph& getGraph() {
+			return mGraph;
+		}
+
+		const HandMotion& getMotion() const {
+			return mExtractor.getMotion();
+		}
+
+		/**
+		  Returns how the graph extracts its nodes' features from a frame,
+		  for a HandTrackSet to follow each hand the same way.
+		*/
+		const FeatureExtractor& getExtractor() const {
+			return mExtractor;
+		}
+
+		/**
+		  Returns the frame the graph was last advanced on.
+		*/
+		const FeatureFrame& getFeatures() const {
+			return mFeatures;
+		}
+
+		/**
+		  Smooth the hand's velocity with filter from now on (see
+		  FeatureExtractor::setFilter()).
+		*/
+		void setFilter(const VelocityFilter& filter) {
+			mExtractor.setFilter(filter);
+		}
+
+		bool hasHand() const {
+			return mExtractor.getMotion().hasHand();
+		}
+
+		const Vector3& getVelocity() const {
+			return mExtractor.getMotion().getVelocity();
+		}
+
+		float getXYSpeed() const {
+			return mExtractor.getMotion().getXYSpeed();
+		}
+
+	private:
+		/**
+		  Add node's type to the graph, and declare the features it reads.
+
+		  Returns true if the type was added; false otherwise
+		*/
+		template <class Node>
+		bool addType(Node *node) {
+			mExtractor.require(node->getFeatures());
+			return mGraph.createNodeType(boost::shared_ptr<GestureNode>(node))
+				!= GestureStateGraph::INVALID_TYPE;
+		}
+
+		GestureStateGraph mGraph;
+		FeatureExtractor mExtractor;
+		FeatureFrame mFeatures;
+
+		// Not copyable, like the other demo graphs
+		SwipeGraph(const SwipeGraph&);
+		SwipeGraph& operator=(const SwipeGraph&);
+};
+
+#endif
@@ -0,0 +1,173 @@
+/*
+	Philip Romano
+	10/16/2026
+	synth.cpp
+
+	Write a frame log (see framelog.h) of synthetic hand motion (see
+	HandSynthesizer), for replay.cpp and load tests. The script is given as
+	a list of motions, each with an optional duration in milliseconds and
+	peak speed in millimeters per second:
+
+	  synth.x swipes.handlog idle:500 left:400:900 idle:500 backtrack-up
+
+	or as a number of random gestures with --random.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+#include "handsynthesizer.h"
+#include "handframe.h"
+#include "framelog.h"
+#include "gestureprofile.h"
+
+static void usage(const char *program) {
+	std::cerr << "Usage: " << program << " [frame log] [options]"
+		<< " [motion[:ms[:mm/s]]...]" << std::endl
+		<< "Options:" << std::endl
+		<< "  --rate [frames/sec]    default 100" << std::endl
+		<< "  --noise [mm/s]         velocity noise, default 0" << std::endl
+		<< "  --dropout [0-1]        chance of losing a frame's hands"
+		<< std::endl
+		<< "  --hands [1-4]          default 1" << std::endl
+		<< "  --fingers [0-5]        default 4" << std::endl
+		<< "  --seed [n]             default 1" << std::endl
+		<< "  --random [n]           n random gestures (100 if no motions"
+		<< " are given)" << std::endl
+		<< "  --repeat [n]           play the script n times" << std::endl
+		<< "Motions:";
+	for (int m = 0; m < HandSynthesizer::MOTIONS; ++m) {
+		std::cerr << " " << HandSynthesizer::getMotionName(
+				(HandSynthesizer::Motion)m);
+	}
+	std::cerr << std::endl;
+}
+
+/**
+  Parse motion[:ms[:mm/s]] into step.
+
+  Returns true if spec is a valid step; false otherwise
+*/
+static bool parseStep(const std::string& spec, HandSynthesizer::Step& step) {
+	std::string::size_type colon = spec.find(':');
+	if (!HandSynthesizer::parseMotion(spec.substr(0, colon), step.motion))
+		return false;
+
+	step.duration = 400000;
+	step.speed = 800.0f;
+	if (colon != std::string::npos) {
+		const char *rest = spec.c_str() + colon + 1;
+		char *end;
+		step.duration = (int64_t)(std::strtod(rest, &end) * 1000.0);
+		if (end == rest || step.duration <= 0)
+			return false;
+		if (*end == ':') {
+			rest = end + 1;
+			step.speed = (float)std::strtod(rest, &end);
+			if (end == rest)
+				return false;
+		}
+		if (*end != '\0')
+			return false;
+	}
+	return true;
+}
+
+int main(int argc, char **argv) {
+	if (argc < 2) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	std::string filename = argv[1];
+	double rate = 100.0;
+	float noise = 0.0f;
+	double dropout = 0.0;
+	int hands = 1, fingers = 4, random = 0, repeat = 1;
+	uint64_t seed = 1;
+	std::vector<HandSynthesizer::Step> steps;
+
+	for (int i = 2; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg.compare(0, 2, "--") == 0) {
+			if (i + 1 >= argc) {
+				usage(argv[0]);
+				return 1;
+			}
+			const char *value = argv[++i];
+			if (arg == "--rate")
+				rate = std::atof(value);
+			else if (arg == "--noise")
+				noise = (float)std::atof(value);
+			else if (arg == "--dropout")
+				dropout = std::atof(value);
+			else if (arg == "--hands")
+				hands = std::atoi(value);
+			else if (arg == "--fingers")
+				fingers = std::atoi(value);
+			else if (arg == "--seed")
+				seed = std::strtoull(value, NULL, 10);
+			else if (arg == "--random")
+				random = std::atoi(value);
+			else if (arg == "--repeat")
+				repeat = std::atoi(value);
+			else {
+				usage(argv[0]);
+				return 1;
+			}
+		} else {
+			HandSynthesizer::Step step;
+			if (!parseStep(arg, step)) {
+				std::cerr << "Bad motion " << arg << std::endl;
+				return 1;
+			}
+			steps.push_back(step);
+		}
+	}
+	if (steps.empty() && random == 0)
+		random = 100;
+
+	HandSynthesizer synth(rate, seed);
+	synth.setNoise(noise);
+	synth.setDropout(dropout);
+	synth.setHands(hands);
+	synth.setFingers(fingers);
+	for (int r = 0; r < repeat; ++r) {
+		for (int i = 0; i < (int)steps.size(); ++i)
+			synth.addStep(steps[i].motion, steps[i].duration, steps[i].speed);
+		synth.addRandomSteps(random);
+	}
+
+	FrameLogWriter writer(1 << 14);
+	if (!writer.open(filename)) {
+		std::cerr << "Could not create " << filename << std::endl;
+		return 1;
+	}
+
+	int64_t start = GestureProfile::now();
+	HandFrame *frame;
+	for (;;) {
+		// Wait for the writer rather than drop frames
+		while (!(frame = writer.beginAppend()))
+			;
+		if (!synth.next(*frame))
+			break;
+		writer.commitAppend();
+	}
+	bool written = writer.close();
+	double seconds = (GestureProfile::now() - start) / 1e9;
+	if (!written) {
+		std::cerr << "Could not write to " << filename << "; "
+			<< writer.getLost() << " frames lost" << std::endl;
+		return 1;
+	}
+
+	std::cerr << writer.getWritten() << " frames (" << synth.getDuration()
+		/ 1000000.0 << " s of motion) written in " << seconds * 1000.0
+		<< " ms" << std::endl;
+	return 0;
+}
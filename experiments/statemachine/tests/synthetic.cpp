@@ -0,0 +1,191 @@
+/*
+	Philip Romano
+	10/16/2026
+	synthetic.cpp
+
+	Test for HandSynthesizer
+	Plays a script of every gesture through the graph of train.cpp and
+	checks that each one is recognized, then checks that the synthesizer is
+	reproducible and that its dropouts and extra hands show up in the
+	frames.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include <boost/bind/bind.hpp>
+
+#include "handsynthesizer.h"
+#include "handframe.h"
+#include "gesturestategraph.h"
+
+#include "traingraph.h"
+
+class Counter {
+	public:
+		void count(const std::string& nodeid) {
+			for (int i = 0; i < (int)mNodes.size(); ++i) {
+				if (mNodes[i] == nodeid) {
+					++mCounts[i];
+					return;
+				}
+			}
+			mNodes.push_back(nodeid);
+			mCounts.push_back(1);
+		}
+
+		int get(const std::string& nodeid) const {
+			for (int i = 0; i < (int)mNodes.size(); ++i) {
+				if (mNodes[i] == nodeid)
+					return mCounts[i];
+			}
+			return 0;
+		}
+
+	private:
+		std::vector<std::string> mNodes;
+		std::vector<int> mCounts;
+};
+
+static bool recognize() {
+	static const char *nodes[] = {
+		"swL", "swR", "swU", "swD", "push", "pull",
+		"swLBacktrack", "swRBacktrack", "swUBacktrack", "swDBacktrack"
+	};
+	static const int NODES = sizeof(nodes) / sizeof(nodes[0]);
+
+	TrainGraph gestures;
+	Counter counter;
+	for (int i = 0; i < NODES; ++i) {
+		gestures.getGraph().setEnterAction(nodes[i],
+				boost::bind(&Counter::count, &counter,
+					std::string(nodes[i])));
+	}
+	gestures.getGraph().compile();
+
+	// Each swipe, then each backtrack, with the hand resting in between;
+	// the backtracks also pass through their swipe nodes
+	HandSynthesizer synth;
+	synth.setNoise(20.0f);
+	synth.addStep(HandSynthesizer::IDLE, 500000);
+	for (int m = HandSynthesizer::SWIPE_LEFT; m < HandSynthesizer::MOTIONS;
+			++m) {
+		bool backtrack = (m >= HandSynthesizer::BACKTRACK_LEFT);
+		synth.addStep((HandSynthesizer::Motion)m,
+				backtrack ? 700000 : 400000);
+		synth.addStep(HandSynthesizer::IDLE, 500000);
+	}
+
+	HandFrame frame;
+	while (synth.next(frame))
+		gestures.update(frame);
+
+	bool success = true;
+	for (int i = 0; i < NODES; ++i) {
+		int expected = (i < 4) ? 2 : 1;
+		int count = counter.get(nodes[i]);
+		if (count != expected) {
+			std::cout << nodes[i] << " entered " << count
+				<< " times, expected " << expected << std::endl;
+			success = false;
+		}
+	}
+	return success;
+}
+
+static bool reproducible() {
+	HandSynthesizer a(120.0, 7), b(120.0, 7), c(120.0, 8);
+	HandSynthesizer *synths[] = { &a, &b, &c };
+	for (int i = 0; i < 3; ++i) {
+		synths[i]->setNoise(30.0f);
+		synths[i]->setDropout(0.1);
+		synths[i]->setHands(2);
+		synths[i]->addRandomSteps(20);
+	}
+
+	HandFrame fa, fb, fc;
+	std::memset(&fa, 0, sizeof(fa));
+	std::memset(&fb, 0, sizeof(fb));
+	std::memset(&fc, 0, sizeof(fc));
+
+	bool same = true, different = false;
+	int64_t frames = 0;
+	while (a.next(fa)) {
+		same &= b.next(fb)
+			&& std::memcmp(&fa, &fb, sizeof(HandFrame)) == 0;
+		different |= !c.next(fc)
+			|| std::memcmp(&fa, &fc, sizeof(HandFrame)) != 0;
+		++frames;
+	}
+	same &= !b.next(fb) && frames == a.getFrameCount();
+
+	// Rewinding replays the same frames
+	a.rewind();
+	b.rewind();
+	for (int i = 0; i < 1000 && a.next(fa); ++i) {
+		same &= b.next(fb)
+			&& std::memcmp(&fa, &fb, sizeof(HandFrame)) == 0;
+	}
+
+	if (!same)
+		std::cout << "Equal seeds gave different frames" << std::endl;
+	if (!different)
+		std::cout << "Different seeds gave the same frames" << std::endl;
+	return same && different;
+}
+
+static bool hands() {
+	HandSynthesizer synth;
+	synth.setHands(3);
+	synth.setDropout(0.25);
+	synth.addStep(HandSynthesizer::IDLE, 10000000);
+
+	// Once every hand has joined in, a quarter of the frames should lose
+	// all three
+	HandFrame frame;
+	int frames = 0, none = 0, three = 0;
+	while (synth.next(frame)) {
+		if (frame.timestamp < 300000 || frame.timestamp >= 10000000)
+			continue;
+		++frames;
+		if (frame.handCount == 0)
+			++none;
+		else if (frame.handCount == 3
+				&& frame.hands[0].id != frame.hands[1].id
+				&& frame.hands[1].id != frame.hands[2].id)
+			++three;
+	}
+
+	double dropped = (double)none / frames;
+	bool success = (none + three == frames) && dropped > 0.2
+		&& dropped < 0.3;
+	if (!success) {
+		std::cout << frames << " frames: " << none << " with no hands, "
+			<< three << " with three" << std::endl;
+	}
+	return success;
+}
+
+int main(int argc, char **argv) {
+	bool success = true;
+
+	bool result = recognize();
+	std::cout << "Scripted gestures: " << (result ? "ok" : "FAILED")
+		<< std::endl;
+	success &= result;
+
+	result = reproducible();
+	std::cout << "Reproducibility: " << (result ? "ok" : "FAILED")
+		<< std::endl;
+	success &= result;
+
+	result = hands();
+	std::cout << "Hands and dropouts: " << (result ? "ok" : "FAILED")
+		<< std::endl;
+	success &= result;
+
+	std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+	return success ? 0 : 1;
+}
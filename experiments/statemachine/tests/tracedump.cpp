@@ -0,0 +1,36 @@
+/*
+	Philip Romano
+	10/16/2026
+	Decode a binary transition trace (see GestureTrace) to text
+*/
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gesturetrace.h"
+
+int main(int argc, char **argv) {
+	if (argc < 2) {
+		std::cerr << "Usage: " << argv[0] << " [trace file]" << std::endl;
+		return 1;
+	}
+
+	std::ifstream in(argv[1], std::ios::binary);
+	if (!in) {
+		std::cerr << "Could not open " << argv[1] << std::endl;
+		return 1;
+	}
+
+	std::vector<std::string> nodeIds;
+	std::vector<TraceRecord> records;
+	if (!GestureTrace::read(in, nodeIds, records)) {
+		std::cerr << argv[1] << " is not a valid trace file" << std::endl;
+		return 1;
+	}
+
+	std::cout << records.size() << " transitions" << std::endl;
+	GestureTrace::print(std::cout, nodeIds, records);
+	return 0;
+}
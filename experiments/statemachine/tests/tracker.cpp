@@ -0,0 +1,142 @@
+/*
+	Philip Romano
+	10/16/2026
+	tracker.cpp
+
+	A stand-in for the tracking device: publishes frames into a shared
+	frame ring (see framering.h) at the device's rate, for ringclient.x or
+	any other gesture process to read. The frames come from a recorded
+	frame log, or are synthesized (see HandSynthesizer) if none is given:
+
+	  tracker.x hands recording.handlog --loop
+	  tracker.x hands --stall 200
+
+	--stall pauses the tracker for the given number of milliseconds once a
+	second, to see that a stalled tracker does not hold up its readers.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+#include "framering.h"
+#include "framelog.h"
+#include "handsynthesizer.h"
+#include "handframe.h"
+
+static void usage(const char *program) {
+	std::cerr << "Usage: " << program << " [ring name] [frame log]"
+		<< " [options]" << std::endl
+		<< "Options:" << std::endl
+		<< "  --rate [frames/sec]    default 100" << std::endl
+		<< "  --loop                 replay the log until killed" << std::endl
+		<< "  --random [n]           n synthesized gestures if no log is"
+		<< " given, default 100" << std::endl
+		<< "  --stall [ms]           stop for ms once a second" << std::endl
+		<< "  --capacity [frames]    size of the ring, default 256"
+		<< std::endl;
+}
+
+int main(int argc, char **argv) {
+	if (argc < 2) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	std::string name = argv[1], filename;
+	double rate = 100.0;
+	bool loop = false;
+	int random = 100, stall = 0, capacity = 256;
+	for (int i = 2; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--loop") {
+			loop = true;
+		} else if (arg.compare(0, 2, "--") == 0) {
+			if (i + 1 >= argc) {
+				usage(argv[0]);
+				return 1;
+			}
+			const char *value = argv[++i];
+			if (arg == "--rate")
+				rate = std::atof(value);
+			else if (arg == "--random")
+				random = std::atoi(value);
+			else if (arg == "--stall")
+				stall = std::atoi(value);
+			else if (arg == "--capacity")
+				capacity = std::atoi(value);
+			else {
+				usage(argv[0]);
+				return 1;
+			}
+		} else {
+			filename = arg;
+		}
+	}
+	if (rate <= 0.0)
+		rate = 100.0;
+
+	FrameLogReader log;
+	HandSynthesizer synth(rate);
+	if (!filename.empty()) {
+		if (!log.open(filename)) {
+			std::cerr << filename << " is not a valid frame log"
+				<< std::endl;
+			return 1;
+		}
+	} else {
+		synth.setNoise(20.0f);
+		synth.addRandomSteps(random);
+	}
+
+	FrameRingWriter ring;
+	if (!ring.create(name, capacity)) {
+		std::cerr << "Could not create ring " << name << std::endl;
+		return 1;
+	}
+	std::cerr << "Publishing to " << name << " at " << rate
+		<< " frames/sec" << std::endl;
+
+	typedef std::chrono::steady_clock Clock;
+	Clock::time_point start = Clock::now();
+	int64_t period = (int64_t)(1000000.0 / rate);
+	int64_t frames = 0, position = 0;
+	int64_t nextStall = 1000000;
+
+	for (;;) {
+		int64_t due = frames * period;
+		if (stall > 0 && due >= nextStall) {
+			// Like a device, carry on afterwards rather than catch up
+			std::this_thread::sleep_for(std::chrono::milliseconds(stall));
+			start += std::chrono::milliseconds(stall);
+			nextStall += 1000000;
+		}
+		std::this_thread::sleep_until(start + std::chrono::microseconds(due));
+
+		HandFrame *frame = ring.beginAppend();
+		if (!filename.empty()) {
+			if (position == log.size()) {
+				if (!loop || log.size() == 0)
+					break;
+				position = 0;
+			}
+			*frame = log[position++];
+		} else if (!synth.next(*frame)) {
+			break;
+		}
+
+		// Frame IDs keep increasing when a log loops
+		frame->id = frames;
+		ring.commitAppend();
+		++frames;
+	}
+
+	ring.close();
+	std::cerr << frames << " frames published" << std::endl;
+	return 0;
+}
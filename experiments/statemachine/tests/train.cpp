@@ -9,6 +9,7 @@
 */
 
 #include <iostream>
+#include <fstream>
 #include <string>
 #include <math.h>
 
@@ -21,10 +22,15 @@
 #include <GL/gl.h>
 #include <GL/glu.h>
 #include <boost/shared_ptr.hpp>
-#include <boost/lexical_cast.hpp>
+#include <boost/bind/bind.hpp>
 
 #include "gesturestategraph.h"
 #include "gesturenode.h"
+#include "leapframe.h"
+#include "frameresampler.h"
+#include "traingraph.h"
+#include "gesturetrace.h"
+#include "gesturelatency.h"
 
 #ifdef _WIN32
 #undef main // Windows doesn't like the SDL_main thing
@@ -55,410 +61,35 @@ class EngineException : public std::exception {
 
 class Engine : public Leap::Listener {
 	public:
-		class Node_Motion : public GestureNode {
-			private:
-				Engine *e;
-				double mThreshold;
-
-			public:
-				Node_Motion(Engine *creator, double threshold = 300.0) {
-					e = creator;
-					mThreshold = threshold;
-				}
-
-				virtual const std::string& getName() {
-					static std::string name("Motion");
-					return name;
-				}
-
-				/**
-				  Determines if there is one hand, and its speed is greater
-				  than a threshold value.
-
-				  Slots:
-					1 if one hand is present, and the magnitude of velocity is
-					    >= 200 mm/s
-					0 otherwise
-				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					if (e->mMainHand.isValid()
-							&& e->mHandVelocity.magnitude() >= mThreshold)
-						return 1;
-					else {
-						return 0;
-					}
-				}
-
-				virtual void onEnter(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					e->mSwipe = SWIPE_NONE;
-				}
-		};
-
-		class Node_CoarseDirection : public GestureNode {
-			private:
-				Engine *e;
-
-			public:
-				Node_CoarseDirection(Engine *creator) {
-					e = creator;
-				}
-
-				virtual const std::string& getName() {
-					static std::string name("CoarseDirection");
-					return name;
-				}
-
-				/**
-				  Determines the direction of motion; vertical, horizontal, or
-				  depth-wise. The regions are split by the planes y = x,
-				  y = -x, y = z, and y = -z.
-
-				  Slots:
-					0 if vertical motion   [ |vy| > |vx| && |vy| > |vz| ]
-					1 if horizontal motion [ |vx| > |vy| && |vx| > |vz| ]
-					2 if depthwise motion  [ otherwise ]
-					                       // [ |vz| > |vx| && |vz| > |vy| ]
-
-					3 if error! ...no hands :(
-				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					// TODO Try getting rid of this check... it shouldn't be
-					// necessary with the right flow of states
-					if (e->mMainHand.isValid()) {
-						if (abs(e->mHandVelocity.y) > abs(e->mHandVelocity.x)
-						 && abs(e->mHandVelocity.y) > abs(e->mHandVelocity.z))
-							return 0;
-						else if (
-							abs(e->mHandVelocity.x) > abs(e->mHandVelocity.y)
-						 && abs(e->mHandVelocity.x) > abs(e->mHandVelocity.z))
-							return 1;
-						else
-							return 2;
-					} else {
-						std::cout << "BAD!!" << std::endl;
-						return 3;
-					}
-				}
-		};
-
-		class Node_LeftRight : public GestureNode {
-			private:
-				Engine *e;
-				std::string mName;
-				double mThreshold;
-
-			public:
-				/**
-				  getName() returns "LeftRight" + integer truncation of
-				  threshold
-				*/
-				Node_LeftRight(Engine *creator, double threshold = 0.0f) {
-					e = creator;
-					mThreshold = threshold;
-					mName = "LeftRight";
-					mName.append(
-						boost::lexical_cast<std::string>((int)mThreshold));
-				}
-
-				virtual const std::string& getName() {
-					return mName;
-				}
-
-				/**
-				  Determines whether the motion is leftwards or rightwards.
-
-				  Slots:
-					0 if leftward motion  [ vx <= -threshold ]
-					1 if rightward motion [ vx >=  threshold ]
-					2 if within threshold [ -threshold < vx < threshold ]
-
-					2 if error! ...no hands :(
-				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					if (e->mMainHand.isValid()) {
-						if (e->mHandVelocity.x <= -mThreshold) {
-							if (nodeid.compare("swL") == 0) {
-
-							}
-							return 0;
-						} else if (e->mHandVelocity.x >= mThreshold) {
-							if (nodeid.compare("swR") == 0) {
-
-							}
-							return 1;
-						} else {
-							return 2;
-						}
-					} else {
-						std::cout << "BAD!!" << std::endl;
-						return 3;
-					}
-				}
-
-				virtual void onEnter(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					if (nodeid.compare("swL") == 0) {
-						e->mSwipe = SWIPE_LEFT;
-						e->mSelection++;
-						if (e->mSelection >= e->mNumSelections) {
-							e->mListPosition -= e->mNumSelections;
-							e->mSelection = 0;
-						}
-					} else if (nodeid.compare("swR") == 0) {
-						e->mSwipe = SWIPE_RIGHT;
-						e->mSelection--;
-						if (e->mSelection < 0) {
-							e->mListPosition += e->mNumSelections;
-							e->mSelection = e->mNumSelections - 1;
-						}
-					}
-				}
-		};
-
-		class Node_UpDown : public GestureNode {
-			private:
-				Engine *e;
-				std::string mName;
-				double mThreshold;
-
-			public:
-				/**
-				  getName() returns "UpDown" + integer truncation of
-				  threshold
-				*/
-				Node_UpDown(Engine *creator, double threshold = 0.0) {
-					e = creator;
-					mThreshold = threshold;
-					mName = "UpDown";
-					mName.append(
-						boost::lexical_cast<std::string>((int)mThreshold));
-				}
-
-				virtual const std::string& getName() {
-					return mName;
-				}
-
-				/**
-				  Determines whether the motion is upwards or downwards.
-
-				  Slots:
-					0 if upward motion    [ vy <= -threshold ]
-					1 if downward motion  [ vy >=  threshold ]
-					2 if within threshold [ -threshold < vy < threshold ]
-
-					3 if error! ...no hands :(
-				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					if (e->mMainHand.isValid()) {
-						if (e->mHandVelocity.y <= -mThreshold)
-							return 0;
-						else if (e->mHandVelocity.y >= mThreshold)
-							return 1;
-						else
-							return 2;
-					} else {
-						std::cout << "BAD!!" << std::endl;
-						return 3;
-					}
-				}
-
-				virtual void onEnter(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					if (nodeid.compare("swU") == 0) {
-						e->mSwipe = SWIPE_UP;
-					} else if (nodeid.compare("swD") == 0) {
-						e->mSwipe = SWIPE_DOWN;
-					}
-				}
-		};
-
-		class Node_ForeBack : public GestureNode {
-			private:
-				Engine *e;
-				std::string mName;
-				double mThreshold;
-
-			public:
-				/**
-				  getName() returns "ForeBack" + integer truncation of
-				  threshold
-				*/
-				Node_ForeBack(Engine *creator, double threshold = 0.0f) {
-					e = creator;
-					mThreshold = threshold;
-					mName = "ForeBack";
-					mName.append(
-						boost::lexical_cast<std::string>((int)mThreshold));
-				}
-
-				virtual const std::string& getName() {
-					return mName;
-				}
-
-				/**
-				  Determines whether the motion is forwards or backwards.
-
-				  Slots:
-					0 if foreward motion  [ vz < -threshold ]
-					1 if backward motion  [ vz >  threshold ]
-					2 if within threshold [ -threshold < vz < threshold ]
-
-					3 if error! ...no hands :(
-				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					if (e->mMainHand.isValid()) {
-						if (e->mHandVelocity.z < -mThreshold) {
-							
-							return 0;
-						} else if (e->mHandVelocity.z > mThreshold) {
-							
-							return 1;
-						} else
-							return 2;
-					} else {
-						std::cout << "BAD!!" << std::endl;
-						return 3;
-					}
-				}
-
-				virtual void onEnter(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					if (nodeid.compare("push") == 0) {
-						e->mSwipe = SWIPE_PUSH;
-					}
-					else if (nodeid.compare("pull") == 0) {
-						e->mSwipe = SWIPE_PULL;
-					}
-				}
-
-				virtual void onLeave(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					
-				}
-		};
-
-		class Node_LeftRightLimbo : public GestureNode {
-			private:
-				Engine *e;
-				uint64_t mTimeStart;
-				uint64_t mTimelimit;
-				double   mThreshold;
-
-			public:
-				/**
-				  timer : number of microseconds before timing out (slot 0)
-				  threshold : minimum threshold of hand speed to leave state
-				      Should be positive (it is absolute-valued anyway)
-				*/
-				Node_LeftRightLimbo(Engine *creator,
-						uint64_t timer = 100000,
-						double threshold = 50.0) {
-					e = creator;
-					mTimeStart = 0;
-					mThreshold = abs(threshold);
-					mTimelimit = timer;
-				}
-
-				virtual const std::string& getName() {
-					static std::string name("LRLimbo");
-					return name;
-				}
-
-				/**
-				  Waits in this state until either a timer runs out, or the
-				  speed in the x direction becomes greater than a threshold.
-
-				  Slots:
-				    3 if moving rightwards  [ vx >= threshold ]
-					2 if moving leftwards   [ vx <= -theshold ]
-					1 if negligible movemtn [ -threshold < vx < threshold ]
-					0 if the timer runs out, or no hand is present
-				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					if (e->mMainHand.isValid()
-							&& frame.timestamp() - mTimeStart < mTimelimit) {
-						if (e->mHandVelocity.x >= mThreshold)
-							return 3;
-						else if (e->mHandVelocity.x <= -mThreshold)
-							return 2;
-						else
-							return 1;
-					} else
-						return 0;
-				}
-
-				virtual void onEnter(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					mTimeStart = frame.timestamp();
-				}
-		};
-
-		class Node_UpDownLimbo : public GestureNode {
-			private:
-				Engine *e;
-				uint64_t mTimeStart;
-				uint64_t mTimelimit;
-				double   mThreshold;
-
-			public:
-				/**
-				  timer : number of microseconds before timing out (slot 0)
-				  threshold : minimum threshold of hand speed to leave state
-				      Should be positive (it is absolute-valued anyway)
-				*/
-				Node_UpDownLimbo(Engine *creator,
-						uint64_t timer = 100000,
-						double threshold = 50.0) {
-					e = creator;
-					mTimeStart = 0;
-					mThreshold = abs(threshold);
-					mTimelimit = timer;
-				}
-
-				virtual const std::string& getName() {
-					static std::string name("UDLimbo");
-					return name;
-				}
-
-				/**
-				  Waits in this state until either a timer runs out, or the
-				  speed in the y direction becomes greater than a threshold.
-
-				  Slots:
-				    3 if moving upwards     [ vy >= threshold ]
-					2 if moving downwards   [ vy <= -theshold ]
-					1 if negligible movemnt [ -threshold < vy < threshold ]
-					0 if the timer runs out, or no hand is present
-				*/
-				virtual int evaluate(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					if (e->mMainHand.isValid()
-							&& frame.timestamp() - mTimeStart < mTimelimit) {
-						if (e->mHandVelocity.y >= mThreshold)
-							return 3;
-						else if (e->mHandVelocity.y <= -mThreshold)
-							return 2;
-						else
-							return 1;
-					} else
-						return 0;
-				}
-
-				virtual void onEnter(const Leap::Frame& frame,
-						const std::string& nodeid) {
-					mTimeStart = frame.timestamp();
-				}
-		};
-
 		Engine() {
-			mMainHand = Leap::Hand::invalid();
+			GestureStateGraph& graph = mGestures.getGraph();
+
+			/* Actions */
+
+			graph.setEnterAction("swL",
+					boost::bind(&Engine::onSwipeLeft, this));
+			graph.setEnterAction("swR",
+					boost::bind(&Engine::onSwipeRight, this));
+			graph.setEnterAction("swU",
+					boost::bind(&Engine::onSwipeUp, this));
+			graph.setEnterAction("swD",
+					boost::bind(&Engine::onSwipeDown, this));
+			graph.setEnterAction("push",
+					boost::bind(&Engine::onPush, this));
+			graph.setEnterAction("pull",
+					boost::bind(&Engine::onPull, this));
+
+			// Validate the graph before any frames arrive
+			graph.compile();
+
+			// Keep the most recent transitions; written out on exit
+			graph.setTrace(boost::shared_ptr<GestureTrace>(
+					new GestureTrace(4096)));
+
+			// Follow each gesture from the frame to the screen; reported
+			// on exit
+			mLatency.reset(new GestureLatency());
+			graph.setLatency(mLatency);
 		}
 
 		~Engine()
@@ -469,49 +100,16 @@ class Engine : public Leap::Listener {
 		}
 
 		virtual void onFrame(const Leap::Controller &c) {
-			Leap::Frame frame = c.frame(0);
-			bool swiping = false;
-			if (frame.hands().count() == 1) {
-				// Average of fingers + palm
-				mMainHand = (*frame.hands().begin());
-				if (mMainHand.fingers().count() >= 3) {
-					swiping = true;
-					Leap::FingerList fingers = mMainHand.fingers();
-					mCurrentVelocity = Leap::Vector(0.0f, 0.0f, 0.0f);
-					if (fingers.count() > 0) {
-						for (Leap::FingerList::const_iterator it
-								= fingers.begin();
-								it != fingers.end(); ++it) {
-							mCurrentVelocity += (*it).tipVelocity();
-						}
-						mCurrentVelocity /= (float)fingers.count();
-					}
-					mCurrentVelocity += mMainHand.palmVelocity();
-					if (fingers.count() > 0)
-						mCurrentVelocity /= 2.0;
-					updateHandVelocity();
-
-					Leap::Vector xyvel = mHandVelocity;
-					xyvel.z = 0.0f;
-					mXYHandSpeed = xyvel.magnitude();
-				}
-			}
-			
-			if (!swiping) {
-				initializeHandVelocity();
-				mMainHand = Leap::Hand::invalid();
-				mHandVelocity = Leap::Vector::zero();
-				mXYHandSpeed = 0.0f;
-			}
-
-			mGraph.updateWithPrint(frame);
+			toHandFrame(c.frame(0), mFrame);
+			mLatency->arrive(mFrame);
+			mResampler.push(mFrame);
+			while (mResampler.next(mResampled))
+				mGestures.update(mResampled);
 		}
 
 		void run() {
 			mRunning = true;
 			
-			initializeStates();
-			initializeHandVelocity();
 			initializeGraphics();
 			initializeApplication();
 
@@ -521,36 +119,25 @@ class Engine : public Leap::Listener {
 		}
 
 	private:
-		GestureStateGraph mGraph;
+		TrainGraph mGestures;
+
+		// The latest Leap frame
+		HandFrame mFrame;
+
+		// Graph input: the Leap frames resampled to a steady 100 Hz, so
+		// that the graph's thresholds and smoothing do not depend on the
+		// rate the device manages
+		FrameResampler mResampler;
+		HandFrame mResampled;
+
+		boost::shared_ptr<GestureLatency> mLatency;
 
-		Leap::Hand   mMainHand;
-		Leap::Vector mHandVelocity;
-		double       mXYHandSpeed;
 		int          mSelection,
 		             mNumSelections;
 		double       mListPosition,
 		             mHorizontalProgress,
 		             mVerticalProgress,
-					 mDepthProgress,
-					 mHorizontalThreshold,
-					 mVerticalThreshold,
-					 mMotionThreshold;
-
-		enum Swipe {
-			SWIPE_NONE = 0,
-			SWIPE_LEFT,
-			SWIPE_RIGHT,
-			SWIPE_UP,
-			SWIPE_DOWN,
-			SWIPE_PULL,
-			SWIPE_PUSH,
-		};
-		Swipe mSwipe;
-
-		Leap::Vector mCurrentVelocity;
-		int mNumSmoothing, mAverageVelocityCurrentIndex;
-		std::vector<Leap::Vector> mAverageVelocityBuffer;
-		Leap::Vector mAverageVelocity;
+					 mDepthProgress;
 
 		SDL_Window    *mWindow;
 		SDL_GLContext mGLContext;
@@ -559,147 +146,38 @@ class Engine : public Leap::Listener {
 
 		bool mRunning;
 
-		void initializeStates() {
-			mHorizontalThreshold = 200.0;
-			mVerticalThreshold = 200.0;
-			mMotionThreshold = 100.0;
-
-			mSwipe = SWIPE_NONE;
-
-			bool success = true;
-
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-				new Node_Motion(this, mMotionThreshold)));
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-				new Node_CoarseDirection(this)));
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-				new Node_LeftRight(this, mHorizontalThreshold)));
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-				new Node_LeftRight(this, 0.0)));
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-				new Node_UpDown(this, mVerticalThreshold)));
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-				new Node_UpDown(this, 0.0)));
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-				new Node_ForeBack(this, 5.0)));
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-				new Node_ForeBack(this, 10.0)));
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-				new Node_LeftRightLimbo(this, 100000, 100.0)));
-			success &= mGraph.createNodeType(boost::shared_ptr<GestureNode>(
-				new Node_UpDownLimbo(this, 100000, 100.0)));
-
-			if (!success)
-				throw EngineException("Node type creation failed");
-
-			/* Nodes */
-
-			mGraph.addNode("Motion", "noMotion");
-			mGraph.addNode("CoarseDirection", "coarse");
-			mGraph.addNode("LeftRight200", "stHorizontal");
-			mGraph.addNode("UpDown200", "stVertical");
-			mGraph.addNode("ForeBack5", "stDepth");
-
-			mGraph.addNode("LeftRight0", "swL");
-			mGraph.addNode("LeftRight0", "swR");
-			mGraph.addNode("UpDown0", "swU");
-			mGraph.addNode("UpDown0", "swD");
-			mGraph.addNode("ForeBack10", "pull");
-			mGraph.addNode("ForeBack10", "push");
-
-			mGraph.addNode("LRLimbo", "swLToBacktrack");
-			mGraph.addNode("LeftRight0", "swLBacktrack");
-			mGraph.addNode("LRLimbo", "swLFromBacktrack");
-			mGraph.addNode("LRLimbo", "swRToBacktrack");
-			mGraph.addNode("LeftRight0", "swRBacktrack");
-			mGraph.addNode("LRLimbo", "swRFromBacktrack");
-
-			mGraph.addNode("UDLimbo", "swUToBacktrack");
-			mGraph.addNode("UpDown0", "swUBacktrack");
-			mGraph.addNode("UDLimbo", "swUFromBacktrack");
-			mGraph.addNode("UDLimbo", "swDToBacktrack");
-			mGraph.addNode("UpDown0", "swDBacktrack");
-			mGraph.addNode("UDLimbo", "swDFromBacktrack");
-
-			mGraph.setStart("noMotion");
-
-			/* Connections */
-
-			mGraph.addConnection("noMotion", 1, "coarse");
-			mGraph.addConnection("coarse", 0, "stVertical");
-			mGraph.addConnection("coarse", 1, "stHorizontal");
-			mGraph.addConnection("coarse", 2, "stDepth");
-
-			mGraph.addConnection("stHorizontal", 0, "swL");
-			mGraph.addConnection("stHorizontal", 1, "swR");
-			mGraph.addConnection("stVertical", 0, "swD");
-			mGraph.addConnection("stVertical", 1, "swU");
-			mGraph.addConnection("stDepth", 0, "push");
-			mGraph.addConnection("stDepth", 1, "pull");
-
-			// Swipe LEFT sub-cycle
-			mGraph.addConnection("swL", 0, "swL");
-			mGraph.addConnection("swL", 1, "swLToBacktrack");
-			mGraph.addConnection("swL", 2, "swLToBacktrack");
-			mGraph.addConnection("swLToBacktrack", 1, "swLToBacktrack");
-			mGraph.addConnection("swLToBacktrack", 2, "swLToBacktrack");
-			mGraph.addConnection("swLToBacktrack", 3, "swLBacktrack");
-			mGraph.addConnection("swLBacktrack", 0, "swLFromBacktrack");
-			mGraph.addConnection("swLBacktrack", 1, "swLBacktrack");
-			mGraph.addConnection("swLBacktrack", 2, "");
-			mGraph.addConnection("swLFromBacktrack", 1, "swLFromBacktrack");
-			mGraph.addConnection("swLFromBacktrack", 2, "swL");
-			mGraph.addConnection("swLFromBacktrack", 3, "swLFromBacktrack");
-
-			// Swipe RIGHT sub-cycle
-			mGraph.addConnection("swR", 0, "swRToBacktrack");
-			mGraph.addConnection("swR", 1, "swR");
-			mGraph.addConnection("swR", 2, "swRToBacktrack");
-			mGraph.addConnection("swRToBacktrack", 1, "swRToBacktrack");
-			mGraph.addConnection("swRToBacktrack", 2, "swRBacktrack");
-			mGraph.addConnection("swRToBacktrack", 3, "swRToBacktrack");
-			mGraph.addConnection("swRBacktrack", 0, "swRBacktrack");
-			mGraph.addConnection("swRBacktrack", 1, "swRFromBacktrack");
-			mGraph.addConnection("swRBacktrack", 2, "");
-			mGraph.addConnection("swRFromBacktrack", 1, "swRFromBacktrack");
-			mGraph.addConnection("swRFromBacktrack", 2, "swRFromBacktrack");
-			mGraph.addConnection("swRFromBacktrack", 3, "swR");
-
-			// Swipe UP sub-cycle
-			mGraph.addConnection("swU", 0, "swUToBacktrack");
-			mGraph.addConnection("swU", 1, "swU");
-			mGraph.addConnection("swU", 2, "swUToBacktrack");
-			mGraph.addConnection("swUToBacktrack", 1, "swUToBacktrack");
-			mGraph.addConnection("swUToBacktrack", 2, "swUBacktrack");
-			mGraph.addConnection("swUToBacktrack", 3, "swUToBacktrack");
-			mGraph.addConnection("swUBacktrack", 0, "swUBacktrack");
-			mGraph.addConnection("swUBacktrack", 1, "swUFromBacktrack");
-			mGraph.addConnection("swUBacktrack", 2, "");
-			mGraph.addConnection("swUFromBacktrack", 1, "swUFromBacktrack");
-			mGraph.addConnection("swUFromBacktrack", 2, "swUFromBacktrack");
-			mGraph.addConnection("swUFromBacktrack", 3, "swU");
-
-			// Swipe DOWN sub-cycle
-			mGraph.addConnection("swD", 0, "swD");
-			mGraph.addConnection("swD", 1, "swDToBacktrack");
-			mGraph.addConnection("swD", 2, "swDToBacktrack");
-			mGraph.addConnection("swDToBacktrack", 1, "swDToBacktrack");
-			mGraph.addConnection("swDToBacktrack", 2, "swDToBacktrack");
-			mGraph.addConnection("swDToBacktrack", 3, "swDBacktrack");
-			mGraph.addConnection("swDBacktrack", 0, "swDFromBacktrack");
-			mGraph.addConnection("swDBacktrack", 1, "swDBacktrack");
-			mGraph.addConnection("swDBacktrack", 2, "");
-			mGraph.addConnection("swDFromBacktrack", 1, "swDFromBacktrack");
-			mGraph.addConnection("swDFromBacktrack", 2, "swD");
-			mGraph.addConnection("swDFromBacktrack", 3, "swDFromBacktrack");
-
-			// PUSH
-			mGraph.addConnection("push", 0, "push");
-			mGraph.addConnection("push", 2, "push");
-
-			// PULL
-			mGraph.addConnection("pull", 1, "pull");
-			mGraph.addConnection("pull", 2, "pull");
+		void onSwipeLeft() {
+			mGestures.mSwipe = TrainGraph::SWIPE_LEFT;
+			mSelection++;
+			if (mSelection >= mNumSelections) {
+				mListPosition -= mNumSelections;
+				mSelection = 0;
+			}
+		}
+
+		void onSwipeRight() {
+			mGestures.mSwipe = TrainGraph::SWIPE_RIGHT;
+			mSelection--;
+			if (mSelection < 0) {
+				mListPosition += mNumSelections;
+				mSelection = mNumSelections - 1;
+			}
+		}
+
+		void onSwipeUp() {
+			mGestures.mSwipe = TrainGraph::SWIPE_UP;
+		}
+
+		void onSwipeDown() {
+			mGestures.mSwipe = TrainGraph::SWIPE_DOWN;
+		}
+
+		void onPush() {
+			mGestures.mSwipe = TrainGraph::SWIPE_PUSH;
+		}
+
+		void onPull() {
+			mGestures.mSwipe = TrainGraph::SWIPE_PULL;
 		}
 
 		void initializeGraphics() {
@@ -750,16 +228,6 @@ class Engine : public Leap::Listener {
 			glPushMatrix();
 		}
 
-		void initializeHandVelocity() {
-			mNumSmoothing = 3;
-			mAverageVelocityCurrentIndex = 0;
-			mAverageVelocityBuffer.clear();
-			for (int i = 0; i < mNumSmoothing; ++i) {
-				mAverageVelocityBuffer.push_back(
-						Leap::Vector(0.0f, 0.0f, 0.0f));
-			}
-		}
-
 		void initializeApplication() {
 			mSelection = 0;
 			mNumSelections = 10;
@@ -774,25 +242,13 @@ class Engine : public Leap::Listener {
 			SDL_GL_DeleteContext(mGLContext);
 			SDL_DestroyWindow(mWindow);
 			SDL_Quit();
-		}
 
-		void updateHandVelocity() {
-			mAverageVelocityBuffer.at(mAverageVelocityCurrentIndex)
-				= mCurrentVelocity;
-			++mAverageVelocityCurrentIndex;
-			if (mAverageVelocityCurrentIndex >= mNumSmoothing)
-				mAverageVelocityCurrentIndex = 0;
-
-			std::vector<Leap::Vector>::iterator it
-				= mAverageVelocityBuffer.begin();
-			mAverageVelocity = (*it);
-			++it;
-			while (it != mAverageVelocityBuffer.end()) {
-				mAverageVelocity += (*it);
-				++it;
-			}
-			mAverageVelocity /= (float)mNumSmoothing;
-			mHandVelocity = mAverageVelocity;
+			std::ofstream trace("train.trace", std::ios::binary);
+			mGestures.getGraph().writeTrace(trace);
+
+			std::ofstream latency("train_latency.csv");
+			mLatency->writeCsv(latency, *mGestures.getGraph().compile());
+			mLatency->report(std::cout);
 		}
 
 		void runLoop() {
@@ -823,10 +279,14 @@ class Engine : public Leap::Listener {
 					}
 				}
 
+				// Whatever the gestures changed is picked up here...
+				mLatency->consume();
 				updatePosition();
 				renderFrame();
 
+				// ...and on screen here
 				SDL_GL_SwapWindow(mWindow);
+				mLatency->present();
 
 				while (SDL_GetTicks() - framestart < 1000 / 60)
 					SDL_Delay(1000 / 60 - (SDL_GetTicks() - framestart));
@@ -834,27 +294,27 @@ class Engine : public Leap::Listener {
 		}
 
 		void updatePosition() {
-			switch (mSwipe) {
-				case SWIPE_NONE:
-					mHorizontalProgress += ((mHandVelocity.x / mHorizontalThreshold) - mHorizontalProgress) / 3.0;
-					mVerticalProgress += ((mHandVelocity.y / mVerticalThreshold) - mVerticalProgress) / 3.0;
-					mDepthProgress += ((mHandVelocity.z / mMotionThreshold) - mDepthProgress) / 3.0;
+			switch (mGestures.mSwipe) {
+				case TrainGraph::SWIPE_NONE:
+					mHorizontalProgress += ((mGestures.getVelocity().x / mGestures.mHorizontalThreshold) - mHorizontalProgress) / 3.0;
+					mVerticalProgress += ((mGestures.getVelocity().y / mGestures.mVerticalThreshold) - mVerticalProgress) / 3.0;
+					mDepthProgress += ((mGestures.getVelocity().z / mGestures.mMotionThreshold) - mDepthProgress) / 3.0;
 					break;
 
-				case SWIPE_LEFT:
-				case SWIPE_RIGHT:
+				case TrainGraph::SWIPE_LEFT:
+				case TrainGraph::SWIPE_RIGHT:
 					mVerticalProgress = 0.0;
 					mDepthProgress = 0.0;
 					break;
 
-				case SWIPE_UP:
-				case SWIPE_DOWN:
+				case TrainGraph::SWIPE_UP:
+				case TrainGraph::SWIPE_DOWN:
 					mHorizontalProgress = 0.0;
 					mDepthProgress = 0.0;
 					break;
 
-				case SWIPE_PULL:
-				case SWIPE_PUSH:
+				case TrainGraph::SWIPE_PULL:
+				case TrainGraph::SWIPE_PUSH:
 					mHorizontalProgress = 0.0;
 					mVerticalProgress = 0.0;
 					break;
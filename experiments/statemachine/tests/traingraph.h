@@ -0,0 +1,646 @@
+/*
+	Philip Romano
+	10/16/2026
+	traingraph.h
+
+	The gesture graph of train.cpp, apart from its window and device, so
+	that replay.cpp can drive the same graph from recorded frames.
+*/
+
+#ifndef TRAINGRAPH_H
+#define TRAINGRAPH_H
+
+#include <iostream>
+#include <string>
+#include <math.h>
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "gesturestategraph.h"
+#include "featurenode.h"
+#include "featureframe.h"
+#include "handframe.h"
+#include "handmotion.h"
+#include "velocityfilter.h"
+
+/**
+	Swipes left, right, up and down, with backtracking, and pushes and
+	pulls. The nodes read the main hand's smoothed velocity, and clear
+	mSwipe whenever the hand comes to rest.
+*/
+class TrainGraph {
+	public:
+		enum Swipe {
+			SWIPE_NONE = 0,
+			SWIPE_LEFT,
+			SWIPE_RIGHT,
+			SWIPE_UP,
+			SWIPE_DOWN,
+			SWIPE_PULL,
+			SWIPE_PUSH,
+		};
+
+		class Node_Motion : public FeatureNode {
+			private:
+				TrainGraph *g;
+				double mThreshold;
+
+			public:
+				Node_Motion(TrainGraph *creator, double threshold = 300.0)
+						: FeatureNode(FeatureFrame::SPEED) {
+					g = creator;
+					mThreshold = threshold;
+				}
+
+				virtual const std::string& getName() {
+					static std::string name("Motion");
+					return name;
+				}
+
+				/**
+				  Determines if there is one hand, and its speed is greater
+				  than a threshold value.
+
+				  Slots:
+					1 if one hand is present, and the magnitude of velocity is
+					    >= 200 mm/s
+					0 otherwise
+				*/
+				virtual int evaluate(const FeatureFrame& frame,
+						const std::string& nodeid) {
+					if (frame.hasHand && frame.speed >= mThreshold)
+						return 1;
+					else {
+						return 0;
+					}
+				}
+
+				virtual void onEnter(const FeatureFrame& frame,
+						const std::string& nodeid) {
+					g->mSwipe = SWIPE_NONE;
+				}
+		};
+
+		class Node_CoarseDirection : public FeatureNode {
+			public:
+				Node_CoarseDirection()
+						: FeatureNode(FeatureFrame::VELOCITY) {
+				}
+
+				virtual const std::string& getName() {
+					static std::string name("CoarseDirection");
+					return name;
+				}
+
+				// Depends only on the hand velocity of the current frame
+				virtual bool isPure() {
+					return true;
+				}
+
+				/**
+				  Determines the direction of motion; vertical, horizontal, or
+				  depth-wise. The regions are split by the planes y = x,
+				  y = -x, y = z, and y = -z.
+
+				  Slots:
+					0 if vertical motion   [ |vy| > |vx| && |vy| > |vz| ]
+					1 if horizontal motion [ |vx| > |vy| && |vx| > |vz| ]
+					2 if depthwise motion  [ otherwise ]
+					                       // [ |vz| > |vx| && |vz| > |vy| ]
+
+					3 if error! ...no hands :(
+				*/
+				virtual int evaluate(const FeatureFrame& frame,
+						const std::string& nodeid) {
+					// TODO Try getting rid of this check... it shouldn't be
+					// necessary with the right flow of states
+					if (frame.hasHand) {
+						if (abs(frame.velocity.y) > abs(frame.velocity.x)
+						 && abs(frame.velocity.y) > abs(frame.velocity.z))
+							return 0;
+						else if (
+							abs(frame.velocity.x) > abs(frame.velocity.y)
+						 && abs(frame.velocity.x) > abs(frame.velocity.z))
+							return 1;
+						else
+							return 2;
+					} else {
+						std::cout << "BAD!!" << std::endl;
+						return 3;
+					}
+				}
+		};
+
+		class Node_LeftRight : public FeatureNode {
+			private:
+				std::string mName;
+				double mThreshold;
+
+			public:
+				/**
+				  getName() returns "LeftRight" + integer truncation of
+				  threshold
+				*/
+				Node_LeftRight(double threshold = 0.0f)
+						: FeatureNode(FeatureFrame::VELOCITY) {
+					mThreshold = threshold;
+					mName = "LeftRight";
+					mName.append(
+						boost::lexical_cast<std::string>((int)mThreshold));
+				}
+
+				virtual const std::string& getName() {
+					return mName;
+				}
+
+				// Depends only on the hand velocity of the current frame
+				virtual bool isPure() {
+					return true;
+				}
+
+				/**
+				  Determines whether the motion is leftwards or rightwards.
+
+				  Slots:
+					0 if leftward motion  [ vx <= -threshold ]
+					1 if rightward motion [ vx >=  threshold ]
+					2 if within threshold [ -threshold < vx < threshold ]
+
+					2 if error! ...no hands :(
+				*/
+				virtual int evaluate(const FeatureFrame& frame,
+						const std::string& nodeid) {
+					if (frame.hasHand) {
+						if (frame.velocity.x <= -mThreshold) {
+							return 0;
+						} else if (frame.velocity.x >= mThreshold) {
+							return 1;
+						} else {
+							return 2;
+						}
+					} else {
+						std::cout << "BAD!!" << std::endl;
+						return 3;
+					}
+				}
+		};
+
+		class Node_UpDown : public FeatureNode {
+			private:
+				std::string mName;
+				double mThreshold;
+
+			public:
+				/**
+				  getName() returns "UpDown" + integer truncation of
+				  threshold
+				*/
+				Node_UpDown(double threshold = 0.0)
+						: FeatureNode(FeatureFrame::VELOCITY) {
+					mThreshold = threshold;
+					mName = "UpDown";
+					mName.append(
+						boost::lexical_cast<std::string>((int)mThreshold));
+				}
+
+				virtual const std::string& getName() {
+					return mName;
+				}
+
+				// Depends only on the hand velocity of the current frame
+				virtual bool isPure() {
+					return true;
+				}
+
+				/**
+				  Determines whether the motion is upwards or downwards.
+
+				  Slots:
+					0 if upward motion    [ vy <= -threshold ]
+					1 if downward motion  [ vy >=  threshold ]
+					2 if within threshold [ -threshold < vy < threshold ]
+
+					3 if error! ...no hands :(
+				*/
+				virtual int evaluate(const FeatureFrame& frame,
+						const std::string& nodeid) {
+					if (frame.hasHand) {
+						if (frame.velocity.y <= -mThreshold)
+							return 0;
+						else if (frame.velocity.y >= mThreshold)
+							return 1;
+						else
+							return 2;
+					} else {
+						std::cout << "BAD!!" << std::endl;
+						return 3;
+					}
+				}
+		};
+
+		class Node_ForeBack : public FeatureNode {
+			private:
+				std::string mName;
+				double mThreshold;
+
+			public:
+				/**
+				  getName() returns "ForeBack" + integer truncation of
+				  threshold
+				*/
+				Node_ForeBack(double threshold = 0.0f)
+						: FeatureNode(FeatureFrame::VELOCITY) {
+					mThreshold = threshold;
+					mName = "ForeBack";
+					mName.append(
+						boost::lexical_cast<std::string>((int)mThreshold));
+				}
+
+				virtual const std::string& getName() {
+					return mName;
+				}
+
+				// Depends only on the hand velocity of the current frame
+				virtual bool isPure() {
+					return true;
+				}
+
+				/**
+				  Determines whether the motion is forwards or backwards.
+
+				  Slots:
+					0 if foreward motion  [ vz < -threshold ]
+					1 if backward motion  [ vz >  threshold ]
+					2 if within threshold [ -threshold < vz < threshold ]
+
+					3 if error! ...no hands :(
+				*/
+				virtual int evaluate(const FeatureFrame& frame,
+						const std::string& nodeid) {
+					if (frame.hasHand) {
+						if (frame.velocity.z < -mThreshold) {
+							
+							return 0;
+						} else if (frame.velocity.z > mThreshold) {
+							
+							return 1;
+						} else
+							return 2;
+					} else {
+						std::cout << "BAD!!" << std::endl;
+						return 3;
+					}
+				}
+
+				virtual void onLeave(const FeatureFrame& frame,
+						const std::string& nodeid) {
+					
+				}
+		};
+
+		/**
+		  Per-node state of the Limbo node types: the time at which the
+		  node was entered.
+		*/
+		struct LimboState {
+			uint64_t timeStart;
+		};
+
+		class Node_LeftRightLimbo : public StatefulFeatureNode<LimboState> {
+			private:
+				uint64_t mTimelimit;
+				double   mThreshold;
+
+			public:
+				/**
+				  timer : number of microseconds before timing out (slot 0)
+				  threshold : minimum threshold of hand speed to leave state
+				      Should be positive (it is absolute-valued anyway)
+				*/
+				Node_LeftRightLimbo(uint64_t timer = 100000,
+						double threshold = 50.0)
+						: StatefulFeatureNode<LimboState>(
+							FeatureFrame::VELOCITY) {
+					mThreshold = abs(threshold);
+					mTimelimit = timer;
+				}
+
+				virtual const std::string& getName() {
+					static std::string name("LRLimbo");
+					return name;
+				}
+
+				/**
+				  Waits in this state until either a timer runs out, or the
+				  speed in the x direction becomes greater than a threshold.
+
+				  Slots:
+				    3 if moving rightwards  [ vx >= threshold ]
+					2 if moving leftwards   [ vx <= -theshold ]
+					1 if negligible movemtn [ -threshold < vx < threshold ]
+					0 if the timer runs out, or no hand is present
+				*/
+				virtual int evaluate(const FeatureFrame& frame,
+						const std::string& nodeid, LimboState& state) {
+					if (frame.hasHand
+							&& frame.timestamp - state.timeStart < mTimelimit) {
+						if (frame.velocity.x >= mThreshold)
+							return 3;
+						else if (frame.velocity.x <= -mThreshold)
+							return 2;
+						else
+							return 1;
+					} else
+						return 0;
+				}
+
+				virtual void onEnter(const FeatureFrame& frame,
+						const std::string& nodeid, LimboState& state) {
+					state.timeStart = frame.timestamp;
+				}
+		};
+
+		class Node_UpDownLimbo : public StatefulFeatureNode<LimboState> {
+			private:
+				uint64_t mTimelimit;
+				double   mThreshold;
+
+			public:
+				/**
+				  timer : number of microseconds before timing out (slot 0)
+				  threshold : minimum threshold of hand speed to leave state
+				      Should be positive (it is absolute-valued anyway)
+				*/
+				Node_UpDownLimbo(uint64_t timer = 100000,
+						double threshold = 50.0)
+						: StatefulFeatureNode<LimboState>(
+							FeatureFrame::VELOCITY) {
+					mThreshold = abs(threshold);
+					mTimelimit = timer;
+				}
+
+				virtual const std::string& getName() {
+					static std::string name("UDLimbo");
+					return name;
+				}
+
+				/**
+				  Waits in this state until either a timer runs out, or the
+				  speed in the y direction becomes greater than a threshold.
+
+				  Slots:
+				    3 if moving upwards     [ vy >= threshold ]
+					2 if moving downwards   [ vy <= -theshold ]
+					1 if negligible movemnt [ -threshold < vy < threshold ]
+					0 if the timer runs out, or no hand is present
+				*/
+				virtual int evaluate(const FeatureFrame& frame,
+						const std::string& nodeid, LimboState& state) {
+					if (frame.hasHand
+							&& frame.timestamp - state.timeStart < mTimelimit) {
+						if (frame.velocity.y >= mThreshold)
+							return 3;
+						else if (frame.velocity.y <= -mThreshold)
+							return 2;
+						else
+							return 1;
+					} else
+						return 0;
+				}
+
+				virtual void onEnter(const FeatureFrame& frame,
+						const std::string& nodeid, LimboState& state) {
+					state.timeStart = frame.timestamp;
+				}
+		};
+
+		/**
+		  Build the graph. The owner sets any actions, then compiles it.
+		*/
+		TrainGraph()
+				: mHorizontalThreshold(200.0), mVerticalThreshold(200.0),
+				  mMotionThreshold(100.0), mSwipe(SWIPE_NONE),
+				  mExtractor(3, 3) {
+			mFeatures.clear();
+
+			bool success = true;
+
+			success &= addType(new Node_Motion(this, mMotionThreshold));
+			success &= addType(new Node_CoarseDirection());
+			success &= addType(new Node_LeftRight(mHorizontalThreshold));
+			success &= addType(new Node_LeftRight(0.0));
+			success &= addType(new Node_UpDown(mVerticalThreshold));
+			success &= addType(new Node_UpDown(0.0));
+			success &= addType(new Node_ForeBack(5.0));
+			success &= addType(new Node_ForeBack(10.0));
+			success &= addType(new Node_LeftRightLimbo(100000, 100.0));
+			success &= addType(new Node_UpDownLimbo(100000, 100.0));
+
+			if (!success)
+				throw GestureStateException("Node type creation failed");
+
+			/* Nodes */
+
+			mGraph.addNode("Motion", "noMotion");
+			mGraph.addNode("CoarseDirection", "coarse");
+			mGraph.addNode("LeftRight200", "stHorizontal");
+			mGraph.addNode("UpDown200", "stVertical");
+			mGraph.addNode("ForeBack5", "stDepth");
+
+			mGraph.addNode("LeftRight0", "swL");
+			mGraph.addNode("LeftRight0", "swR");
+			mGraph.addNode("UpDown0", "swU");
+			mGraph.addNode("UpDown0", "swD");
+			mGraph.addNode("ForeBack10", "pull");
+			mGraph.addNode("ForeBack10", "push");
+
+			mGraph.addNode("LRLimbo", "swLToBacktrack");
+			mGraph.addNode("LeftRight0", "swLBacktrack");
+			mGraph.addNode("LRLimbo", "swLFromBacktrack");
+			mGraph.addNode("LRLimbo", "swRToBacktrack");
+			mGraph.addNode("LeftRight0", "swRBacktrack");
+			mGraph.addNode("LRLimbo", "swRFromBacktrack");
+
+			mGraph.addNode("UDLimbo", "swUToBacktrack");
+			mGraph.addNode("UpDown0", "swUBacktrack");
+			mGraph.addNode("UDLimbo", "swUFromBacktrack");
+			mGraph.addNode("UDLimbo", "swDToBacktrack");
+			mGraph.addNode("UpDown0", "swDBacktrack");
+			mGraph.addNode("UDLimbo", "swDFromBacktrack");
+
+			mGraph.setStart("noMotion");
+
+			/* Connections */
+
+			mGraph.addConnection("noMotion", 1, "coarse");
+			mGraph.addConnection("coarse", 0, "stVertical");
+			mGraph.addConnection("coarse", 1, "stHorizontal");
+			mGraph.addConnection("coarse", 2, "stDepth");
+
+			mGraph.addConnection("stHorizontal", 0, "swL");
+			mGraph.addConnection("stHorizontal", 1, "swR");
+			mGraph.addConnection("stVertical", 0, "swD");
+			mGraph.addConnection("stVertical", 1, "swU");
+			mGraph.addConnection("stDepth", 0, "push");
+			mGraph.addConnection("stDepth", 1, "pull");
+
+			// Swipe LEFT sub-cycle
+			mGraph.addConnection("swL", 0, "swL");
+			mGraph.addConnection("swL", 1, "swLToBacktrack");
+			mGraph.addConnection("swL", 2, "swLToBacktrack");
+			mGraph.addConnection("swLToBacktrack", 1, "swLToBacktrack");
+			mGraph.addConnection("swLToBacktrack", 2, "swLToBacktrack");
+			mGraph.addConnection("swLToBacktrack", 3, "swLBacktrack");
+			mGraph.addConnection("swLBacktrack", 0, "swLFromBacktrack");
+			mGraph.addConnection("swLBacktrack", 1, "swLBacktrack");
+			mGraph.addConnection("swLBacktrack", 2, "");
+			mGraph.addConnection("swLFromBacktrack", 1, "swLFromBacktrack");
+			mGraph.addConnection("swLFromBacktrack", 2, "swL");
+			mGraph.addConnection("swLFromBacktrack", 3, "swLFromBacktrack");
+
+			// Swipe RIGHT sub-cycle
+			mGraph.addConnection("swR", 0, "swRToBacktrack");
+			mGraph.addConnection("swR", 1, "swR");
+			mGraph.addConnection("swR", 2, "swRToBacktrack");
+			mGraph.addConnection("swRToBacktrack", 1, "swRToBacktrack");
+			mGraph.addConnection("swRToBacktrack", 2, "swRBacktrack");
+			mGraph.addConnection("swRToBacktrack", 3, "swRToBacktrack");
+			mGraph.addConnection("swRBacktrack", 0, "swRBacktrack");
+			mGraph.addConnection("swRBacktrack", 1, "swRFromBacktrack");
+			mGraph.addConnection("swRBacktrack", 2, "");
+			mGraph.addConnection("swRFromBacktrack", 1, "swRFromBacktrack");
+			mGraph.addConnection("swRFromBacktrack", 2, "swRFromBacktrack");
+			mGraph.addConnection("swRFromBacktrack", 3, "swR");
+
+			// Swipe UP sub-cycle
+			mGraph.addConnection("swU", 0, "swUToBacktrack");
+			mGraph.addConnection("swU", 1, "swU");
+			mGraph.addConnection("swU", 2, "swUToBacktrack");
+			mGraph.addConnection("swUToBacktrack", 1, "swUToBacktrack");
+			mGraph.addConnection("swUToBacktrack", 2, "swUBacktrack");
+			mGraph.addConnection("swUToBacktrack", 3, "swUToBacktrack");
+			mGraph.addConnection("swUBacktrack", 0, "swUBacktrack");
+			mGraph.addConnection("swUBacktrack", 1, "swUFromBacktrack");
+			mGraph.addConnection("swUBacktrack", 2, "");
+			mGraph.addConnection("swUFromBacktrack", 1, "swUFromBacktrack");
+			mGraph.addConnection("swUFromBacktrack", 2, "swUFromBacktrack");
+			mGraph.addConnection("swUFromBacktrack", 3, "swU");
+
+			// Swipe DOWN sub-cycle
+			mGraph.addConnection("swD", 0, "swD");
+			mGraph.addConnection("swD", 1, "swDToBacktrack");
+			mGraph.addConnection("swD", 2, "swDToBacktrack");
+			mGraph.addConnection("swDToBacktrack", 1, "swDToBacktrack");
+			mGraph.addConnection("swDToBacktrack", 2, "swDToBacktrack");
+			mGraph.addConnection("swDToBacktrack", 3, "swDBacktrack");
+			mGraph.addConnection("swDBacktrack", 0, "swDFromBacktrack");
+			mGraph.addConnection("swDBacktrack", 1, "swDBacktrack");
+			mGraph.addConnection("swDBacktrack", 2, "");
+			mGraph.addConnection("swDFromBacktrack", 1, "swDFromBacktrack");
+			mGraph.addConnection("swDFromBacktrack", 2, "swD");
+			mGraph.addConnection("swDFromBacktrack", 3, "swDFromBacktrack");
+
+			// PUSH
+			mGraph.addConnection("push", 0, "push");
+			mGraph.addConnection("push", 2, "push");
+
+			// PULL
+			mGraph.addConnection("pull", 1, "pull");
+			mGraph.addConnection("pull", 2, "pull");
+		}
+
+		/**
+		  Extract the features the nodes read from frame, then advance the
+		  graph on them.
+		*/
+		void update(const HandFrame& frame) {
+			mExtractor.extract(frame, mFeatures);
+			mGraph.update(mFeatures);
+		}
+
+		/**
+		  As update(), with the raw velocity of the frame's hand already
+		  computed (see HandBlock).
+		*/
+		void update(const HandFrame& frame, const Vector3& rawVelocity) {
+			mExtractor.extract(frame, rawVelocity, mFeatures);
+			mGraph.update(mFeatures);
+		}
+
+		GestureStateGraph& getGraph() {
+			return mGraph;
+		}
+
+		const HandMotion& getMotion() const {
+			return mExtractor.getMotion();
+		}
+
+		/**
+		  Returns how the graph extracts its nodes' features from a frame,
+		  for a HandTrackSet to follow each hand the same way.
+		*/
+		const FeatureExtractor& getExtractor() const {
+			return mExtractor;
+		}
+
+		/**
+		  Returns the frame the graph was last advanced on.
+		*/
+		const FeatureFrame& getFeatures() const {
+			return mFeatures;
+		}
+
+		/**
+		  Smooth the hand's velocity with filter from now on (see
+		  FeatureExtractor::setFilter()).
+		*/
+		void setFilter(const VelocityFilter& filter) {
+			mExtractor.setFilter(filter);
+		}
+
+		bool hasHand() const {
+			return mExtractor.getMotion().hasHand();
+		}
+
+		const Vector3& getVelocity() const {
+			return mExtractor.getMotion().getVelocity();
+		}
+
+		float getXYSpeed() const {
+			return mExtractor.getMotion().getXYSpeed();
+		}
+
+		// Hand speeds, in millimeters per second, that start a swipe
+		double mHorizontalThreshold,
+		       mVerticalThreshold,
+		       mMotionThreshold;
+
+		// The last gesture; set back to SWIPE_NONE when the hand slows
+		// down, and otherwise set by the owner's actions
+		Swipe mSwipe;
+
+	private:
+		/**
+		  Add node's type to the graph, and declare the features it reads.
+
+		  Returns true if the type was added; false otherwise
+		*/
+		template <class Node>
+		bool addType(Node *node) {
+			mExtractor.require(node->getFeatures());
+			return mGraph.createNodeType(boost::shared_ptr<GestureNode>(node))
+				!= GestureStateGraph::INVALID_TYPE;
+		}
+
+		GestureStateGraph mGraph;
+		FeatureExtractor mExtractor;
+		FeatureFrame mFeatures;
+
+		// Not copyable; the nodes point back at the graph
+		TrainGraph(const TrainGraph&);
+		TrainGraph& operator=(const TrainGraph&);
+};
+
+#endif
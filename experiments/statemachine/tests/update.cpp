@@ -17,6 +17,7 @@
 
 #include "gesturestategraph.h"
 #include "gesturenode.h"
+#include "leapframe.h"
 
 #ifdef _WIN32
 #undef main // Windows doesn't like the SDL_main thing
@@ -36,10 +37,9 @@ class Node_OneHand : public GestureNode {
 		  1 if one hand is present
 		  0 otherwise
 		*/
-		virtual int evaluate(const Leap::Frame& frame,
-				const std::string& nodeid) {
-			Leap::HandList hands = frame.hands();
-			if (hands.count() == 1) {
+		virtual int evaluate(const HandFrame& frame,
+				const std::string& nodeid, void *state) {
+			if (frame.handCount == 1) {
 				return 1;
 			} else {
 				std::cout << "No hands" << std::endl;
@@ -62,12 +62,10 @@ class Node_Horizontal : public GestureNode {
 		  1 if abs(yvel) <= 1/2 abs(xvel) [horizontal palm motion]
 		  0 otherwise
 		*/
-		virtual int evaluate(const Leap::Frame& frame,
-				const std::string& nodeid) {
-			Leap::HandList hands = frame.hands();
-			if (hands.count() > 0) {
-				Leap::Hand h = (*hands.begin());
-				Leap::Vector vel = h.palmVelocity();
+		virtual int evaluate(const HandFrame& frame,
+				const std::string& nodeid, void *state) {
+			if (frame.handCount > 0) {
+				Vector3 vel = frame.hands[0].palmVelocity;
 				if (abs(vel.y) <= 0.5 * abs(vel.x)) {
 					std::cout << "HORZ : " << vel.magnitude() << std::endl;
 					return 1;
@@ -92,12 +90,10 @@ class Node_Vertical : public GestureNode {
 		  1 if abs(xvel) <= 1/2 abs(yvel) [vertical palm motion]
 		  0 otherwise
 		*/
-		virtual int evaluate(const Leap::Frame& frame,
-				const std::string& nodeid) {
-			Leap::HandList hands = frame.hands();
-			if (hands.count() > 0) {
-				Leap::Hand h = (*hands.begin());
-				Leap::Vector vel = h.palmVelocity();
+		virtual int evaluate(const HandFrame& frame,
+				const std::string& nodeid, void *state) {
+			if (frame.handCount > 0) {
+				Vector3 vel = frame.hands[0].palmVelocity;
 				if (abs(vel.x) < 0.5 * abs(vel.y)) {
 					std::cout << "VERT" << std::endl;
 					return 1;
@@ -122,12 +118,10 @@ class Node_HorizontalSwipe : public GestureNode {
 		  1 if abs(vel.x) > 50 [stay in state]
 		  0 otherwise          [leave state]
 		*/
-		virtual int evaluate(const Leap::Frame& frame,
-				const std::string& nodeid) {
-			Leap::HandList hands = frame.hands();
-			if (hands.count() > 0) {
-				Leap::Hand h = (*hands.begin());
-				Leap::Vector vel = h.palmVelocity();
+		virtual int evaluate(const HandFrame& frame,
+				const std::string& nodeid, void *state) {
+			if (frame.handCount > 0) {
+				Vector3 vel = frame.hands[0].palmVelocity;
 				if (abs(vel.x) < 0.5 * abs(vel.y)) {
 					std::cout << "VERT" << std::endl;
 					return 1;
@@ -152,6 +146,9 @@ class Engine : public Leap::Listener {
 			mGraph.addConnection("horizontal1", 0, "vertical1");
 			mGraph.addConnection("vertical1", 1, "vertical1");
 			mGraph.addConnection("vertical1", 0, "horizontal1");
+
+			// Validate the graph before any frames arrive
+			mGraph.compile();
 		}
 
 		~Engine()
@@ -163,7 +160,8 @@ class Engine : public Leap::Listener {
 
 		virtual void onFrame(const Leap::Controller &c) {
 			std::cout << "Frame" << std::endl;
-			mGraph.update(c.frame(0));
+			toHandFrame(c.frame(0), mFrame);
+			mGraph.update(mFrame);
 		}
 
 		void run() {
@@ -173,6 +171,9 @@ class Engine : public Leap::Listener {
 
 	private:
 		GestureStateGraph mGraph;
+
+		// Graph input, converted from the latest Leap frame
+		HandFrame mFrame;
 };
 
 int main(int argc, char **argv) {